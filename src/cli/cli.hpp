@@ -144,6 +144,8 @@ public:
     bool add_variables_from_dofiles(std::filesystem::path const& filepath, std::span<std::string const> arguments);
 
     void sigint_handler(int signum);
+    // may be called from any thread that the running command spawns, as the
+    // command stack does not change until the command returns
     bool stop_requested() const { return !_command_threads.empty() && _command_threads.top().get_stop_token().stop_requested(); }
 
     // printing functions
@@ -133,6 +133,16 @@ Command convert_from_zx_cmd(zx::ZXGraphMgr& zxgraph_mgr, QCirMgr& qcir_mgr, tens
             to_qcir.add_argument<bool>("-r", "--random")
                 .action(store_true)
                 .help("Shuffle the neighbors to the extraction frontier, which changes the gadget removal order.");
+
+            to_tensor.add_argument<std::string>("--order")
+                .default_value("topological")
+                .choices({"topological", "greedy", "min-fill"})
+                .help("the order to contract the tensors in: the topological order of the vertices, "
+                      "which the frontier mapper follows; greedily by the size of the intermediate tensors, or by a min-fill tree decomposition");
+
+            to_tensor.add_argument<double>("--max-memory")
+                .metavar("MiB")
+                .help("refuses to convert if the largest tensor is predicted to take more memory than this");
         },
         [&](ArgumentParser const& parser) {
             if (!dvlab::utils::mgr_has_data(zxgraph_mgr)) return CmdExecResult::error;
@@ -168,7 +178,12 @@ Command convert_from_zx_cmd(zx::ZXGraphMgr& zxgraph_mgr, QCirMgr& qcir_mgr, tens
             }
             if (to_type == "tensor") {
                 spdlog::info("Converting ZXGraph {} to Tensor {}...", zxgraph_mgr.focused_id(), tensor_mgr.get_next_id());
-                auto tensor = qsyn::to_tensor(*zxgraph_mgr.get());
+                auto config  = ZX2TSConfig{};
+                config.order = *tensor::str_to_contraction_order(parser.get<std::string>("--order"));
+                if (parser.parsed("--max-memory")) {
+                    config.max_memory_mib = parser.get<double>("--max-memory");
+                }
+                auto tensor = qsyn::to_tensor(*zxgraph_mgr.get(), config);
 
                 if (tensor.has_value()) {
                     tensor_mgr.add(tensor_mgr.get_next_id(), std::make_unique<qsyn::tensor::QTensor<double>>(std::move(tensor.value())));
@@ -7,8 +7,10 @@
 
 #include <spdlog/spdlog.h>
 
+#include <chrono>
 #include <cstddef>
 #include <string>
+#include <vector>
 
 #include "argparse/arg_parser.hpp"
 #include "argparse/arg_type.hpp"
@@ -17,8 +19,10 @@
 #include "cmd/qcir_mgr.hpp"
 #include "cmd/zxgraph_mgr.hpp"
 #include "extractor/extract.hpp"
+#include "extractor/portfolio.hpp"
 #include "qcir/qcir.hpp"
 #include "util/data_structure_manager_common_cmd.hpp"
+#include "util/scope_guard.hpp"
 #include "zx/zxgraph.hpp"
 
 using namespace dvlab::argparse;
@@ -30,17 +34,7 @@ using qsyn::zx::ZXGraphMgr;
 
 namespace qsyn::extractor {
 
-ExtractorConfig EXTRACTOR_CONFIG{
-    .sort_frontier        = false,
-    .sort_neighbors       = true,
-    .permute_qubits       = true,
-    .filter_duplicate_cxs = true,
-    .reduce_czs           = false,
-    .dynamic_order        = false,
-    .block_size           = 5,
-    .optimize_level       = 2,
-    .pred_coeff           = 0.7,
-};
+ExtractorConfig EXTRACTOR_CONFIG = default_extractor_config;
 
 dvlab::Command extraction_step_cmd(zx::ZXGraphMgr& zxgraph_mgr, QCirMgr& qcir_mgr) {
     return {"step",
@@ -111,6 +105,8 @@ dvlab::Command extraction_step_cmd(zx::ZXGraphMgr& zxgraph_mgr, QCirMgr& qcir_mg
                 zxgraph_mgr.checkout(zx_id);
                 qcir_mgr.checkout(qcir_id);
                 Extractor ext(zxgraph_mgr.get(), EXTRACTOR_CONFIG, qcir_mgr.get(), false /*, std::nullopt */);
+                // write the gates of this step into the QCir, whichever step it is
+                dvlab::utils::scope_exit const flush_gates{[&ext]() { ext.flush_gate_buffer(); }};
 
                 if (parser.parsed("--loop")) {
                     ext.extraction_loop(parser.get<size_t>("--loop"));
@@ -210,6 +206,10 @@ Command extractor_config_cmd() {
                     .help("synthesizes permutation circuits at the end of extraction");
                 parser.add_argument<size_t>("--block-size")
                     .help("the block size for block Gaussian elimination. Only used in optimization level 0");
+                parser.add_argument<bool>("--m4ri")
+                    .help("uses the Method of Four Russians for block Gaussian elimination. Faster on wide frontiers, but block sizes are capped at 8");
+                parser.add_argument<size_t>("--threads")
+                    .help("the number of threads that try block sizes concurrently in optimization levels 1 and 3. 0 means one per hardware core. The result does not depend on this number");
                 parser.add_argument<bool>("--filter-cx")
                     .help("filters duplicate CXs during extraction");
                 parser.add_argument<bool>("--reduce-cz")
@@ -243,6 +243,14 @@ Command extractor_config_cmd() {
                     }
                     print_current_config = false;
                 }
+                if (parser.parsed("--m4ri")) {
+                    EXTRACTOR_CONFIG.m4ri_elimination = parser.get<bool>("--m4ri");
+                    print_current_config              = false;
+                }
+                if (parser.parsed("--threads")) {
+                    EXTRACTOR_CONFIG.num_threads = parser.get<size_t>("--threads");
+                    print_current_config         = false;
+                }
                 if (parser.parsed("--filter-cx")) {
                     EXTRACTOR_CONFIG.filter_duplicate_cxs = parser.get<bool>("--filter-cx");
                     print_current_config                  = false;
@@ -277,6 +285,8 @@ Command extractor_config_cmd() {
                     fmt::println("Filter Duplicated CXs:        {}", EXTRACTOR_CONFIG.filter_duplicate_cxs);
                     fmt::println("Reduce CZs:                   {}", EXTRACTOR_CONFIG.reduce_czs);
                     fmt::println("Block Size:                   {}", EXTRACTOR_CONFIG.block_size);
+                    fmt::println("M4RI Elimination:             {}", EXTRACTOR_CONFIG.m4ri_elimination);
+                    fmt::println("Threads:                      {}", EXTRACTOR_CONFIG.num_threads);
                     fmt::println("Dynamic Extraction:           {}", EXTRACTOR_CONFIG.dynamic_order);
                     fmt::println("Coeff. of Predictive Formula: {}", EXTRACTOR_CONFIG.pred_coeff);
                 }
@@ -284,6 +294,131 @@ Command extractor_config_cmd() {
             }};
 }
 
+Command extraction_portfolio_cmd(zx::ZXGraphMgr& zxgraph_mgr, QCirMgr& qcir_mgr) {
+    return {"portfolio",
+            [](ArgumentParser& parser) {
+                parser.description("extract the focused ZXGraph with several configurations concurrently and keep the best circuit. "
+                                   "Unspecified knobs follow `extract config`");
+                parser.add_argument<size_t>("--optimize-levels")
+                    .nargs(NArgsOption::one_or_more)
+                    .choices({0, 1, 2, 3})
+                    .metavar("LEVEL")
+                    .help("the optimization levels to try");
+                parser.add_argument<size_t>("--block-sizes")
+                    .nargs(NArgsOption::one_or_more)
+                    .metavar("SIZE")
+                    .help("the block sizes to try");
+                parser.add_argument<float>("--predictive-coefficients")
+                    .nargs(NArgsOption::one_or_more)
+                    .metavar("COEFF")
+                    .help("the coefficients of the predictive formula to try");
+                parser.add_argument<bool>("--reduce-cz")
+                    .action(store_true)
+                    .help("tries both with and without CZ reduction");
+                parser.add_argument<bool>("--dynamic-extraction")
+                    .action(store_true)
+                    .help("tries both with and without dynamic extraction");
+                parser.add_argument<bool>("--frontier-sorted")
+                    .action(store_true)
+                    .help("tries both with and without sorting the frontier");
+                parser.add_argument<size_t>("-r", "--random")
+                    .default_value(0)
+                    .metavar("N")
+                    .help("also tries each configuration N times with the neighbors to the frontier shuffled");
+                parser.add_argument<std::string>("--metric")
+                    .default_value("2q")
+                    .choices({"2q", "depth", "gates"})
+                    .help("the metric to minimize: the number of 2-qubit gates, the circuit depth, or the number of gates");
+                parser.add_argument<float>("--time-budget")
+                    .metavar("SECONDS")
+                    .help("returns the best circuit finished within this time and stops the other runs");
+                parser.add_argument<size_t>("--threads")
+                    .default_value(0)
+                    .help("the number of configurations that run concurrently. 0 means one per hardware core");
+            },
+            [&](ArgumentParser const& parser) {
+                if (!dvlab::utils::mgr_has_data(zxgraph_mgr)) return CmdExecResult::error;
+                if (!is_graph_like(*zxgraph_mgr.get())) {
+                    spdlog::error("ZXGraph {} is not extractable because it is not graph-like!!", zxgraph_mgr.focused_id());
+                    return CmdExecResult::error;
+                }
+
+                auto const base_config = EXTRACTOR_CONFIG;
+                auto const get_or      = [&parser]<typename T>(std::string const& name, T const& fallback) {
+                    return parser.parsed(name) ? parser.get<std::vector<T>>(name) : std::vector<T>{fallback};
+                };
+                auto const both_or = [&parser](std::string const& name, bool fallback) {
+                    return parser.parsed(name) ? std::vector<bool>{false, true} : std::vector<bool>{fallback};
+                };
+
+                auto const block_sizes = get_or("--block-sizes", base_config.block_size);
+                if (std::ranges::find(block_sizes, size_t{0}) != block_sizes.end()) {
+                    spdlog::error("Block size should be a positive number!!");
+                    return CmdExecResult::error;
+                }
+
+                // the runs are the Cartesian product of the knobs
+                std::vector<PortfolioRun> runs;
+                for (auto const optimize_level : get_or("--optimize-levels", base_config.optimize_level)) {
+                    for (auto const block_size : block_sizes) {
+                        for (auto const pred_coeff : get_or("--predictive-coefficients", base_config.pred_coeff)) {
+                            for (auto const reduce_czs : both_or("--reduce-cz", base_config.reduce_czs)) {
+                                for (auto const dynamic_order : both_or("--dynamic-extraction", base_config.dynamic_order)) {
+                                    for (auto const sort_frontier : both_or("--frontier-sorted", base_config.sort_frontier)) {
+                                        auto config           = base_config;
+                                        config.optimize_level = optimize_level;
+                                        config.block_size     = block_size;
+                                        config.pred_coeff     = pred_coeff;
+                                        config.reduce_czs     = reduce_czs;
+                                        config.dynamic_order  = dynamic_order;
+                                        config.sort_frontier  = sort_frontier;
+                                        for (size_t i = 0; i <= parser.get<size_t>("--random"); ++i) {
+                                            runs.push_back({.config = config, .random = i > 0});
+                                        }
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+                for (size_t i = 0; i < runs.size(); ++i) {
+                    auto const& run = runs[i];
+                    spdlog::info("Run {}: optimize level {}, block size {}, pred. coeff. {}, reduce CZs {}, dynamic extraction {}, sort frontier {}{}",
+                                 i, run.config.optimize_level, run.config.block_size, run.config.pred_coeff,
+                                 run.config.reduce_czs, run.config.dynamic_order, run.config.sort_frontier,
+                                 run.random ? ", random" : "");
+                }
+
+                auto const time_budget = parser.parsed("--time-budget")
+                                             ? std::make_optional(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                                   std::chrono::duration<float>(parser.get<float>("--time-budget"))))
+                                             : std::nullopt;
+
+                auto result = portfolio_extract(
+                    *zxgraph_mgr.get(),
+                    runs,
+                    *str_to_portfolio_metric(parser.get<std::string>("--metric")),
+                    time_budget,
+                    parser.get<size_t>("--threads"));
+                if (!result.has_value()) return CmdExecResult::error;
+
+                auto const& winner = runs[result->run_id].config;
+                qcir_mgr.add(qcir_mgr.get_next_id(), std::move(result->circuit));
+                qcir_mgr.get()->set_filename(zxgraph_mgr.get()->get_filename());
+                qcir_mgr.get()->add_procedures(zxgraph_mgr.get()->get_procedures());
+                if (!winner.permute_qubits) {
+                    spdlog::warn("The extracted circuit is up to a qubit permutation.");
+                    spdlog::warn("Remaining permutation information is in ZXGraph id {}.", zxgraph_mgr.get_next_id());
+                    zxgraph_mgr.add(zxgraph_mgr.get_next_id(), std::make_unique<zx::ZXGraph>(std::move(result->graph)));
+                    zxgraph_mgr.get()->add_procedure("ZX2QC-Unpermuted");
+                    qcir_mgr.get()->add_procedure("ZX2QC-Unpermuted");
+                } else {
+                    qcir_mgr.get()->add_procedure("ZX2QC");
+                }
+                return CmdExecResult::done;
+            }};
+}
+
 Command extract_cmd(zx::ZXGraphMgr& zxgraph_mgr, qcir::QCirMgr& qcir_mgr) {
     auto cmd = Command{"extract",
                        [](ArgumentParser& parser) {
@@ -297,6 +432,7 @@ Command extract_cmd(zx::ZXGraphMgr& zxgraph_mgr, qcir::QCirMgr& qcir_mgr) {
     cmd.add_subcommand("extractor-cmd", extractor_config_cmd());
     cmd.add_subcommand("extractor-cmd", extraction_step_cmd(zxgraph_mgr, qcir_mgr));
     cmd.add_subcommand("extractor-cmd", extraction_print_cmd(zxgraph_mgr));
+    cmd.add_subcommand("extractor-cmd", extraction_portfolio_cmd(zxgraph_mgr, qcir_mgr));
 
     return cmd;
 }
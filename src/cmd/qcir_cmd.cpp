@@ -14,6 +14,9 @@
 #include <cstddef>
 #include <cstdint>
 #include <filesystem>
+#include <limits>
+#include <random>
+#include <ranges>
 #include <string>
 
 #include "./qcir/optimizer_cmd.hpp"
@@ -28,6 +31,7 @@
 #include "qcir/qcir_gate.hpp"
 #include "qcir/qcir_io.hpp"
 #include "qcir/qcir_translate.hpp"
+#include "qcir/statevector.hpp"
 #include "util/cin_cout_cerr.hpp"
 #include "util/data_structure_manager_common_cmd.hpp"
 #include "util/dvlab_string.hpp"
@@ -654,6 +658,80 @@ Command qcir_equiv_cmd(QCirMgr& qcir_mgr) {
         }};
 };
 
+Command qcir_simulate_cmd(QCirMgr const& qcir_mgr) {
+    return {
+        "simulate",
+        [&](ArgumentParser& parser) {
+            parser.description(
+                "simulate the QCir on a statevector starting from |0...0>. "
+                "Basis states are written with qubit 0 as the rightmost bit");
+
+            parser.add_argument<std::string>("-o", "--output")
+                .default_value("probabilities")
+                .choices({"amplitudes", "probabilities", "samples"})
+                .help("reports the amplitudes, the probabilities, or the counts of measuring all qubits");
+            parser.add_argument<size_t>("-s", "--shots")
+                .default_value(1024)
+                .help("the number of times to measure the qubits when sampling");
+            parser.add_argument<size_t>("--seed")
+                .help("the seed of the sampler. If not given, a random seed is used");
+            parser.add_argument<double>("-c", "--cutoff")
+                .default_value(1e-10)
+                .help("hides the basis states whose probability is at most this");
+            parser.add_argument<size_t>("-n", "--max-entries")
+                .default_value(64)
+                .help("prints at most this many basis states. 0 means no limit");
+            parser.add_argument<size_t>("--threads")
+                .default_value(1)
+                .help("the number of threads that sweep the statevector. 0 means one per hardware core");
+        },
+        [&](ArgumentParser const& parser) {
+            if (!dvlab::utils::mgr_has_data(qcir_mgr)) return CmdExecResult::error;
+
+            auto const state = simulate(*qcir_mgr.get(), parser.get<size_t>("--threads"));
+            if (!state.has_value()) return CmdExecResult::error;
+
+            auto const output      = parser.get<std::string>("--output");
+            auto const cutoff      = parser.get<double>("--cutoff");
+            auto const max_entries = parser.get<size_t>("--max-entries");
+            auto const num_qubits  = state->get_num_qubits();
+
+            auto const limit = max_entries == 0 ? std::numeric_limits<size_t>::max() : max_entries;
+            auto const ket   = [num_qubits](size_t basis) { return fmt::format("|{:0{}b}>", basis, num_qubits); };
+            // the entries past the limit are only counted, never formatted
+            size_t num_entries = 0;
+            auto const report  = [&](auto const& print_entry) {
+                if (num_entries++ < limit) print_entry();
+            };
+            auto const print_remaining = [&]() {
+                if (num_entries > limit) fmt::println("... and {} more", num_entries - limit);
+            };
+
+            if (output == "samples") {
+                auto rng = std::mt19937_64{parser.parsed("--seed") ? parser.get<size_t>("--seed") : std::random_device{}()};
+                for (auto const& entry : state->sample(parser.get<size_t>("--shots"), rng)) {
+                    report([&] { fmt::println("{}  {}", ket(entry.first), entry.second); });
+                }
+                print_remaining();
+                return CmdExecResult::done;
+            }
+
+            for (size_t basis = 0; basis < state->size(); ++basis) {
+                if (state->get_probability(basis) <= cutoff) continue;
+                report([&] {
+                    auto const amplitude = state->get_amplitude(basis);
+                    if (output == "amplitudes") {
+                        fmt::println("{}  {:+.6f}{:+.6f}i", ket(basis), amplitude.real(), amplitude.imag());
+                    } else {
+                        fmt::println("{}  {:.6f}", ket(basis), state->get_probability(basis));
+                    }
+                });
+            }
+            print_remaining();
+            return CmdExecResult::done;
+        }};
+}
+
 Command qcir_to_basic_cmd(QCirMgr& qcir_mgr);
 
 Command qcir_cmd(QCirMgr& qcir_mgr) {
@@ -678,6 +756,7 @@ Command qcir_cmd(QCirMgr& qcir_mgr) {
     cmd.add_subcommand("qcir-cmd-group", qcir_translate_cmd(qcir_mgr));
     cmd.add_subcommand("qcir-cmd-group", qcir_oracle_cmd(qcir_mgr));
     cmd.add_subcommand("qcir-cmd-group", qcir_equiv_cmd(qcir_mgr));
+    cmd.add_subcommand("qcir-cmd-group", qcir_simulate_cmd(qcir_mgr));
     cmd.add_subcommand("qcir-cmd-group", qcir_to_basic_cmd(qcir_mgr));
     return cmd;
 }
@@ -10,6 +10,8 @@
 #include <fmt/core.h>
 
 #include <cstddef>
+#include <fstream>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -18,6 +20,7 @@
 #include "cmd/zx_cmd.hpp"
 #include "cmd/zxgraph_mgr.hpp"
 #include "util/data_structure_manager_common_cmd.hpp"
+#include "util/scope_guard.hpp"
 #include "zx/simplifier/simplify.hpp"
 #include "zx/zxgraph.hpp"
 #include "zx/zxgraph_action.hpp"
@@ -67,11 +70,38 @@ Command zxgraph_optimize_cmd(zx::ZXGraphMgr& zxgraph_mgr) {
                         "Runs a causal flow-preserving routine that reduces "
                         "2Q-counts. The parameter is the maximum number of "
                         "LCompUnfusion and PivotUnfusion to apply.");
+                parser.add_argument<size_t>("-t", "--threads")
+                    .default_value(1)
+                    .help("the number of threads used to find rule matches. "
+                          "0 means one per hardware core. The result does not "
+                          "depend on this number.");
+                parser.add_argument<std::string>("--trace")
+                    .metavar("file")
+                    .help("writes the wall time, matching and applying time, "
+                          "graph deltas and peak memory of every rule and "
+                          "routine to `file` as JSON Lines");
             },
             [&](ArgumentParser const& parser) {
                 if (!dvlab::utils::mgr_has_data(zxgraph_mgr)) return dvlab::CmdExecResult::error;
                 std::string procedure_str = "";
 
+                std::ofstream trace_file;
+                std::optional<simplify::SimplificationTrace> trace;
+                if (parser.parsed("--trace")) {
+                    auto const filename = parser.get<std::string>("--trace");
+                    trace_file.open(filename);
+                    if (!trace_file.is_open()) {
+                        spdlog::error("Cannot open the trace file \"{}\"!!", filename);
+                        return CmdExecResult::error;
+                    }
+                    trace.emplace(trace_file);
+                    simplify::set_simplification_trace(&*trace);
+                }
+                dvlab::utils::scope_exit const stop_tracing{[] { simplify::set_simplification_trace(nullptr); }};
+
+                set_num_match_threads(parser.get<size_t>("--threads"));
+                dvlab::utils::scope_exit const restore_threads{[] { set_num_match_threads(1); }};
+
                 if (parser.parsed("--symbolic")) {
                     simplify::symbolic_reduce(*zxgraph_mgr.get());
                     procedure_str = "SR";
@@ -79,7 +109,7 @@ Command zxgraph_optimize_cmd(zx::ZXGraphMgr& zxgraph_mgr) {
                     simplify::dynamic_reduce(*zxgraph_mgr.get());
                     procedure_str = "DR";
                 } else if (parser.parsed("--partition")) {
-                    simplify::partition_reduce(*zxgraph_mgr.get(), parser.get<size_t>("--partition"));
+                    simplify::partition_reduce(*zxgraph_mgr.get(), parser.get<size_t>("--partition"), parser.get<size_t>("--threads"));
                     procedure_str = "PR";
                 } else if (parser.parsed("--interior-clifford")) {
                     simplify::interior_clifford_simp(*zxgraph_mgr.get());
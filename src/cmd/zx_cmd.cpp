@@ -154,6 +154,11 @@ Command zxgraph_print_cmd(ZXGraphMgr const& zxgraph_mgr) {
                     fmt::println("{:<29} {}", "#T-gate:", t_count(*zxgraph_mgr.get()));
                     fmt::println("{:<29} {}", "#Non-(Clifford+T)-gate: ", non_clifford_t_count(*zxgraph_mgr.get()));
                     fmt::println("{:<29} {}", "#Non-Clifford-gate: ", non_clifford_count(*zxgraph_mgr.get()));
+                    auto const pool_stats = zxgraph_mgr.get()->get_vertex_pool_statistics();
+                    fmt::println("{:<29} {}/{} slots in {} slabs ({:.1f}% occupied, {:.1f}% fragmented)",
+                                 "Vertex arena: ",
+                                 pool_stats.num_live, pool_stats.capacity, pool_stats.num_slabs,
+                                 pool_stats.occupancy() * 100, pool_stats.fragmentation() * 100);
                 } else if (parser.parsed("--io"))
                     zxgraph_mgr.get()->print_io();
                 else if (parser.parsed("--list"))
@@ -224,8 +229,8 @@ Command zxgraph_read_cmd(ZXGraphMgr& zxgraph_mgr) {
 
                 parser.add_argument<std::string>("filepath")
                     .constraint(path_readable)
-                    .constraint(allowed_extension({".zx", ".zxg"}))
-                    .help("path to the ZX file. Supported extensions: .zx, .zxg");
+                    .constraint(allowed_extension({".zx", ".zxg", ".zxb"}))
+                    .help("path to the ZX file. Supported extensions: .zx, .zxg, .zxb");
 
                 parser.add_argument<bool>("--keep-id")
                     .action(store_true)
@@ -241,8 +246,10 @@ Command zxgraph_read_cmd(ZXGraphMgr& zxgraph_mgr) {
                 auto const do_keep_id = parser.get<bool>("--keep-id");
                 auto const do_replace = parser.get<bool>("--replace");
                 // NOTE - Adding "const" would lead to using copy constructor in std::move
-                auto const zxg = filepath.substr(std::min(filepath.find_last_of('.'), filepath.size())) == ".zxg";
-                auto graph     = zxg ? from_json(filepath) : from_zx(filepath, do_keep_id);
+                auto const extension = filepath.substr(std::min(filepath.find_last_of('.'), filepath.size()));
+                auto graph           = extension == ".zxg"   ? from_json(filepath)
+                                       : extension == ".zxb" ? from_zxb(filepath, do_keep_id)
+                                                             : from_zx(filepath, do_keep_id);
                 if (!graph) {
                     return CmdExecResult::error;
                 }
@@ -270,7 +277,7 @@ Command zxgraph_write_cmd(ZXGraphMgr const& zxgraph_mgr) {
 
                 parser.add_argument<std::string>("filepath")
                     .constraint(path_writable)
-                    .constraint(allowed_extension({".zx", ".zxg", ".tikz", ".tex"}))
+                    .constraint(allowed_extension({".zx", ".zxg", ".zxb", ".tikz", ".tex"}))
                     .help("the path to the output ZX file");
 
                 parser.add_argument<bool>("--complete")
@@ -294,6 +301,11 @@ Command zxgraph_write_cmd(ZXGraphMgr const& zxgraph_mgr) {
                         spdlog::error("Failed to write json to \"{}\"!!", filepath);
                         return CmdExecResult::error;
                     }
+                } else if (extension == ".zxb") {
+                    if (!zxgraph_mgr.get()->write_zxb(filepath)) {
+                        spdlog::error("Failed to write ZXGraph to \"{}\"!!", filepath);
+                        return CmdExecResult::error;
+                    }
                 } else if (extension == ".tikz") {
                     if (!zxgraph_mgr.get()->write_tikz(filepath)) {
                         spdlog::error("Failed to write Tikz to \"{}\"!!", filepath);
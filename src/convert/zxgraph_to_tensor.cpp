@@ -9,6 +9,8 @@
 #include <spdlog/spdlog.h>
 
 #include <cassert>
+#include <cmath>
+#include <complex>
 #include <ranges>
 #include <tl/enumerate.hpp>
 #include <tl/fold.hpp>
@@ -16,6 +18,7 @@
 #include <tl/zip.hpp>
 #include <unordered_map>
 
+#include "util/util.hpp"
 #include "zx/zx_def.hpp"
 #include "zx/zxgraph.hpp"
 
@@ -80,29 +83,102 @@ private:
     InOutAxisList _get_axis_orders(zx::ZXGraph const& zxgraph);
 };
 
-}  // namespace
+/**
+ * @brief The tensor network of a ZXGraph. Every spider is an operand, and so
+ *        is every wire between two boundaries. Each edge between spiders is
+ *        an index, and each boundary is an open index. A Hadamard edge is
+ *        absorbed into the operand of its endpoint with the smaller id, or of
+ *        its spider if the other end is a boundary.
+ *
+ */
+class ZX2TSNetwork {
+public:
+    explicit ZX2TSNetwork(zx::ZXGraph const& graph);
 
-std::optional<tensor::QTensor<double>> to_tensor(zx::ZXGraph const& zxgraph) {
-    ZX2TSMapper mapper;
-    return mapper.map(zxgraph);
-}
+    std::vector<tensor::IndexList> const& get_index_lists() const { return _index_lists; }
+    std::vector<size_t> get_topological_order() const;
+
+    std::optional<tensor::QTensor<double>> contract(tensor::ContractionPath const& path) const;
+
+private:
+    zx::ZXGraph const& _graph;
+
+    struct Operand {
+        zx::ZXVertex* vertex;      // the spider, or the first boundary of a wire
+        size_t num_hadamard_legs;  // the legs with Hadamards, which are the last ones
+    };
+    std::vector<Operand> _operands;
+    std::vector<tensor::IndexList> _index_lists;
+    std::unordered_map<zx::ZXVertex*, size_t> _boundary_indices;
+    std::unordered_map<zx::ZXVertex*, size_t> _operand_ids;
+
+    tensor::QTensor<double> _get_operand_tensor(size_t id) const;
+};
+
+}  // namespace
 
 /**
- * @brief convert a zxgraph to a tensor
+ * @brief convert a zxgraph to a tensor. The contraction path is planned and
+ *        its peak tensor size is reported before any tensor is built.
+ *
+ *        The topological order, the default, is contracted by the frontier
+ *        mapper, which absorbs the vertices in the same order as the planned
+ *        path and keeps its step-by-step trace output. Its path is only used
+ *        for the prediction. The other orders contract the planned path.
  *
+ * @param zxgraph
+ * @param config the contraction order and the memory cap
  * @return std::optional<QTensor<double>> containing a QTensor<double> if the conversion succeeds
  */
-std::optional<tensor::QTensor<double>> ZX2TSMapper::map(zx::ZXGraph const& graph) try {
-    using namespace std::complex_literals;
-    if (graph.is_empty()) {
+std::optional<tensor::QTensor<double>> to_tensor(zx::ZXGraph const& zxgraph, ZX2TSConfig const& config) {
+    if (zxgraph.is_empty()) {
         spdlog::error("The ZXGraph is empty!!");
         return std::nullopt;
     }
-    if (!is_io_connection_valid(graph)) {
+    if (!is_io_connection_valid(zxgraph)) {
         spdlog::error("The ZXGraph is not valid!!");
         return std::nullopt;
     }
 
+    auto const network = ZX2TSNetwork{zxgraph};
+    auto const path    = [&]() {
+        switch (config.order) {
+            case tensor::ContractionOrder::topological:
+                return tensor::plan_sequential_contraction(network.get_index_lists(), network.get_topological_order());
+            case tensor::ContractionOrder::greedy:
+                return tensor::plan_greedy_contraction(network.get_index_lists());
+            case tensor::ContractionOrder::min_fill:
+                return tensor::plan_min_fill_contraction(network.get_index_lists());
+        }
+        return tensor::ContractionPath{};
+    }();
+
+    auto const peak_mib = std::ldexp(double(sizeof(std::complex<double>)), static_cast<int>(path.peak_rank)) / double(1 << 20);
+    spdlog::info("Predicted peak tensor size: 2^{} entries ({:.4f} MiB)", path.peak_rank, peak_mib);
+    if (config.max_memory_mib.has_value() && peak_mib > *config.max_memory_mib) {
+        spdlog::error("The predicted peak tensor size exceeds the memory cap of {} MiB!!", *config.max_memory_mib);
+        return std::nullopt;
+    }
+
+    switch (config.order) {
+        case tensor::ContractionOrder::topological: {
+            ZX2TSMapper mapper;
+            return mapper.map(zxgraph);
+        }
+        case tensor::ContractionOrder::greedy:
+        case tensor::ContractionOrder::min_fill:
+            return network.contract(path);
+    }
+    DVLAB_UNREACHABLE("unknown contraction order");
+}
+
+/**
+ * @brief convert a zxgraph to a tensor
+ *
+ * @return std::optional<QTensor<double>> containing a QTensor<double> if the conversion succeeds
+ */
+std::optional<tensor::QTensor<double>> ZX2TSMapper::map(zx::ZXGraph const& graph) try {
+    using namespace std::complex_literals;
     graph.topological_traverse([&graph, this](zx::ZXVertex* v) { _map_one_vertex(graph, v); });
 
     if (stop_requested()) {
@@ -380,6 +456,129 @@ void ZX2TSMapper::_tensordot_vertex(zx::ZXGraph const& graph, zx::ZXVertex* v) {
     }
 }
 
+ZX2TSNetwork::ZX2TSNetwork(zx::ZXGraph const& graph) : _graph{graph} {
+    for (auto* v : graph.get_inputs()) _boundary_indices.emplace(v, _boundary_indices.size());
+    for (auto* v : graph.get_outputs()) _boundary_indices.emplace(v, _boundary_indices.size());
+
+    std::unordered_map<zx::EdgePair, size_t, zx::EdgePairHash> edge_indices;
+    auto const get_index = [&](zx::ZXVertex* v, zx::ZXVertex* nb, zx::EdgeType etype) {
+        if (nb->is_boundary()) return _boundary_indices.at(nb);
+        return edge_indices.emplace(make_edge_pair(v, nb, etype), _boundary_indices.size() + edge_indices.size()).first->second;
+    };
+
+    for (auto* v : graph.get_vertices()) {
+        if (v->is_boundary()) {
+            auto const [nb, etype] = graph.get_first_neighbor(v);
+            if (!nb->is_boundary() || nb->get_id() < v->get_id()) continue;
+            _operand_ids.emplace(v, _operands.size());
+            _operands.push_back({v, etype == zx::EdgeType::hadamard ? 1ul : 0ul});
+            _index_lists.push_back({_boundary_indices.at(v), _boundary_indices.at(nb)});
+            continue;
+        }
+
+        // the spider tensors are symmetric, so the legs may be put in any order
+        tensor::IndexList plain_indices, hadamard_indices;
+        for (auto const& [nb, etype] : graph.get_neighbors(v)) {
+            auto const owns_hadamard = etype == zx::EdgeType::hadamard && (nb->is_boundary() || v->get_id() < nb->get_id());
+            (owns_hadamard ? hadamard_indices : plain_indices).emplace_back(get_index(v, nb, etype));
+        }
+        _operand_ids.emplace(v, _operands.size());
+        _operands.push_back({v, hadamard_indices.size()});
+        _index_lists.emplace_back(tensor::concat_axis_list(plain_indices, hadamard_indices));
+    }
+}
+
+/**
+ * @brief Get the operands in the topological order of their vertices
+ *
+ * @return std::vector<size_t>
+ */
+std::vector<size_t> ZX2TSNetwork::get_topological_order() const {
+    std::vector<size_t> order;
+    order.reserve(_operands.size());
+    for (auto* v : _graph.get_topological_order()) {
+        if (auto const it = _operand_ids.find(v); it != _operand_ids.end()) {
+            order.emplace_back(it->second);
+        }
+    }
+    return order;
+}
+
+/**
+ * @brief Build the tensor of an operand, with its legs in the order of its index list
+ *
+ * @param id
+ * @return QTensor<double>
+ */
+tensor::QTensor<double> ZX2TSNetwork::_get_operand_tensor(size_t id) const {
+    auto const& [vertex, num_hadamard_legs] = _operands[id];
+    auto const ts = vertex->is_boundary() ? tensor::QTensor<double>::identity(1) : get_tensor_form(_graph, vertex);
+    if (num_hadamard_legs == 0) return ts;
+
+    // the legs dotted with the Hadamards are moved to the back, keeping their order
+    auto const hadamard_legs = std::views::iota(ts.dimension() - num_hadamard_legs, ts.dimension()) | tl::to<std::vector>();
+    auto const h_inputs      = std::views::iota(0ul, num_hadamard_legs) |
+                          std::views::transform([](auto i) { return 2 * i; }) |
+                          tl::to<std::vector>();
+    return tensordot(ts, tensor_product_pow(tensor::QTensor<double>::hbox(2), num_hadamard_legs), hadamard_legs, h_inputs);
+}
+
+/**
+ * @brief Contract the network along the path
+ *
+ * @param path
+ * @return std::optional<QTensor<double>> the tensor with the outputs as rows
+ *         and the inputs as columns, or std::nullopt if interrupted or out of memory
+ */
+std::optional<tensor::QTensor<double>> ZX2TSNetwork::contract(tensor::ContractionPath const& path) const try {
+    auto index_lists = _index_lists;
+    auto tensors     = std::vector<std::optional<tensor::QTensor<double>>>(_operands.size() + path.steps.size());
+
+    auto const take = [&](size_t id) {
+        if (id < _operands.size()) return _get_operand_tensor(id);
+        auto ts = std::move(*tensors[id]);
+        tensors[id].reset();
+        return ts;
+    };
+
+    for (auto const& [a, b] : path.steps) {
+        if (stop_requested()) {
+            spdlog::error("Conversion is interrupted!!");
+            return std::nullopt;
+        }
+        tensor::TensorAxisList a_axes, b_axes;
+        for (auto const& [a_axis, idx] : tl::views::enumerate(index_lists[a])) {
+            auto const it = std::ranges::find(index_lists[b], idx);
+            if (it == index_lists[b].end()) continue;
+            a_axes.emplace_back(a_axis);
+            b_axes.emplace_back(it - index_lists[b].begin());
+        }
+        auto const a_tensor = take(a);
+        auto const b_tensor = take(b);
+        tensors[index_lists.size()] = tensordot(a_tensor, b_tensor, a_axes, b_axes);
+        index_lists.emplace_back(tensor::contract_index_lists(index_lists[a], index_lists[b]));
+        spdlog::debug("Contracted tensor {} and {} into tensor {} of dimension {}", a, b, index_lists.size() - 1, index_lists.back().size());
+    }
+
+    auto result          = take(index_lists.size() - 1);
+    auto const& indices  = index_lists.back();
+    auto const get_axes  = [&](zx::ZXVertexList boundaries) {
+        boundaries.sort([](auto const& a, auto const& b) { return a->get_qubit() < b->get_qubit(); });
+        return boundaries |
+               std::views::transform([&](auto* v) { return static_cast<size_t>(std::ranges::find(indices, _boundary_indices.at(v)) - indices.begin()); }) |
+               tl::to<std::vector>();
+    };
+    auto const input_ids  = get_axes(_graph.get_inputs());
+    auto const output_ids = get_axes(_graph.get_outputs());
+
+    spdlog::trace("Input  Axis IDs: {}", fmt::join(input_ids, " "));
+    spdlog::trace("Output Axis IDs: {}", fmt::join(output_ids, " "));
+    return result.to_matrix(output_ids, input_ids);
+} catch (std::bad_alloc& e) {
+    spdlog::error("Memory allocation failed!!");
+    return std::nullopt;
+}
+
 }  // namespace
 
 }  // namespace qsyn
@@ -7,8 +7,10 @@
 #pragma once
 
 #include <cstddef>
+#include <optional>
 #include <vector>
 
+#include "tensor/contraction_path.hpp"
 #include "tensor/qtensor.hpp"
 #include "zx/zx_def.hpp"
 
@@ -21,7 +23,13 @@ class ZXVertex;
 
 }  // namespace zx
 
-std::optional<tensor::QTensor<double>> to_tensor(zx::ZXGraph const& zxgraph);
+struct ZX2TSConfig {
+    tensor::ContractionOrder order = tensor::ContractionOrder::topological;
+    // refuses to convert if the largest tensor along the path is predicted to take more memory than this
+    std::optional<double> max_memory_mib;
+};
+
+std::optional<tensor::QTensor<double>> to_tensor(zx::ZXGraph const& zxgraph, ZX2TSConfig const& config = {});
 
 tensor::QTensor<double> get_tensor_form(zx::ZXGraph const& graph, zx::ZXVertex* v);
 
@@ -13,8 +13,10 @@
 #include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <memory>
 #include <random>
 #include <ranges>
+#include <thread>
 
 #include "duostra/duostra.hpp"
 #include "duostra/mapping_eqv_checker.hpp"
@@ -68,6 +70,10 @@ void Extractor::initialize() {
         cnt++;
     }
 
+    // NOTE - each spider leaves the frontier with about a Hadamard and a phase
+    //        gate, and the CXs and CZs are usually of the same order
+    _gate_buffer.reserve(2 * _graph->num_vertices());
+
     // NOTE - get zx to qc qubit mapping
     _frontier.sort([](ZXVertex const* a, ZXVertex const* b) {
         return a->get_qubit() < b->get_qubit();
@@ -83,7 +89,7 @@ void Extractor::initialize() {
     print_frontier(spdlog::level::level_enum::trace);
     print_neighbors(spdlog::level::level_enum::trace);
     _graph->print_vertices_by_rows(spdlog::level::level_enum::trace);
-    _logical_circuit->print_circuit_diagram(spdlog::level::level_enum::trace);
+    _print_circuit(spdlog::level::level_enum::trace);
 }
 
 /**
@@ -99,20 +105,21 @@ QCir* Extractor::extract() {
     if (!extraction_loop(-1)) {
         return nullptr;
     }
-    if (stop_requested()) {
+    if (_stop_requested()) {
         spdlog::warn("Conversion is interrupted");
         return nullptr;
     }
 
     spdlog::info("Finished Extracting!");
-    _logical_circuit->print_circuit_diagram(spdlog::level::level_enum::trace);
+    _print_circuit(spdlog::level::level_enum::trace);
     _graph->print_vertices_by_rows(spdlog::level::level_enum::trace);
 
     if (_config.permute_qubits) {
         permute_qubits();
-        _logical_circuit->print_circuit_diagram(spdlog::level::level_enum::trace);
+        _print_circuit(spdlog::level::level_enum::trace);
         _graph->print_vertices_by_rows(spdlog::level::level_enum::trace);
     }
+    flush_gate_buffer();
     return _logical_circuit;
 }
 
@@ -124,7 +131,7 @@ QCir* Extractor::extract() {
  * @return false if not
  */
 bool Extractor::extraction_loop(std::optional<size_t> max_iter) {
-    while ((!max_iter.has_value() || *max_iter > 0) && !stop_requested()) {
+    while ((!max_iter.has_value() || *max_iter > 0) && !_stop_requested()) {
         clean_frontier();
         update_neighbors();
 
@@ -133,7 +140,7 @@ bool Extractor::extraction_loop(std::optional<size_t> max_iter) {
             spdlog::debug("Gadget(s) are removed.");
             print_frontier(spdlog::level::level_enum::trace);
             _graph->print_vertices_by_rows(spdlog::level::level_enum::trace);
-            _logical_circuit->print_circuit_diagram(spdlog::level::level_enum::trace);
+            _print_circuit(spdlog::level::level_enum::trace);
             continue;
         }
         if (_config.dynamic_order) {
@@ -159,7 +166,7 @@ bool Extractor::extraction_loop(std::optional<size_t> max_iter) {
         print_frontier(spdlog::level::level_enum::trace);
         print_neighbors(spdlog::level::level_enum::trace);
         _graph->print_vertices_by_rows(spdlog::level::level_enum::trace);
-        _logical_circuit->print_circuit_diagram(spdlog::level::level_enum::trace);
+        _print_circuit(spdlog::level::level_enum::trace);
 
         if (max_iter.has_value()) (*max_iter)--;
     }
@@ -187,20 +194,20 @@ void Extractor::extract_singles() {
     std::vector<std::pair<ZXVertex*, ZXVertex*>> toggle_list;
     for (ZXVertex* o : _graph->get_outputs()) {
         if (_graph->get_first_neighbor(o).second == EdgeType::hadamard) {
-            _logical_circuit->prepend(HGate(), {_qubit_map[o->get_qubit()]});
+            _prepend(HGate(), {_qubit_map[o->get_qubit()]});
             toggle_list.emplace_back(o, _graph->get_first_neighbor(o).first);
         }
         auto const ph = _graph->get_first_neighbor(o).first->phase();
         if (ph != dvlab::Phase(0)) {
-            _logical_circuit->prepend(PZGate(ph), {_qubit_map[o->get_qubit()]});
-            _graph->get_first_neighbor(o).first->phase() = dvlab::Phase(0);
+            _prepend(PZGate(ph), {_qubit_map[o->get_qubit()]});
+            _graph->set_phase(_graph->get_first_neighbor(o).first, dvlab::Phase(0));
         }
     }
     for (auto& [s, t] : toggle_list) {
         _graph->remove_edge(s, t, EdgeType::hadamard);
         _graph->add_edge(s, t, EdgeType::simple);
     }
-    _logical_circuit->print_circuit_diagram(spdlog::level::level_enum::trace);
+    _print_circuit(spdlog::level::level_enum::trace);
     _graph->print_vertices_by_rows(spdlog::level::level_enum::trace);
 }
 
@@ -256,7 +263,8 @@ bool Extractor::extract_czs(bool check) {
     size_t saved_cz_cnt = 0;
     if (_config.reduce_czs) {
         // Remove two most similar rows by CXs and CZs
-        auto [overlap, commons] = _max_overlap(_biadjacency);
+        auto overlaps           = dvlab::RowOverlaps(_biadjacency);
+        auto [overlap, commons] = _max_overlap(_biadjacency, overlaps);
         while (commons.size() > 2) {
             auto [i, j] = overlap;
             saved_cz_cnt += commons.size() - 2;
@@ -269,7 +277,10 @@ bool Extractor::extract_czs(bool check) {
                 _biadjacency[idx][j] = 0;
             }
             gates.emplace_back(0, CXGate(), QubitIdList{_qubit_map[idx2vertex[i]->get_qubit()], _qubit_map[idx2vertex[j]->get_qubit()]});
-            std::tie(overlap, commons) = _max_overlap(_biadjacency);
+            commons.emplace_back(i);
+            commons.emplace_back(j);
+            overlaps.update_rows(_biadjacency, commons);
+            std::tie(overlap, commons) = _max_overlap(_biadjacency, overlaps);
         }
         if (saved_cz_cnt > 0) spdlog::info("Reduce {} 2-qubit gate(s)", saved_cz_cnt);
     }
@@ -286,7 +297,7 @@ bool Extractor::extract_czs(bool check) {
     if (!gates.empty())
         prepend_series_gates(gates);
 
-    _logical_circuit->print_circuit_diagram(spdlog::level::level_enum::trace);
+    _print_circuit(spdlog::level::level_enum::trace);
     _graph->print_vertices_by_rows(spdlog::level::level_enum::trace);
 
     return true;
@@ -313,7 +324,7 @@ void Extractor::extract_cxs() {
         auto ctrl = _qubit_map[front_id2_vertex[c]->get_qubit()];
         auto targ = _qubit_map[front_id2_vertex[t]->get_qubit()];
         spdlog::debug("Adding CX: {} {}", ctrl, targ);
-        _logical_circuit->prepend(CXGate(), {ctrl, targ});
+        _prepend(CXGate(), {ctrl, targ});
     }
 }
 
@@ -367,7 +378,7 @@ size_t Extractor::extract_hadamards_from_matrix(bool check) {
 
     for (auto& [f, n] : front_neigh_pairs) {
         // NOTE - Add Hadamard according to the v of frontier (row)
-        _logical_circuit->prepend(HGate(), {_qubit_map[f->get_qubit()]});
+        _prepend(HGate(), {_qubit_map[f->get_qubit()]});
         // NOTE - Set #qubit and #col according to the old frontier
         n->set_qubit(f->get_qubit());
         n->set_col(f->get_col());
@@ -422,8 +433,8 @@ bool Extractor::remove_gadget(bool check) {
     }
 
     if (_random) {
-        static std::random_device rd1;
-        static std::mt19937 g1(rd1());
+        // thread-local so that concurrent extractors, e.g., in a portfolio, do not share the engine
+        static thread_local std::mt19937 g1(std::random_device{}());
         std::shuffle(std::begin(shuffle_neighbors), std::end(shuffle_neighbors), g1);
     }
 
@@ -476,6 +487,9 @@ bool Extractor::remove_gadget(bool check) {
         }
     }
 
+    // pivoting changes the edges among the neighbors of the frontier
+    if (removed_some_gadgets) _biadjacency_cache.invalidate();
+
     _graph->print_vertices(spdlog::level::level_enum::trace);
     print_frontier(spdlog::level::level_enum::trace);
     print_axels(spdlog::level::level_enum::trace);
@@ -741,7 +755,7 @@ bool Extractor::biadjacency_eliminations(bool check) {
     if (_config.optimize_level == 0) {
         column_optimal_swap();
         update_matrix();
-        _biadjacency.gaussian_elimination_skip(_config.block_size, true, true);
+        _gaussian_elimination(_biadjacency, _config.block_size);
         if (_config.filter_duplicate_cxs) _filter_duplicate_cxs();
         _cnots = _biadjacency.get_row_operations();
         return true;
@@ -752,12 +766,16 @@ bool Extractor::biadjacency_eliminations(bool check) {
 
     DVLAB_ASSERT(_config.optimize_level <= 3, "Error: wrong optimize level");
 
-    if (_config.optimize_level > 1) {
-        // NOTE - opt = 2 or 3
+    // greedy_matrix is a copy, so this may run alongside the block eliminations
+    auto const run_greedy_reduction = [&]() {
         greedy_opers = greedy_reduction(greedy_matrix);
         for (auto const& oper : greedy_opers) {
             greedy_matrix.row_operation(oper.first, oper.second, true);
         }
+    };
+
+    if (_config.optimize_level == 2) {
+        run_greedy_reduction();
     }
 
     if (_config.optimize_level != 2 || greedy_opers.empty()) {
@@ -765,11 +783,33 @@ bool Extractor::biadjacency_eliminations(bool check) {
         column_optimal_swap();
         update_matrix();
 
-        auto min_cnots = SIZE_MAX;
-        dvlab::BooleanMatrix best_matrix;
-        for (size_t blk = 1; blk < _biadjacency.num_cols(); blk++) {
-            _block_elimination(best_matrix, min_cnots, blk);
-        }
+        auto const block_size_end = _config.m4ri_elimination
+                                        ? std::min(_biadjacency.num_cols(), dvlab::BooleanMatrix::max_m4ri_block_size + 1)
+                                        : _biadjacency.num_cols();
+        auto const num_block_sizes = std::max(block_size_end, size_t{1}) - 1;
+        auto const with_greedy     = _config.optimize_level == 3;
+
+        // each block size writes to its own slot so that the choice does not
+        // depend on the scheduling; the greedy reduction goes first as it is
+        // usually the longest task
+        std::vector<dvlab::BooleanMatrix> block_matrices(num_block_sizes);
+        _get_thread_pool().parallel_for(num_block_sizes + (with_greedy ? 1 : 0), [&](size_t i) {
+            if (with_greedy) {
+                if (i == 0) {
+                    run_greedy_reduction();
+                    return;
+                }
+                --i;
+            }
+            block_matrices[i] = _block_elimination(i + 1);
+        });
+        if (_config.filter_duplicate_cxs) _filter_duplicate_cxs();
+
+        // the fewest CXs, with ties broken by the smaller block size
+        auto const best_itr = std::ranges::min_element(block_matrices, {}, [](dvlab::BooleanMatrix const& m) {
+            return m.get_row_operations().size();
+        });
+        auto const best_matrix = best_itr == block_matrices.end() ? dvlab::BooleanMatrix{} : std::move(*best_itr);
         if (_config.optimize_level == 1) {
             _biadjacency = best_matrix;
             _cnots       = _biadjacency.get_row_operations();
@@ -800,19 +840,53 @@ bool Extractor::biadjacency_eliminations(bool check) {
 }
 
 /**
- * @brief Perform Gaussian Elimination with block size `blockSize`
+ * @brief Perform Gaussian Elimination with block size `blockSize` on a copy of
+ *        the biadjacency matrix. Safe to call concurrently.
  *
- * @param bestMatrix Currently best matrix
- * @param minCnots Minimum value
  * @param blockSize
+ * @return dvlab::BooleanMatrix the reduced matrix and its row operations
  */
-void Extractor::_block_elimination(dvlab::BooleanMatrix& best_matrix, size_t& min_n_cxs, size_t block_size) {
+dvlab::BooleanMatrix Extractor::_block_elimination(size_t block_size) const {
     dvlab::BooleanMatrix copied_matrix = _biadjacency;
-    copied_matrix.gaussian_elimination_skip(block_size, true, true);
-    if (_config.filter_duplicate_cxs) _filter_duplicate_cxs();
-    if (copied_matrix.get_row_operations().size() < min_n_cxs) {
-        min_n_cxs   = copied_matrix.get_row_operations().size();
-        best_matrix = copied_matrix;
+    _gaussian_elimination(copied_matrix, block_size);
+    return copied_matrix;
+}
+
+/**
+ * @brief Check whether extraction should stop, either by the CLI or by the stop token
+ *
+ * @return true if extraction should stop
+ */
+bool Extractor::_stop_requested() const {
+    return stop_requested() || _stop_token.stop_requested();
+}
+
+/**
+ * @brief Get the thread pool for the block-size search, creating it on first use
+ *
+ * @return dvlab::utils::thread_pool&
+ */
+dvlab::utils::thread_pool& Extractor::_get_thread_pool() {
+    if (_thread_pool == nullptr) {
+        auto const num_threads = _config.num_threads == 0
+                                     ? size_t{std::max(std::thread::hardware_concurrency(), 1u)}
+                                     : _config.num_threads;
+        _thread_pool = std::make_unique<dvlab::utils::thread_pool>(num_threads);
+    }
+    return *_thread_pool;
+}
+
+/**
+ * @brief Fully reduce the matrix by block Gaussian elimination, tracking the row operations
+ *
+ * @param matrix
+ * @param block_size
+ */
+void Extractor::_gaussian_elimination(dvlab::BooleanMatrix& matrix, size_t block_size) const {
+    if (_config.m4ri_elimination) {
+        matrix.gaussian_elimination_m4ri(block_size, true, true);
+    } else {
+        matrix.gaussian_elimination_skip(block_size, true, true);
     }
 }
 
@@ -849,7 +923,7 @@ void Extractor::permute_qubits() {
     for (auto& [o, i] : swap_map) {
         if (o == i) continue;
         auto t2 = swap_inv_map.at(o);
-        prepend_swap_gate(_qubit_map[o], _qubit_map[t2], _logical_circuit);
+        prepend_swap_gate(_qubit_map[o], _qubit_map[t2]);
         swap_map[t2]    = i;
         swap_inv_map[i] = t2;
     }
@@ -886,7 +960,7 @@ void Extractor::update_neighbors() {
             for (auto& [b, ep] : _graph->get_neighbors(f)) {
                 if (_graph->get_inputs().contains(b)) {
                     if (ep == EdgeType::hadamard) {
-                        _logical_circuit->prepend(HGate(), {_qubit_map[f->get_qubit()]});
+                        _prepend(HGate(), {_qubit_map[f->get_qubit()]});
                     }
                     break;
                 }
@@ -940,14 +1014,17 @@ void Extractor::update_graph_by_matrix(EdgeType et) {
         }
         r++;
     }
+    _biadjacency_cache.assign(_biadjacency, _frontier, _neighbors);
 }
 
 /**
- * @brief Create bi-adjacency matrix from frontier and neighbors
+ * @brief Create bi-adjacency matrix from frontier and neighbors. Only the rows
+ *        and columns of vertices that entered the frontier or the neighbors
+ *        since the last update are read from the graph.
  *
  */
 void Extractor::update_matrix() {
-    _biadjacency = get_biadjacency_matrix(*_graph, _frontier, _neighbors);
+    _biadjacency = _biadjacency_cache.update(*_graph, _frontier, _neighbors);
 }
 
 // /**
@@ -957,9 +1034,8 @@ void Extractor::update_matrix() {
 //  * @param physical
 //  */
 void Extractor::prepend_series_gates(std::vector<qcir::QCirGate> const& logical /*, std::vector<Operation> const& physical*/) {
-    for (auto const& gate : logical) {
-        _logical_circuit->prepend(gate.get_operation(), gate.get_qubits());
-    }
+    _gate_buffer.insert(_gate_buffer.end(), logical.begin(), logical.end());
+    for (auto const& gate : logical) _gate_statistics.add_prepended_gate(gate);
 }
 
 /**
@@ -967,13 +1043,70 @@ void Extractor::prepend_series_gates(std::vector<qcir::QCirGate> const& logical
  *
  * @param q0 logical
  * @param q1 logical
- * @param circuit
  */
-void Extractor::prepend_swap_gate(QubitIdType q0, QubitIdType q1, QCir* circuit) {
+void Extractor::prepend_swap_gate(QubitIdType q0, QubitIdType q1) {
     // NOTE - No qubit permutation in Physical Circuit
-    circuit->prepend(CXGate(), {q0, q1});
-    circuit->prepend(CXGate(), {q1, q0});
-    circuit->prepend(CXGate(), {q0, q1});
+    _prepend(CXGate(), {q0, q1});
+    _prepend(CXGate(), {q1, q0});
+    _prepend(CXGate(), {q0, q1});
+}
+
+/**
+ * @brief Prepend a gate to the circuit. The gate is buffered until the next flush.
+ *
+ * @param op
+ * @param qubits
+ */
+void Extractor::_prepend(Operation const& op, QubitIdList const& qubits) {
+    _gate_buffer.emplace_back(op, qubits);
+    _gate_statistics.add_prepended_gate(_gate_buffer.back());
+}
+
+/**
+ * @brief Account for a gate prepended to the circuit. The gate starts a chain
+ *        one longer than the longest chain that starts on any of its qubits.
+ *
+ * @param gate
+ */
+void ExtractedGateStatistics::add_prepended_gate(qcir::QCirGate const& gate) {
+    ++_num_gates;
+    if (gate.get_num_qubits() == 2) ++_num_two_qubit_gates;
+
+    size_t gate_depth = 0;
+    for (size_t i = 0; i < gate.get_num_qubits(); ++i) {
+        auto const qubit = gate.get_qubit(i);
+        if (qubit >= _qubit_depths.size()) _qubit_depths.resize(qubit + 1, 0);
+        gate_depth = std::max(gate_depth, _qubit_depths[qubit] + 1);
+    }
+    for (size_t i = 0; i < gate.get_num_qubits(); ++i) {
+        _qubit_depths[gate.get_qubit(i)] = gate_depth;
+    }
+    _depth = std::max(_depth, gate_depth);
+}
+
+/**
+ * @brief Prepend the buffered gates to the circuit, the latest-extracted one
+ *        being the first. The gate IDs are the same as if the gates were
+ *        prepended one by one.
+ *
+ */
+void Extractor::flush_gate_buffer() {
+    if (_gate_buffer.empty()) return;
+    _logical_circuit->reserve(_logical_circuit->get_num_gates() + _gate_buffer.size());
+    _logical_circuit->prepend_all(_gate_buffer);
+    _gate_buffer.clear();
+}
+
+/**
+ * @brief Print the circuit extracted so far. The gate buffer is flushed only if
+ *        the level is enabled.
+ *
+ * @param lvl
+ */
+void Extractor::_print_circuit(spdlog::level::level_enum lvl) {
+    if (!spdlog::should_log(lvl)) return;
+    flush_gate_buffer();
+    _logical_circuit->print_circuit_diagram(lvl);
 }
 
 /**
@@ -8,8 +8,10 @@
 #pragma once
 
 #include <cstddef>
+#include <memory>
 #include <optional>
 #include <set>
+#include <stop_token>
 
 // #include "device/device.hpp"
 // #include "duostra/duostra.hpp"
@@ -17,6 +19,7 @@
 #include "qsyn/qsyn_type.hpp"
 #include "spdlog/common.h"
 #include "util/boolean_matrix.hpp"
+#include "util/thread_pool.hpp"
 #include "zx/zx_def.hpp"
 #include "zx/zxgraph.hpp"
 
@@ -47,12 +50,58 @@ struct ExtractorConfig {
     size_t optimize_level;      // the strategy for biadjacency elimination.
                                 // 0: fixed block size, 1: all block sizes,
                                 // 2: greedy reduction, 3: best of 1 and 2
+    bool m4ri_elimination;      // uses the Method of Four Russians for block
+                                // Gaussian elimination. Faster on wide
+                                // frontiers, but block sizes are capped at
+                                // BooleanMatrix::max_m4ri_block_size
+    size_t num_threads;         // the number of threads that try block
+                                // sizes concurrently in optimization
+                                // levels 1 and 3. 0 means one per
+                                // hardware core
     float pred_coeff;           // hyperparameter for the dynamic extraction
                                 // routine. If
                                 // #CZs > #(edge reduced) * coeff,
                                 // eagerly extract CZs
 };
 
+// the defaults of `extract config`
+constexpr ExtractorConfig default_extractor_config{
+    .sort_frontier        = false,
+    .sort_neighbors       = true,
+    .permute_qubits       = true,
+    .filter_duplicate_cxs = true,
+    .reduce_czs           = false,
+    .dynamic_order        = false,
+    .block_size           = 5,
+    .optimize_level       = 2,
+    .m4ri_elimination     = false,
+    .num_threads          = 1,
+    .pred_coeff           = 0.7,
+};
+
+/**
+ * @brief Running statistics of the gates an extractor prepends, so that they
+ *        can be read during extraction without flushing or rescanning the
+ *        circuit. Since gates are only ever prepended, the depth is kept per
+ *        qubit as the longest chain of gates from that qubit's first gate to
+ *        the end of the circuit.
+ *
+ */
+class ExtractedGateStatistics {
+public:
+    void add_prepended_gate(qcir::QCirGate const& gate);
+
+    size_t num_gates() const { return _num_gates; }
+    size_t num_two_qubit_gates() const { return _num_two_qubit_gates; }
+    size_t depth() const { return _depth; }
+
+private:
+    size_t _num_gates           = 0;
+    size_t _num_two_qubit_gates = 0;
+    size_t _depth               = 0;
+    std::vector<size_t> _qubit_depths;  // indexed by the qubit ID
+};
+
 class Extractor {
 public:
     using Target      = std::unordered_map<size_t, size_t>;
@@ -65,7 +114,18 @@ public:
         qcir::QCir* qcir = nullptr,
         bool random      = false);
 
-    qcir::QCir* get_logical() { return _logical_circuit; }
+    qcir::QCir* get_logical() {
+        flush_gate_buffer();
+        return _logical_circuit;
+    }
+    // the statistics of the gates extracted so far, including those not yet flushed
+    ExtractedGateStatistics const& get_gate_statistics() const { return _gate_statistics; }
+    bool frontier_is_empty() const { return _frontier.empty(); }
+    zx::ZXVertexList const& get_frontier() const { return _frontier; }
+    zx::ZXVertexList const& get_neighbors() const { return _neighbors; }
+    dvlab::BooleanMatrix const& get_biadjacency() const { return _biadjacency; }
+    // the extraction loop also stops when this token is requested to
+    void set_stop_token(std::stop_token token) { _stop_token = std::move(token); }
 
     void initialize();
     qcir::QCir* extract();
@@ -85,7 +145,8 @@ public:
     void update_matrix();
 
     void prepend_series_gates(std::vector<qcir::QCirGate> const& logical /*, std::vector<Operation> const& physical = {} */);
-    void prepend_swap_gate(QubitIdType q0, QubitIdType q1, qcir::QCir* circuit);
+    void prepend_swap_gate(QubitIdType q0, QubitIdType q1);
+    void flush_gate_buffer();
     bool frontier_is_cleaned();
     bool axel_in_neighbors();
     bool contains_single_neighbor();
@@ -105,6 +166,11 @@ private:
     size_t _num_cx_iterations       = 0;
     zx::ZXGraph* _graph;
     qcir::QCir* _logical_circuit;
+    std::vector<qcir::QCirGate> _gate_buffer;  // gates yet to be prepended to the circuit,
+                                               // in the order they are extracted. Only
+                                               // extract(), get_logical() and
+                                               // flush_gate_buffer() write them out
+    ExtractedGateStatistics _gate_statistics;
     bool _random;
     bool _previous_gadget = false;
     zx::ZXVertexList _frontier;
@@ -113,16 +179,18 @@ private:
     std::unordered_map<QubitIdType, QubitIdType> _qubit_map;  // zx to qc
 
     dvlab::BooleanMatrix _biadjacency;
+    zx::BiadjacencyCache _biadjacency_cache;  // the frontier-neighbor edges as of the last update
     std::vector<dvlab::BooleanMatrix::RowOperation> _cnots;
 
-    void _block_elimination(dvlab::BooleanMatrix& matrix, size_t& min_n_cxs, size_t block_size);
+    dvlab::BooleanMatrix _block_elimination(size_t block_size) const;
+    void _gaussian_elimination(dvlab::BooleanMatrix& matrix, size_t block_size) const;
     void _filter_duplicate_cxs();
     // NOTE - Use only in column optimal swap
     Target _find_column_swap(Target target);
     ConnectInfo _row_info;
     ConnectInfo _col_info;
 
-    Overlap _max_overlap(dvlab::BooleanMatrix& matrix);
+    Overlap _max_overlap(dvlab::BooleanMatrix const& matrix, dvlab::RowOverlaps const& overlaps);
 
     int _calculate_diff_pivot_edges_if_extracting_cz(zx::ZXVertex* frontier, zx::ZXVertex* axel, zx::ZXVertex* cz_target);
 
@@ -134,6 +202,13 @@ private:
     std::vector<size_t> _initial_placement;
 
     ExtractorConfig _config;
+    std::stop_token _stop_token;
+    std::unique_ptr<dvlab::utils::thread_pool> _thread_pool;  // created on the first block-size search
+
+    dvlab::utils::thread_pool& _get_thread_pool();
+    bool _stop_requested() const;
+    void _prepend(qcir::Operation const& op, QubitIdList const& qubits);
+    void _print_circuit(spdlog::level::level_enum lvl);
 };
 
 }  // namespace extractor
@@ -7,7 +7,10 @@
 
 #include <fmt/core.h>
 
+#include <algorithm>
 #include <cstddef>
+#include <numeric>
+#include <utility>
 
 #include "./extract.hpp"
 #include "util/util.hpp"
@@ -26,37 +29,46 @@ std::vector<size_t> Extractor::find_minimal_sums(dvlab::BooleanMatrix& matrix) {
     for (size_t i = 0; i < matrix.num_rows(); i++) {
         if (matrix[i].is_one_hot()) return {};
     }
-    std::vector<std::pair<std::vector<size_t>, dvlab::BooleanMatrix::Row>> row_track_pairs, new_row_track_pairs;
 
+    // Search the sums of 2, 3, ... rows breadth-first. A sum is stored as the
+    // sum it extends plus one more row, so checking a candidate is a single
+    // popcount and its indices are only collected for the answer. The search
+    // gives up after max_minimal_sum_candidates candidates
+    struct PartialSum {
+        size_t parent;  // index into `sums`, or SIZE_MAX for a single row
+        size_t last;    // the largest row index in the sum
+        dvlab::BooleanMatrix::Row row;
+    };
+    constexpr size_t max_minimal_sum_candidates = 100000;
+
+    std::vector<PartialSum> sums;
     for (size_t i = 0; i < matrix.num_rows(); i++)
-        row_track_pairs.emplace_back(std::vector<size_t>{i}, matrix[i]);
-
-    size_t iterations = 0;
-    while (true) {
-        new_row_track_pairs.clear();
-        for (auto const& [indices, row] : row_track_pairs) {
-            auto const max_index = std::ranges::max(indices);
-            for (size_t k = max_index + 1; k < matrix.num_rows(); k++) {
-                auto const new_row         = row + matrix[k];
-                std::vector<size_t> result = indices;
-                result.emplace_back(k);
-                if (new_row.is_one_hot()) {
+        sums.push_back({SIZE_MAX, i, matrix[i]});
+
+    size_t iterations  = 0;
+    size_t layer_begin = 0;
+    while (layer_begin < sums.size()) {
+        auto const layer_end = sums.size();
+        for (size_t s = layer_begin; s < layer_end; s++) {
+            for (size_t k = sums[s].last + 1; k < matrix.num_rows(); k++) {
+                if (sums[s].row.distance(matrix[k]) == 1) {
+                    std::vector<size_t> result{k};
+                    for (auto t = s; t != SIZE_MAX; t = sums[t].parent) result.emplace_back(sums[t].last);
+                    std::ranges::reverse(result);
                     return result;
                 }
 
-                new_row_track_pairs.emplace_back(result, new_row);
+                sums.push_back({s, k, sums[s].row + matrix[k]});
                 iterations++;
             }
-            if (iterations > 100000) {
+            if (iterations > max_minimal_sum_candidates) {
                 spdlog::debug("Fallback to level 1");
                 return {};
             }
         }
-        if (new_row_track_pairs.empty())
-            return {};
-        // NOTE - update rowTrackPairs
-        row_track_pairs = new_row_track_pairs;
+        layer_begin = layer_end;
     }
+    return {};
 }
 
 /**
@@ -71,32 +83,49 @@ std::vector<dvlab::BooleanMatrix::RowOperation> Extractor::greedy_reduction(dvla
     std::vector<size_t> indices = Extractor::find_minimal_sums(matrix);
     // Return empty vector if indices do not exist
     if (indices.empty()) return result;
-    while (indices.size() > 1) {
-        dvlab::BooleanMatrix::RowOperation best_operation(-1, -1);
+
+    // the weights |a| of the rows in the sum and |a + b| of their pairs. An
+    // operation only changes the row it adds to, so only that row's weights
+    // are recomputed
+    auto const n = indices.size();
+    std::vector<long> weights(n);
+    std::vector<std::vector<long>> sum_weights(n, std::vector<long>(n, 0));
+    auto const update_weights = [&](size_t p) {
+        weights[p] = static_cast<long>(matrix[indices[p]].sum());
+        for (size_t q = 0; q < n; q++) {
+            sum_weights[p][q] = sum_weights[q][p] = static_cast<long>(matrix[indices[p]].distance(matrix[indices[q]]));
+        }
+    };
+    for (size_t p = 0; p < n; p++) update_weights(p);
+
+    // positions into `indices` of the rows not yet added away
+    std::vector<size_t> remaining(n);
+    std::iota(remaining.begin(), remaining.end(), 0);
+    while (remaining.size() > 1) {
+        std::pair<size_t, size_t> best_operation{SIZE_MAX, SIZE_MAX};
         long reduction = -1 * static_cast<long>(matrix.num_cols());
 
-        for (auto const& i : indices) {
-            for (auto const& j : indices) {
-                if (j <= i) continue;
-                auto const new_row_sum = static_cast<long>((matrix[i] + matrix[j]).sum());
-                if (int(matrix[i].sum()) - new_row_sum > reduction) {
-                    // NOTE - Add j to i
-                    best_operation.first  = j;
-                    best_operation.second = i;
-                    reduction             = static_cast<long>(matrix[i].sum()) - new_row_sum;
+        for (auto const& p : remaining) {
+            for (auto const& q : remaining) {
+                if (indices[q] <= indices[p]) continue;
+                if (weights[p] - sum_weights[p][q] > reduction) {
+                    // NOTE - Add q to p
+                    best_operation = {q, p};
+                    reduction      = weights[p] - sum_weights[p][q];
                 }
-                if (int(matrix[j].sum()) - new_row_sum > reduction) {
-                    // NOTE - Add i to j
-                    best_operation.first  = i;
-                    best_operation.second = j;
-                    reduction             = static_cast<long>(matrix[j].sum()) - new_row_sum;
+                if (weights[q] - sum_weights[p][q] > reduction) {
+                    // NOTE - Add p to q
+                    best_operation = {p, q};
+                    reduction      = weights[q] - sum_weights[p][q];
                 }
             }
         }
-        result.emplace_back(best_operation);
-        matrix[best_operation.second] = matrix[best_operation.first] + matrix[best_operation.second];
+        auto const [from, to] = best_operation;
+        result.emplace_back(indices[from], indices[to]);
+        matrix[indices[to]] += matrix[indices[from]];
 
-        std::erase(indices, best_operation.first);
+        std::erase(remaining, from);
+        update_weights(to);
     }
     return result;
 }
@@ -105,36 +134,21 @@ std::vector<dvlab::BooleanMatrix::RowOperation> Extractor::greedy_reduction(dvla
  * @brief Find two rows with max inner product and provide the corresponding column values are both 1s
  *
  * @param matrix
+ * @param overlaps the overlaps of the rows of `matrix`, kept up to date by the caller
  * @return Extractor::Overlap
  */
-Extractor::Overlap Extractor::_max_overlap(dvlab::BooleanMatrix& matrix) {
+Extractor::Overlap Extractor::_max_overlap(dvlab::BooleanMatrix const& matrix, dvlab::RowOverlaps const& overlaps) {
     DVLAB_ASSERT(matrix.num_cols() == matrix.num_rows(), "The shape of input matrix should be a square.");
 
-    size_t max_inner_product = 0;
-    std::vector<size_t> best_common_indices;
-    std::pair<size_t, size_t> overlap_rows(SIZE_MAX, SIZE_MAX);
-    for (size_t i = 0; i < matrix.num_rows(); i++) {
-        for (size_t j = i + 1; j < matrix.num_rows(); j++) {
-            size_t inner_product    = 0;
-            size_t num_ones_ith_row = 0;
-            size_t num_ones_jth_row = 0;
-            std::vector<size_t> common_indices;
-            for (size_t k = 0; k < matrix.num_cols(); k++) {
-                num_ones_ith_row += matrix[i][k];
-                num_ones_jth_row += matrix[j][k];
-
-                if (matrix[i][k] == 1 && matrix[j][k] == 1) {
-                    inner_product++;
-                    common_indices.emplace_back(k);
-                }
-            }
+    auto const best_pair = overlaps.max_overlap_pair();
+    if (!best_pair.has_value()) return {{SIZE_MAX, SIZE_MAX}, {}};
 
-            if (inner_product > max_inner_product) {
-                max_inner_product   = inner_product;
-                overlap_rows        = num_ones_ith_row < num_ones_jth_row ? std::make_pair(j, i) : std::make_pair(i, j);
-                best_common_indices = common_indices;
-            }
-        }
+    auto const [i, j]       = *best_pair;
+    auto const overlap_rows = matrix[i].sum() < matrix[j].sum() ? std::make_pair(j, i) : std::make_pair(i, j);
+    auto const common       = matrix[i] * matrix[j];
+    std::vector<size_t> best_common_indices;
+    for (size_t k = 0; k < common.size(); k++) {
+        if (common[k] == 1) best_common_indices.emplace_back(k);
     }
     return {overlap_rows, best_common_indices};
 }
@@ -0,0 +1,247 @@
+/****************************************************************************
+  PackageName  [ extractor ]
+  Synopsis     [ Define portfolio extraction ]
+  Author       [ Design Verification Lab ]
+  Copyright    [ Copyright(c) 2023 DVLab, GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#include "./portfolio.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <utility>
+
+#include "qcir/qcir_gate.hpp"
+#include "util/dvlab_string.hpp"
+#include "util/util.hpp"
+
+extern bool stop_requested();
+
+namespace qsyn::extractor {
+
+/**
+ * @brief Convert string to `PortfolioMetric`
+ *
+ * @param str
+ * @return std::optional<PortfolioMetric>
+ */
+std::optional<PortfolioMetric> str_to_portfolio_metric(std::string const& str) {
+    using dvlab::str::tolower_string;
+    if (tolower_string(str) == "2q") return PortfolioMetric::two_qubit_gates;
+    if (tolower_string(str) == "depth") return PortfolioMetric::depth;
+    if (tolower_string(str) == "gates") return PortfolioMetric::total_gates;
+    return std::nullopt;
+}
+
+/**
+ * @brief Evaluate a circuit by the metric. As extraction only adds gates,
+ *        the metric of a partially extracted circuit never exceeds that of the
+ *        final circuit.
+ *
+ * @param qcir
+ * @param metric
+ * @return size_t
+ */
+size_t evaluate_portfolio_metric(qcir::QCir const& qcir, PortfolioMetric metric) {
+    switch (metric) {
+        case PortfolioMetric::two_qubit_gates:
+            return static_cast<size_t>(std::ranges::count_if(qcir.get_gates(), [](qcir::QCirGate const* gate) { return gate->get_num_qubits() == 2; }));
+        case PortfolioMetric::depth:
+            return qcir.calculate_depth();
+        case PortfolioMetric::total_gates:
+            return qcir.get_num_gates();
+    }
+    DVLAB_UNREACHABLE("unknown portfolio metric");
+}
+
+/**
+ * @brief Evaluate the gates an extractor has extracted so far by the metric.
+ *        Agrees with evaluating the extracted circuit, but takes constant time.
+ *
+ * @param statistics
+ * @param metric
+ * @return size_t
+ */
+size_t evaluate_portfolio_metric(ExtractedGateStatistics const& statistics, PortfolioMetric metric) {
+    switch (metric) {
+        case PortfolioMetric::two_qubit_gates:
+            return statistics.num_two_qubit_gates();
+        case PortfolioMetric::depth:
+            return statistics.depth();
+        case PortfolioMetric::total_gates:
+            return statistics.num_gates();
+    }
+    DVLAB_UNREACHABLE("unknown portfolio metric");
+}
+
+namespace {
+
+enum class RunStatus {
+    pending,
+    finished,
+    failed,
+    pruned,
+    stopped,
+};
+
+}  // namespace
+
+/**
+ * @brief Extract the graph with each of the runs concurrently and return the
+ *        best circuit by the metric. Ties go to the run that comes first.
+ *
+ *        After every extraction iteration, a run compares the metric of its
+ *        partial circuit against the best finished circuit so far. Since the
+ *        metric only grows, a run that is already worse can never win, and is
+ *        cancelled. When the time budget runs out or the command is
+ *        interrupted, all unfinished runs are stopped.
+ *
+ * @param graph the graph to extract. It is copied for every run
+ * @param runs the configurations to try
+ * @param metric
+ * @param time_budget if set, the best circuit finished within this time is returned
+ * @param num_threads the number of runs that execute concurrently. 0 means one per hardware core
+ * @return std::optional<PortfolioResult>
+ */
+std::optional<PortfolioResult> portfolio_extract(
+    zx::ZXGraph const& graph,
+    std::vector<PortfolioRun> const& runs,
+    PortfolioMetric metric,
+    std::optional<std::chrono::milliseconds> time_budget,
+    size_t num_threads) {
+    if (graph.is_empty()) {
+        spdlog::error("The ZXGraph is empty!!");
+        return std::nullopt;
+    }
+    if (runs.empty()) {
+        spdlog::error("No extractor configuration to run!!");
+        return std::nullopt;
+    }
+
+    using clock_t       = std::chrono::steady_clock;
+    auto const deadline = time_budget.has_value()
+                              ? std::make_optional(clock_t::now() + *time_budget)
+                              : std::nullopt;
+
+    // copy the graphs up front so that the workers never read a shared graph
+    auto graphs       = std::vector<zx::ZXGraph>(runs.size(), graph);
+    auto circuits     = std::vector<std::unique_ptr<qcir::QCir>>(runs.size());
+    auto scores       = std::vector<size_t>(runs.size(), 0);
+    auto statuses     = std::vector<RunStatus>(runs.size(), RunStatus::pending);
+    auto stop_sources = std::vector<std::stop_source>(runs.size());
+
+    std::mutex mutex;
+    std::condition_variable run_done;
+    size_t num_done = 0;
+    std::optional<std::pair<size_t, size_t>> best;  // (score, run id) of the best finished run
+
+    // a run loses if it can no longer beat, or tie with an earlier, finished run
+    auto const loses = [&best](size_t score, size_t run_id) {
+        return best.has_value() && std::make_pair(score, run_id) > *best;
+    };
+
+    auto const execute = [&](size_t run_id) -> RunStatus {
+        auto const& [config, random] = runs[run_id];
+        auto const stop_token        = stop_sources[run_id].get_token();
+
+        auto circuit = std::make_unique<qcir::QCir>(graph.num_outputs());
+        Extractor ext(&graphs[run_id], config, circuit.get(), random);
+        ext.set_stop_token(stop_token);
+
+        while (true) {
+            if (!ext.extraction_loop(1)) return RunStatus::failed;
+            if (ext.frontier_is_empty()) break;
+            if (stop_token.stop_requested() || stop_requested()) return RunStatus::stopped;
+
+            // read the running statistics; flushing and rescanning the
+            // circuit after every iteration would be quadratic
+            auto const partial_score = evaluate_portfolio_metric(ext.get_gate_statistics(), metric);
+            std::lock_guard lock{mutex};
+            if (loses(partial_score, run_id)) return RunStatus::pruned;
+        }
+        if (config.permute_qubits) ext.permute_qubits();
+        ext.flush_gate_buffer();
+
+        auto const score = evaluate_portfolio_metric(ext.get_gate_statistics(), metric);
+        std::lock_guard lock{mutex};
+        if (loses(score, run_id)) return RunStatus::pruned;
+        best             = {score, run_id};
+        scores[run_id]   = score;
+        circuits[run_id] = std::move(circuit);
+        return RunStatus::finished;
+    };
+
+    auto next_run = std::atomic<size_t>{0};
+    {
+        auto const num_workers = std::min(
+            runs.size(),
+            num_threads == 0 ? size_t{std::max(std::thread::hardware_concurrency(), 1u)} : num_threads);
+        auto workers = std::vector<std::jthread>{};
+        workers.reserve(num_workers);
+        for (size_t i = 0; i < num_workers; ++i) {
+            workers.emplace_back([&] {
+                for (auto run_id = next_run++; run_id < runs.size(); run_id = next_run++) {
+                    auto const status = execute(run_id);
+                    std::lock_guard lock{mutex};
+                    statuses[run_id] = status;
+                    ++num_done;
+                    run_done.notify_all();
+                }
+            });
+        }
+
+        // watch the time budget and the interruption while the workers run
+        std::unique_lock lock{mutex};
+        while (num_done < runs.size()) {
+            run_done.wait_for(lock, std::chrono::milliseconds(50));
+            if (stop_requested() || (deadline.has_value() && clock_t::now() >= *deadline)) {
+                for (auto& stop_source : stop_sources) stop_source.request_stop();
+                break;
+            }
+        }
+    }  // joins the workers
+
+    for (size_t run_id = 0; run_id < runs.size(); ++run_id) {
+        switch (statuses[run_id]) {
+            case RunStatus::finished:
+                spdlog::info("Run {}: finished with score {}", run_id, scores[run_id]);
+                break;
+            case RunStatus::failed:
+                spdlog::info("Run {}: failed", run_id);
+                break;
+            case RunStatus::pruned:
+                spdlog::info("Run {}: cancelled for being worse than a finished run", run_id);
+                break;
+            case RunStatus::pending:
+            case RunStatus::stopped:
+                spdlog::info("Run {}: stopped before finishing", run_id);
+                break;
+        }
+    }
+
+    if (stop_requested()) {
+        spdlog::warn("Conversion is interrupted");
+        return std::nullopt;
+    }
+    if (!best.has_value()) {
+        spdlog::error("No extractor configuration finished{}!!", deadline.has_value() ? " within the time budget" : "");
+        return std::nullopt;
+    }
+
+    auto const [score, run_id] = *best;
+    spdlog::info("Run {} extracts the best circuit with score {}", run_id, score);
+    return PortfolioResult{
+        .circuit = std::move(circuits[run_id]),
+        .graph   = std::move(graphs[run_id]),
+        .run_id  = run_id,
+        .score   = score,
+    };
+}
+
+}  // namespace qsyn::extractor
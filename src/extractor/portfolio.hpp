@@ -0,0 +1,55 @@
+/****************************************************************************
+  PackageName  [ extractor ]
+  Synopsis     [ Define portfolio extraction, which runs several extractor
+                 configurations concurrently and keeps the best circuit ]
+  Author       [ Design Verification Lab ]
+  Copyright    [ Copyright(c) 2023 DVLab, GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "./extract.hpp"
+#include "qcir/qcir.hpp"
+#include "zx/zxgraph.hpp"
+
+namespace qsyn::extractor {
+
+enum class PortfolioMetric {
+    two_qubit_gates,
+    depth,
+    total_gates,
+};
+
+std::optional<PortfolioMetric> str_to_portfolio_metric(std::string const& str);
+
+size_t evaluate_portfolio_metric(qcir::QCir const& qcir, PortfolioMetric metric);
+size_t evaluate_portfolio_metric(ExtractedGateStatistics const& statistics, PortfolioMetric metric);
+
+struct PortfolioRun {
+    ExtractorConfig config;
+    bool random = false;  // shuffles the neighbors to the frontier
+};
+
+struct PortfolioResult {
+    std::unique_ptr<qcir::QCir> circuit;
+    zx::ZXGraph graph;  // what is left of the graph after extraction. If the winning
+                        // run does not permute qubits, this keeps the permutation
+    size_t run_id;      // the index of the winning run
+    size_t score;       // the metric of the circuit; lower is better
+};
+
+std::optional<PortfolioResult> portfolio_extract(
+    zx::ZXGraph const& graph,
+    std::vector<PortfolioRun> const& runs,
+    PortfolioMetric metric,
+    std::optional<std::chrono::milliseconds> time_budget = std::nullopt,
+    size_t num_threads                                   = 0);
+
+}  // namespace qsyn::extractor
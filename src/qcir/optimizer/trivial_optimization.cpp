@@ -228,6 +228,8 @@ std::vector<Operation> zx_optimize(std::vector<qcir::Operation> const& partial)
         .dynamic_order        = false,
         .block_size           = 1,
         .optimize_level       = 0,
+        .m4ri_elimination     = false,
+        .num_threads          = 1,
         .pred_coeff           = 0.7,
     };
 
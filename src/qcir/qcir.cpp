@@ -338,6 +338,76 @@ size_t QCir::prepend(QCirGate const& gate) {
     return prepend(gate.get_operation(), gate.get_qubits());
 }
 
+/**
+ * @brief Prepend the gates one after another, so that the last one ends up
+ *        first. The circuit and the gate IDs are the same as if prepend() were
+ *        called on each gate in turn, but the gates are linked to each other
+ *        before they enter the gate tables, and to the rest of the circuit
+ *        once per qubit.
+ *
+ * @param gates
+ */
+void QCir::prepend_all(std::span<QCirGate const> gates) {
+    if (gates.empty()) return;
+    auto const first_id = _gate_id;
+
+    // the gate index in `gates` and the pin of a gate of the block on a qubit
+    struct BlockPin {
+        size_t index;
+        size_t pin;
+    };
+    // the first and last gates of the block on each qubit, in circuit order
+    std::vector<std::optional<BlockPin>> block_first(_qubits.size());
+    std::vector<std::optional<BlockPin>> block_last(_qubits.size());
+    std::vector<std::vector<std::optional<size_t>>> predecessors(gates.size());
+    std::vector<std::vector<std::optional<size_t>>> successors(gates.size());
+
+    // walk the block in circuit order, i.e., from the last gate to prepend
+    for (size_t i = gates.size(); i-- > 0;) {
+        auto const& gate = gates[i];
+        DVLAB_ASSERT(
+            gate.get_operation().get_num_qubits() == gate.get_num_qubits(),
+            fmt::format("Operation {} requires {} qubits, but {} qubits are given.", gate.get_operation().get_repr(), gate.get_operation().get_num_qubits(), gate.get_num_qubits()));
+        predecessors[i].assign(gate.get_num_qubits(), std::nullopt);
+        successors[i].assign(gate.get_num_qubits(), std::nullopt);
+        for (size_t pin = 0; pin < gate.get_num_qubits(); ++pin) {
+            auto const qb = gate.get_qubit(pin);
+            DVLAB_ASSERT(qb < _qubits.size(), fmt::format("Qubit {} not found!!", qb));
+            if (auto const prev = block_last[qb]) {
+                predecessors[i][pin]               = first_id + prev->index;
+                successors[prev->index][prev->pin] = first_id + i;
+            } else {
+                block_first[qb] = BlockPin{i, pin};
+            }
+            block_last[qb] = BlockPin{i, pin};
+        }
+    }
+
+    // splice the block in front of the gates already on each qubit
+    for (size_t qb = 0; qb < _qubits.size(); ++qb) {
+        auto* const old_first = _qubits[qb].get_first_gate();
+        if (!block_last[qb].has_value() || old_first == nullptr) continue;
+        successors[block_last[qb]->index][block_last[qb]->pin] = old_first->get_id();
+        _set_predecessor(old_first->get_id(), *old_first->get_pin_by_qubit(qb), first_id + block_last[qb]->index);
+    }
+
+    for (size_t i = 0; i < gates.size(); ++i) {
+        _id_to_gates.emplace(first_id + i, std::make_unique<QCirGate>(first_id + i, gates[i].get_operation(), gates[i].get_qubits()));
+        _predecessors.emplace(first_id + i, std::move(predecessors[i]));
+        _successors.emplace(first_id + i, std::move(successors[i]));
+    }
+    _gate_id += gates.size();
+
+    for (size_t qb = 0; qb < _qubits.size(); ++qb) {
+        if (!block_first[qb].has_value()) continue;
+        if (_qubits[qb].get_first_gate() == nullptr) {
+            _qubits[qb].set_last_gate(_id_to_gates[first_id + block_last[qb]->index].get());
+        }
+        _qubits[qb].set_first_gate(_id_to_gates[first_id + block_first[qb]->index].get());
+    }
+    _dirty = true;
+}
+
 /**
  * @brief Remove gate
  *
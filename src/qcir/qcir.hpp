@@ -123,6 +123,7 @@ public:
     void set_gate_set(std::string g) { _gate_set = std::move(g); }
 
     void reset();
+    void reserve(size_t num_gates);
     QCir& compose(QCir const& other);
     QCir& tensor_product(QCir const& other);
     // Member functions about circuit construction
@@ -134,6 +135,7 @@ public:
     size_t prepend(Operation const& op, QubitIdList const& bits);
     size_t append(QCirGate const& gate);
     size_t prepend(QCirGate const& gate);
+    void prepend_all(std::span<QCirGate const> gates);
     bool remove_gate(size_t id);
 
     bool write_qasm(std::filesystem::path const& filepath) const;
@@ -133,6 +133,18 @@ void QCir::reset() {
     _dirty   = true;
 }
 
+/**
+ * @brief Reserve room for `num_gates` gates in total, so that adding gates up to
+ *        that number does not rehash the gate tables
+ *
+ * @param num_gates
+ */
+void QCir::reserve(size_t num_gates) {
+    _id_to_gates.reserve(num_gates);
+    _predecessors.reserve(num_gates);
+    _successors.reserve(num_gates);
+}
+
 void QCir::adjoint_inplace() {
     for (auto& g : _id_to_gates | std::views::values) {
         g->set_operation(qsyn::qcir::adjoint(g->get_operation()));
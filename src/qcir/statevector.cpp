@@ -0,0 +1,438 @@
+/****************************************************************************
+  PackageName  [ qcir ]
+  Synopsis     [ Define class Statevector member functions ]
+  Author       [ Design Verification Lab ]
+  Copyright    [ Copyright(c) 2023 DVLab, GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#include "./statevector.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <initializer_list>
+#include <new>
+#include <stdexcept>
+#include <numbers>
+#include <ranges>
+#include <thread>
+#include <tl/to.hpp>
+
+#include "qcir/basic_gate_type.hpp"
+#include "qcir/qcir.hpp"
+#include "qcir/qcir_gate.hpp"
+#include "util/phase.hpp"
+
+extern bool stop_requested();
+
+namespace qsyn::qcir {
+
+namespace {
+
+// states smaller than this are swept on the calling thread
+constexpr size_t min_parallel_sweep = size_t{1} << 14;
+
+/**
+ * @brief Get e^(i * phase). The multiples of pi/2 are exact, so that Clifford
+ *        gates do not leave rounding errors in the amplitudes.
+ *
+ * @param phase
+ * @return Statevector::Amplitude
+ */
+Statevector::Amplitude exp_i(dvlab::Phase const& phase) {
+    if (phase.denominator() <= 2) {
+        auto const quarter_turns = ((phase.numerator() * (2 / phase.denominator())) % 4 + 4) % 4;
+        constexpr auto powers_of_i = std::array<Statevector::Amplitude, 4>{{{1., 0.}, {0., 1.}, {-1., 0.}, {0., -1.}}};
+        return powers_of_i[static_cast<size_t>(quarter_turns)];
+    }
+    return std::polar(1., dvlab::Phase::phase_to_floating_point<double>(phase));
+}
+
+// the matrix of PX(phase), i.e., H * PZ(phase) * H
+Statevector::Matrix2 px_matrix(dvlab::Phase const& phase) {
+    auto const e = exp_i(phase);
+    return {(1. + e) / 2., (1. - e) / 2., (1. - e) / 2., (1. + e) / 2.};
+}
+
+// the matrix of PY(phase), i.e., S * PX(phase) * Sdg
+Statevector::Matrix2 py_matrix(dvlab::Phase const& phase) {
+    using namespace std::complex_literals;
+    auto const e = exp_i(phase);
+    return {(1. + e) / 2., -1.i * (1. - e) / 2., 1.i * (1. - e) / 2., (1. + e) / 2.};
+}
+
+Statevector::Matrix2 scaled(Statevector::Matrix2 u, Statevector::Amplitude factor) {
+    for (auto& x : u) x *= factor;
+    return u;
+}
+
+/**
+ * @brief Spread the bits of `k` over the positions not in `fixed_bits`,
+ *        leaving zeros at the fixed positions
+ *
+ * @param k
+ * @param fixed_bits the fixed positions in increasing order
+ * @return size_t
+ */
+size_t insert_zero_bits(size_t k, std::vector<size_t> const& fixed_bits) {
+    for (auto const pos : fixed_bits) {
+        auto const low_mask = (size_t{1} << pos) - 1;
+        k                   = ((k & ~low_mask) << 1) | (k & low_mask);
+    }
+    return k;
+}
+
+// the positions of the controls and the targets, in increasing order
+std::vector<size_t> get_fixed_bits(size_t ctrl_mask, std::initializer_list<QubitIdType> targets) {
+    auto fixed_bits = std::vector<size_t>(targets);
+    for (auto mask = ctrl_mask; mask != 0; mask &= mask - 1) {
+        fixed_bits.emplace_back(static_cast<size_t>(std::countr_zero(mask)));
+    }
+    std::ranges::sort(fixed_bits);
+    return fixed_bits;
+}
+
+}  // namespace
+
+Statevector::Statevector(size_t num_qubits, size_t num_threads)
+    : _num_qubits{num_qubits} {
+    // checked before shifting, which is undefined past the width of size_t
+    if (num_qubits > max_num_qubits) {
+        throw std::length_error(fmt::format("a statevector has at most {} qubits, but got {}", max_num_qubits, num_qubits));
+    }
+    _amplitudes.assign(size_t{1} << num_qubits, Amplitude{0.});
+    _amplitudes[0] = 1.;
+    if (num_threads != 1) {
+        _thread_pool = std::make_unique<dvlab::utils::thread_pool>(
+            num_threads == 0 ? size_t{std::max(std::thread::hardware_concurrency(), 1u)} : num_threads);
+    }
+}
+
+/**
+ * @brief Call `kernel(base, len)` on every run of groups. A group is the
+ *        amplitudes that differ only in the fixed bits, and `base` is the
+ *        index of its member with all targets |0> and all controls |1>. The
+ *        groups of a run have consecutive bases.
+ *
+ * @param fixed_bits the controls and the targets, in increasing order
+ * @param ctrl_mask
+ * @param kernel
+ */
+template <typename F>
+void Statevector::_sweep(std::vector<size_t> const& fixed_bits, size_t ctrl_mask, F const& kernel) {
+    auto const num_groups = size() >> fixed_bits.size();
+    // the bits below the lowest fixed bit vary fastest, so runs break only there
+    auto const run_limit = size_t{1} << fixed_bits.front();
+
+    auto const sweep_range = [&](size_t begin, size_t end) {
+        for (size_t k = begin; k < end;) {
+            auto const len = std::min(end - k, run_limit - (k & (run_limit - 1)));
+            kernel(insert_zero_bits(k, fixed_bits) | ctrl_mask, len);
+            k += len;
+        }
+    };
+
+    if (_thread_pool == nullptr || size() < min_parallel_sweep) {
+        sweep_range(0, num_groups);
+        return;
+    }
+    auto const num_blocks = std::min(num_groups, 4 * _thread_pool->num_threads());
+    auto const block_size = (num_groups + num_blocks - 1) / num_blocks;
+    _thread_pool->parallel_for(num_blocks, [&](size_t i) {
+        sweep_range(std::min(i * block_size, num_groups), std::min((i + 1) * block_size, num_groups));
+    });
+}
+
+/**
+ * @brief Apply a single-qubit gate
+ *
+ * @param u
+ * @param target
+ * @param ctrl_mask
+ */
+void Statevector::apply_matrix(Matrix2 const& u, QubitIdType target, size_t ctrl_mask) {
+    // complex arithmetic is spelled out on the real parts so that the loop vectorizes
+    auto const u00r = u[0].real(), u00i = u[0].imag();
+    auto const u01r = u[1].real(), u01i = u[1].imag();
+    auto const u10r = u[2].real(), u10i = u[2].imag();
+    auto const u11r = u[3].real(), u11i = u[3].imag();
+    auto* const data  = reinterpret_cast<double*>(_amplitudes.data());
+    auto const stride = size_t{1} << target;
+
+    _sweep(get_fixed_bits(ctrl_mask, {target}), ctrl_mask, [&](size_t base, size_t len) {
+        double* const a0 = data + 2 * base;
+        double* const a1 = data + 2 * (base + stride);
+        for (size_t j = 0; j < 2 * len; j += 2) {
+            auto const xr = a0[j], xi = a0[j + 1];
+            auto const yr = a1[j], yi = a1[j + 1];
+            a0[j]         = u00r * xr - u00i * xi + u01r * yr - u01i * yi;
+            a0[j + 1]     = u00r * xi + u00i * xr + u01r * yi + u01i * yr;
+            a1[j]         = u10r * xr - u10i * xi + u11r * yr - u11i * yi;
+            a1[j + 1]     = u10r * xi + u10i * xr + u11r * yi + u11i * yr;
+        }
+    });
+}
+
+/**
+ * @brief Apply a two-qubit gate. Row r of the matrix is the basis state
+ *        |q0 q1> with q0 = r / 2 and q1 = r % 2.
+ *
+ * @param u
+ * @param q0
+ * @param q1
+ * @param ctrl_mask
+ */
+void Statevector::apply_matrix(Matrix4 const& u, QubitIdType q0, QubitIdType q1, size_t ctrl_mask) {
+    auto ur = std::array<double, 16>{};
+    auto ui = std::array<double, 16>{};
+    for (size_t i = 0; i < 16; ++i) {
+        ur[i] = u[i].real();
+        ui[i] = u[i].imag();
+    }
+    auto const offsets = std::array<size_t, 4>{0, size_t{1} << q1, size_t{1} << q0, (size_t{1} << q0) | (size_t{1} << q1)};
+    auto* const data   = reinterpret_cast<double*>(_amplitudes.data());
+
+    _sweep(get_fixed_bits(ctrl_mask, {q0, q1}), ctrl_mask, [&](size_t base, size_t len) {
+        for (size_t j = 0; j < len; ++j) {
+            auto in_r = std::array<double, 4>{};
+            auto in_i = std::array<double, 4>{};
+            for (size_t c = 0; c < 4; ++c) {
+                in_r[c] = data[2 * (base + offsets[c] + j)];
+                in_i[c] = data[2 * (base + offsets[c] + j) + 1];
+            }
+            for (size_t r = 0; r < 4; ++r) {
+                auto out_r = 0., out_i = 0.;
+                for (size_t c = 0; c < 4; ++c) {
+                    out_r += ur[4 * r + c] * in_r[c] - ui[4 * r + c] * in_i[c];
+                    out_i += ur[4 * r + c] * in_i[c] + ui[4 * r + c] * in_r[c];
+                }
+                data[2 * (base + offsets[r] + j)]     = out_r;
+                data[2 * (base + offsets[r] + j) + 1] = out_i;
+            }
+        }
+    });
+}
+
+/**
+ * @brief Apply a single-qubit diagonal gate diag(d0, d1)
+ *
+ * @param d0
+ * @param d1
+ * @param target
+ * @param ctrl_mask
+ */
+void Statevector::apply_diagonal(Amplitude d0, Amplitude d1, QubitIdType target, size_t ctrl_mask) {
+    auto* const data  = reinterpret_cast<double*>(_amplitudes.data());
+    auto const stride = size_t{1} << target;
+
+    auto const scale = [](double* a, size_t len, Amplitude d) {
+        auto const dr = d.real(), di = d.imag();
+        for (size_t j = 0; j < 2 * len; j += 2) {
+            auto const xr = a[j], xi = a[j + 1];
+            a[j]          = dr * xr - di * xi;
+            a[j + 1]      = dr * xi + di * xr;
+        }
+    };
+
+    _sweep(get_fixed_bits(ctrl_mask, {target}), ctrl_mask, [&](size_t base, size_t len) {
+        if (d0 != Amplitude{1.}) scale(data + 2 * base, len, d0);
+        if (d1 != Amplitude{1.}) scale(data + 2 * (base + stride), len, d1);
+    });
+}
+
+/**
+ * @brief Apply an X gate, which only permutes the amplitudes
+ *
+ * @param target
+ * @param ctrl_mask
+ */
+void Statevector::apply_x(QubitIdType target, size_t ctrl_mask) {
+    auto const stride = size_t{1} << target;
+    _sweep(get_fixed_bits(ctrl_mask, {target}), ctrl_mask, [&](size_t base, size_t len) {
+        auto const first = _amplitudes.begin() + static_cast<std::ptrdiff_t>(base);
+        std::swap_ranges(first, first + static_cast<std::ptrdiff_t>(len), first + static_cast<std::ptrdiff_t>(stride));
+    });
+}
+
+/**
+ * @brief Swap two qubits
+ *
+ * @param q0
+ * @param q1
+ * @param ctrl_mask
+ */
+void Statevector::apply_swap(QubitIdType q0, QubitIdType q1, size_t ctrl_mask) {
+    auto const offset0 = size_t{1} << q0;
+    auto const offset1 = size_t{1} << q1;
+    _sweep(get_fixed_bits(ctrl_mask, {q0, q1}), ctrl_mask, [&](size_t base, size_t len) {
+        auto const first = _amplitudes.begin() + static_cast<std::ptrdiff_t>(base + offset0);
+        std::swap_ranges(first, first + static_cast<std::ptrdiff_t>(len), _amplitudes.begin() + static_cast<std::ptrdiff_t>(base + offset1));
+    });
+}
+
+/**
+ * @brief Apply an operation to the qubits. Gates without a kernel of their
+ *        own are applied through their decomposition into basic gates.
+ *
+ * @param op
+ * @param qubits
+ * @param ctrl_mask the qubits that control the whole operation
+ * @return true if the operation is applied
+ */
+bool Statevector::apply(Operation const& op, QubitIdList const& qubits, size_t ctrl_mask) {
+    using namespace std::complex_literals;
+    constexpr auto h = std::numbers::sqrt2 / 2;
+
+    if (op.is<IdGate>()) return true;
+    if (op.is<HGate>()) {
+        apply_matrix(Matrix2{h, h, h, -h}, qubits[0], ctrl_mask);
+        return true;
+    }
+    if (auto const pz = op.get_underlying_if<PZGate>()) {
+        apply_diagonal(1., exp_i(pz->get_phase()), qubits[0], ctrl_mask);
+        return true;
+    }
+    if (auto const rz = op.get_underlying_if<RZGate>()) {
+        auto const half = exp_i(rz->get_phase() / 2);
+        apply_diagonal(std::conj(half), half, qubits[0], ctrl_mask);
+        return true;
+    }
+    if (auto const px = op.get_underlying_if<PXGate>()) {
+        if (px->get_phase() == dvlab::Phase(1)) {
+            apply_x(qubits[0], ctrl_mask);
+            return true;
+        }
+        apply_matrix(px_matrix(px->get_phase()), qubits[0], ctrl_mask);
+        return true;
+    }
+    if (auto const py = op.get_underlying_if<PYGate>()) {
+        apply_matrix(py_matrix(py->get_phase()), qubits[0], ctrl_mask);
+        return true;
+    }
+    if (auto const rx = op.get_underlying_if<RXGate>()) {
+        apply_matrix(scaled(px_matrix(rx->get_phase()), std::conj(exp_i(rx->get_phase() / 2))), qubits[0], ctrl_mask);
+        return true;
+    }
+    if (auto const ry = op.get_underlying_if<RYGate>()) {
+        apply_matrix(scaled(py_matrix(ry->get_phase()), std::conj(exp_i(ry->get_phase() / 2))), qubits[0], ctrl_mask);
+        return true;
+    }
+    if (op.is<SwapGate>()) {
+        apply_swap(qubits[0], qubits[1], ctrl_mask);
+        return true;
+    }
+    if (op.is<ECRGate>()) {
+        auto const r = std::numbers::sqrt2 / 2;
+        apply_matrix(Matrix4{0., 0., r, 1.i * r,
+                             0., 0., 1.i * r, r,
+                             r, -1.i * r, 0., 0.,
+                             -1.i * r, r, 0., 0.},
+                     qubits[0], qubits[1], ctrl_mask);
+        return true;
+    }
+    if (auto const ctrl_op = op.get_underlying_if<ControlGate>()) {
+        auto const num_ctrls = ctrl_op->get_num_ctrls();
+        for (size_t i = 0; i < num_ctrls; ++i) ctrl_mask |= size_t{1} << qubits[i];
+        return apply(ctrl_op->get_target_operation(), QubitIdList(qubits.begin() + static_cast<std::ptrdiff_t>(num_ctrls), qubits.end()), ctrl_mask);
+    }
+    if (auto const sub_circuit = op.get_underlying_if<QCir>()) {
+        return apply(*sub_circuit, qubits, ctrl_mask);
+    }
+
+    auto const decomposed = to_basic_gates(op);
+    if (!decomposed.has_value() ||
+        (decomposed->get_num_gates() == 1 && decomposed->get_gates().front()->get_operation() == op)) {
+        spdlog::error("Simulating {} is not supported yet!!", op.get_repr());
+        return false;
+    }
+    return apply(*decomposed, qubits, ctrl_mask);
+}
+
+/**
+ * @brief Apply the gates of a circuit, its qubit i being qubits[i]
+ *
+ * @param qcir
+ * @param qubits
+ * @param ctrl_mask the qubits that control the whole circuit
+ * @return true if all gates are applied
+ */
+bool Statevector::apply(QCir const& qcir, QubitIdList const& qubits, size_t ctrl_mask) {
+    for (auto const* gate : qcir.get_gates()) {
+        if (stop_requested()) return false;
+        auto const gate_qubits = gate->get_qubits() |
+                                 std::views::transform([&qubits](auto q) { return qubits[q]; }) |
+                                 tl::to<QubitIdList>();
+        if (!apply(gate->get_operation(), gate_qubits, ctrl_mask)) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Measure all qubits `num_shots` times
+ *
+ * @param num_shots
+ * @param rng
+ * @return std::map<size_t, size_t> the number of times each basis state is measured
+ */
+std::map<size_t, size_t> Statevector::sample(size_t num_shots, std::mt19937_64& rng) const {
+    auto total = 0.;
+    for (auto const& a : _amplitudes) total += std::norm(a);
+
+    // sorting the draws lets one sweep over the amplitudes serve them all
+    auto dist  = std::uniform_real_distribution<double>{0., total};
+    auto draws = std::vector<double>(num_shots);
+    std::ranges::generate(draws, [&] { return dist(rng); });
+    std::ranges::sort(draws);
+
+    std::map<size_t, size_t> counts;
+    auto cumulative = 0.;
+    auto draw       = draws.begin();
+    for (size_t basis = 0; basis < size() && draw != draws.end(); ++basis) {
+        cumulative += get_probability(basis);
+        for (; draw != draws.end() && *draw < cumulative; ++draw) ++counts[basis];
+    }
+    // draws lost to rounding at the very end go to the last state with a nonzero amplitude
+    if (draw != draws.end()) {
+        auto const last = std::ranges::find_if(_amplitudes | std::views::reverse, [](auto const& a) { return a != Amplitude{0.}; });
+        counts[static_cast<size_t>(std::distance(last, _amplitudes.rend())) - 1] += static_cast<size_t>(draws.end() - draw);
+    }
+    return counts;
+}
+
+/**
+ * @brief Simulate the circuit on |0...0>
+ *
+ * @param qcir
+ * @param num_threads 0 means one per hardware core
+ * @return std::optional<Statevector> the final state, or std::nullopt if the
+ *         circuit has more than Statevector::max_num_qubits qubits, or if the
+ *         simulation fails or is interrupted
+ */
+std::optional<Statevector> simulate(QCir const& qcir, size_t num_threads) try {
+    auto const num_qubits = qcir.get_num_qubits();
+    if (num_qubits > Statevector::max_num_qubits) {
+        spdlog::error("Cannot simulate {} qubits; the limit is {}!!", num_qubits, Statevector::max_num_qubits);
+        return std::nullopt;
+    }
+    spdlog::info("Allocating {:.4f} MiB for a {}-qubit statevector...",
+                 std::ldexp(double(sizeof(Statevector::Amplitude)), static_cast<int>(num_qubits)) / double(1 << 20), num_qubits);
+
+    auto state = Statevector{num_qubits, num_threads};
+    auto const all_qubits = std::views::iota(QubitIdType{0}, num_qubits) | tl::to<QubitIdList>();
+    if (!state.apply(qcir, all_qubits)) {
+        if (stop_requested()) spdlog::error("Simulation is interrupted!!");
+        return std::nullopt;
+    }
+    return state;
+} catch (std::bad_alloc& e) {
+    spdlog::error("Memory allocation failed!!");
+    return std::nullopt;
+} catch (std::length_error& e) {
+    spdlog::error("Cannot allocate the statevector: {}!!", e.what());
+    return std::nullopt;
+}
+
+}  // namespace qsyn::qcir
@@ -0,0 +1,85 @@
+/****************************************************************************
+  PackageName  [ qcir ]
+  Synopsis     [ Define class Statevector, a statevector simulator for QCir ]
+  Author       [ Design Verification Lab ]
+  Copyright    [ Copyright(c) 2023 DVLab, GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+/********************** Summary of this data structure **********************
+ *
+ *     Statevector keeps the 2^n amplitudes of an n-qubit state and applies
+ * gates to them in place. Qubit q is bit q of the basis index, i.e., qubit 0
+ * is the least significant bit.
+ *
+ *     A k-qubit gate with c controls touches 2^k amplitudes at a time, and
+ * there are 2^(n-k-c) such groups. The groups are swept in runs of
+ * consecutive indices, each run being a plain loop over contiguous
+ * amplitudes that the compiler vectorizes. With more than one thread, the
+ * sweep is split into blocks that run on a thread pool. Small states are
+ * always swept on the calling thread.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <complex>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <optional>
+#include <random>
+#include <vector>
+
+#include "qsyn/qsyn_type.hpp"
+#include "util/thread_pool.hpp"
+
+namespace qsyn::qcir {
+
+class QCir;
+class Operation;
+
+class Statevector {
+public:
+    using Amplitude = std::complex<double>;
+    using Matrix2   = std::array<Amplitude, 4>;   // row-major
+    using Matrix4   = std::array<Amplitude, 16>;  // row-major, the first qubit being the high bit
+
+    // the most qubits a statevector may have. 2^40 amplitudes take 16 TiB,
+    // past any machine this runs on, and keep every basis index well within size_t
+    static constexpr size_t max_num_qubits = 40;
+
+    // initializes the state to |0...0>. Throws std::length_error if there are
+    // more than max_num_qubits qubits
+    explicit Statevector(size_t num_qubits, size_t num_threads = 1);
+
+    size_t get_num_qubits() const { return _num_qubits; }
+    size_t size() const { return _amplitudes.size(); }
+    std::vector<Amplitude> const& get_amplitudes() const { return _amplitudes; }
+    Amplitude get_amplitude(size_t basis) const { return _amplitudes[basis]; }
+    double get_probability(size_t basis) const { return std::norm(_amplitudes[basis]); }
+
+    std::map<size_t, size_t> sample(size_t num_shots, std::mt19937_64& rng) const;
+
+    // the controls are given as a mask of qubits that have to be |1>
+    void apply_matrix(Matrix2 const& u, QubitIdType target, size_t ctrl_mask = 0);
+    void apply_matrix(Matrix4 const& u, QubitIdType q0, QubitIdType q1, size_t ctrl_mask = 0);
+    void apply_diagonal(Amplitude d0, Amplitude d1, QubitIdType target, size_t ctrl_mask = 0);
+    void apply_x(QubitIdType target, size_t ctrl_mask = 0);
+    void apply_swap(QubitIdType q0, QubitIdType q1, size_t ctrl_mask = 0);
+
+    bool apply(Operation const& op, QubitIdList const& qubits, size_t ctrl_mask = 0);
+    bool apply(QCir const& qcir, QubitIdList const& qubits, size_t ctrl_mask = 0);
+
+private:
+    size_t _num_qubits;
+    std::vector<Amplitude> _amplitudes;
+    std::unique_ptr<dvlab::utils::thread_pool> _thread_pool;
+
+    template <typename F>
+    void _sweep(std::vector<size_t> const& fixed_bits, size_t ctrl_mask, F const& kernel);
+};
+
+std::optional<Statevector> simulate(QCir const& qcir, size_t num_threads = 1);
+
+}  // namespace qsyn::qcir
@@ -0,0 +1,291 @@
+/****************************************************************************
+  PackageName  [ tensor ]
+  Synopsis     [ Define contraction path planners for tensor networks ]
+  Author       [ Design Verification Lab ]
+  Copyright    [ Copyright(c) 2023 DVLab, GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#include "./contraction_path.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <functional>
+#include <queue>
+#include <tuple>
+#include <unordered_map>
+
+#include "util/dvlab_string.hpp"
+
+namespace qsyn::tensor {
+
+std::optional<ContractionOrder> str_to_contraction_order(std::string const& str) {
+    using dvlab::str::tolower_string;
+    if (tolower_string(str) == "topological") return ContractionOrder::topological;
+    if (tolower_string(str) == "greedy") return ContractionOrder::greedy;
+    if (tolower_string(str) == "min-fill") return ContractionOrder::min_fill;
+    return std::nullopt;
+}
+
+/**
+ * @brief Get the indices of the operand contracted from a and b. The indices
+ *        shared by a and b are summed over; the rest are those of a followed
+ *        by those of b, which is the axis order tensordot produces.
+ *
+ * @param a
+ * @param b
+ * @return IndexList
+ */
+IndexList contract_index_lists(IndexList const& a, IndexList const& b) {
+    IndexList result;
+    result.reserve(a.size() + b.size());
+    std::ranges::copy_if(a, std::back_inserter(result), [&b](size_t idx) { return std::ranges::find(b, idx) == b.end(); });
+    std::ranges::copy_if(b, std::back_inserter(result), [&a](size_t idx) { return std::ranges::find(a, idx) == a.end(); });
+    return result;
+}
+
+namespace {
+
+/**
+ * @brief Records the steps of a contraction path while keeping track of the
+ *        live operands and which operands each index is on.
+ *
+ */
+class PathBuilder {
+public:
+    explicit PathBuilder(std::vector<IndexList> const& operands)
+        : _operands{operands}, _live(operands.size(), true) {
+        for (size_t id = 0; id < _operands.size(); ++id) {
+            _path.peak_rank = std::max(_path.peak_rank, _operands[id].size());
+            for (auto const idx : _operands[id]) {
+                _owners[idx].emplace_back(id);
+                assert(_owners[idx].size() <= 2);
+            }
+        }
+    }
+
+    IndexList const& indices(size_t id) const { return _operands[id]; }
+    size_t num_operands() const { return _operands.size(); }
+    bool is_live(size_t id) const { return _live[id]; }
+
+    // the other operand with the index, if any
+    std::optional<size_t> neighbor(size_t id, size_t idx) const {
+        auto const it = _owners.find(idx);
+        if (it == _owners.end()) return std::nullopt;
+        for (auto const owner : it->second) {
+            if (owner != id) return owner;
+        }
+        return std::nullopt;
+    }
+
+    size_t contract(size_t a, size_t b) {
+        assert(a != b && _live[a] && _live[b]);
+        auto const c = _operands.size();
+        _operands.emplace_back(contract_index_lists(_operands[a], _operands[b]));
+        _live.emplace_back(true);
+        _live[a] = false;
+        _live[b] = false;
+
+        for (auto const idx : _operands[a]) {
+            if (std::ranges::find(_operands[b], idx) != _operands[b].end()) _owners.erase(idx);
+        }
+        for (auto const idx : _operands[c]) {
+            for (auto& owner : _owners[idx]) {
+                if (owner == a || owner == b) owner = c;
+            }
+        }
+
+        _path.steps.emplace_back(a, b);
+        _path.peak_rank = std::max(_path.peak_rank, _operands[c].size());
+        return c;
+    }
+
+    // join the remaining disconnected operands by tensor products, the lowest-rank ones first
+    ContractionPath finish() {
+        auto remaining = std::vector<size_t>{};
+        for (size_t id = 0; id < _operands.size(); ++id) {
+            if (_live[id]) remaining.emplace_back(id);
+        }
+        std::ranges::stable_sort(remaining, std::less{}, [this](size_t id) { return _operands[id].size(); });
+        for (size_t i = 1; i < remaining.size(); ++i) {
+            remaining[i] = contract(remaining[i - 1], remaining[i]);
+        }
+        return std::move(_path);
+    }
+
+private:
+    std::vector<IndexList> _operands;
+    std::vector<bool> _live;
+    std::unordered_map<size_t, std::vector<size_t>> _owners;
+    ContractionPath _path;
+};
+
+}  // namespace
+
+/**
+ * @brief Plan a path that absorbs the operands one by one in the given order.
+ *        An operand is contracted into every partial result it shares an
+ *        index with, or starts a new one if there is none. This is the order
+ *        the topological ZX-to-tensor mapping follows.
+ *
+ * @param operands
+ * @param order the operand ids; operands not in it are absorbed last, by id
+ * @return ContractionPath
+ */
+ContractionPath plan_sequential_contraction(std::vector<IndexList> const& operands, std::vector<size_t> const& order) {
+    auto builder  = PathBuilder{operands};
+    auto absorbed = std::vector<bool>(operands.size(), false);
+
+    auto const absorb = [&](size_t id) {
+        if (absorbed[id]) return;
+        absorbed[id] = true;
+        auto current = id;
+        while (true) {
+            auto const& indices = builder.indices(current);
+            auto const it       = std::ranges::find_if(indices, [&](size_t idx) {
+                auto const nb = builder.neighbor(current, idx);
+                return nb.has_value() && (*nb >= operands.size() || absorbed[*nb]);
+            });
+            if (it == indices.end()) break;
+            current = builder.contract(*builder.neighbor(current, *it), current);
+        }
+    };
+
+    for (auto const id : order) absorb(id);
+    for (size_t id = 0; id < operands.size(); ++id) absorb(id);
+
+    return builder.finish();
+}
+
+/**
+ * @brief Plan a path that always contracts the pair of operands sharing an
+ *        index whose contraction shrinks the network the most, i.e., the pair
+ *        minimizing size(result) - size(a) - size(b).
+ *
+ * @param operands
+ * @return ContractionPath
+ */
+ContractionPath plan_greedy_contraction(std::vector<IndexList> const& operands) {
+    auto builder = PathBuilder{operands};
+
+    // (cost, rank of the result, a, b); ties go to the lower ids so the path is deterministic
+    using Candidate = std::tuple<double, size_t, size_t, size_t>;
+    auto candidates = std::priority_queue<Candidate, std::vector<Candidate>, std::greater<>>{};
+
+    auto const push_candidates = [&](size_t id) {
+        for (auto const idx : builder.indices(id)) {
+            auto const nb = builder.neighbor(id, idx);
+            if (!nb.has_value()) continue;
+            auto const a    = std::min(id, *nb);
+            auto const b    = std::max(id, *nb);
+            auto const rank = contract_index_lists(builder.indices(a), builder.indices(b)).size();
+            auto const cost = std::ldexp(1., static_cast<int>(rank)) -
+                              std::ldexp(1., static_cast<int>(builder.indices(a).size())) -
+                              std::ldexp(1., static_cast<int>(builder.indices(b).size()));
+            candidates.emplace(cost, rank, a, b);
+        }
+    };
+
+    for (size_t id = 0; id < operands.size(); ++id) push_candidates(id);
+
+    while (!candidates.empty()) {
+        auto const [cost, rank, a, b] = candidates.top();
+        candidates.pop();
+        if (!builder.is_live(a) || !builder.is_live(b)) continue;
+        push_candidates(builder.contract(a, b));
+    }
+
+    return builder.finish();
+}
+
+/**
+ * @brief Plan a path from a min-fill elimination order of the line graph of
+ *        the network, whose vertices are the indices and whose edges join the
+ *        indices on a common operand. Eliminating an index contracts the two
+ *        operands it joins, and the fill-in is the number of index pairs that
+ *        first come to share an operand. The widest operand along the path is
+ *        then bounded by the width of the tree decomposition this order gives.
+ *
+ *        The candidate pairs are kept in a priority queue keyed on the
+ *        fill-in. After a contraction, only the pairs around the new operand
+ *        are rescored; the entries they replace are skipped when popped.
+ *
+ * @param operands
+ * @return ContractionPath
+ */
+ContractionPath plan_min_fill_contraction(std::vector<IndexList> const& operands) {
+    auto builder = PathBuilder{operands};
+
+    auto const fill_in = [&builder](size_t a, size_t b) {
+        auto const& a_indices = builder.indices(a);
+        auto const& b_indices = builder.indices(b);
+        // the indices of a, b not shared between them, by the operand on their other end
+        auto a_neighbors = std::unordered_map<size_t, size_t>{};
+        size_t num_a_only = 0, num_b_only = 0, num_adjacent = 0;
+        for (auto const idx : a_indices) {
+            if (std::ranges::find(b_indices, idx) != b_indices.end()) continue;
+            ++num_a_only;
+            if (auto const nb = builder.neighbor(a, idx); nb.has_value()) ++a_neighbors[*nb];
+        }
+        for (auto const idx : b_indices) {
+            if (std::ranges::find(a_indices, idx) != a_indices.end()) continue;
+            ++num_b_only;
+            if (auto const nb = builder.neighbor(b, idx); nb.has_value() && a_neighbors.contains(*nb)) {
+                num_adjacent += a_neighbors[*nb];
+            }
+        }
+        return num_a_only * num_b_only - num_adjacent;
+    };
+
+    // (fill-in, rank of the result, a, b, stamp of a, stamp of b); ties go to
+    // the lower ids. An entry is stale once a or b is contracted or restamped
+    using Candidate = std::tuple<size_t, size_t, size_t, size_t, size_t, size_t>;
+    auto candidates = std::priority_queue<Candidate, std::vector<Candidate>, std::greater<>>{};
+    auto stamps     = std::vector<size_t>(operands.size(), 0);
+    auto clock      = size_t{0};
+
+    auto const push_candidate = [&](size_t a, size_t b) {
+        if (a > b) std::swap(a, b);
+        candidates.emplace(
+            fill_in(a, b),
+            contract_index_lists(builder.indices(a), builder.indices(b)).size(),
+            a, b, stamps[a], stamps[b]);
+    };
+
+    for (size_t a = 0; a < operands.size(); ++a) {
+        for (auto const idx : builder.indices(a)) {
+            if (auto const b = builder.neighbor(a, idx); b.has_value() && *b > a) push_candidate(a, *b);
+        }
+    }
+
+    while (!candidates.empty()) {
+        auto const [fill, rank, a, b, a_stamp, b_stamp] = candidates.top();
+        candidates.pop();
+        if (!builder.is_live(a) || !builder.is_live(b) || stamps[a] != a_stamp || stamps[b] != b_stamp) continue;
+
+        // contracting a and b only changes the fill-in of the pairs with an
+        // end on the new operand or on one of its neighbors
+        auto const c = builder.contract(a, b);
+        auto touched = std::vector<size_t>{c};
+        for (auto const idx : builder.indices(c)) {
+            if (auto const nb = builder.neighbor(c, idx); nb.has_value() && std::ranges::find(touched, *nb) == touched.end()) {
+                touched.emplace_back(*nb);
+            }
+        }
+        stamps.resize(builder.num_operands(), 0);
+        for (auto const id : touched) stamps[id] = ++clock;
+        for (auto const id : touched) {
+            for (auto const idx : builder.indices(id)) {
+                auto const nb = builder.neighbor(id, idx);
+                if (!nb.has_value()) continue;
+                // a pair of touched operands is pushed from its lower end only
+                if (*nb < id && std::ranges::find(touched, *nb) != touched.end()) continue;
+                push_candidate(id, *nb);
+            }
+        }
+    }
+
+    return builder.finish();
+}
+
+}  // namespace qsyn::tensor
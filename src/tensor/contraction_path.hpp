@@ -0,0 +1,48 @@
+/****************************************************************************
+  PackageName  [ tensor ]
+  Synopsis     [ Define contraction path planners for tensor networks ]
+  Author       [ Design Verification Lab ]
+  Copyright    [ Copyright(c) 2023 DVLab, GIEE, NTU, Taiwan ]
+****************************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace qsyn::tensor {
+
+// The index labels on the axes of an operand of a tensor network. Every
+// index is shared by at most two operands; an index on only one operand is
+// an open index of the network. All indices are of dimension 2.
+using IndexList = std::vector<size_t>;
+
+enum class ContractionOrder {
+    topological,  // absorb the operands one by one in a given order. The default of
+                  // to_tensor, which runs it on the frontier mapper rather than the planned path
+    greedy,       // contract the pair that shrinks the network the most first
+    min_fill,     // eliminate the indices in a min-fill order of the line graph
+};
+
+std::optional<ContractionOrder> str_to_contraction_order(std::string const& str);
+
+/**
+ * @brief A contraction path of a network of n operands. The operands are
+ *        numbered 0 to n-1, and the i-th step contracts two live operands
+ *        into the operand n+i. The last step leaves a single operand.
+ *
+ */
+struct ContractionPath {
+    std::vector<std::pair<size_t, size_t>> steps;
+    size_t peak_rank = 0;  // the most indices on any operand, the inputs included
+};
+
+IndexList contract_index_lists(IndexList const& a, IndexList const& b);
+
+ContractionPath plan_sequential_contraction(std::vector<IndexList> const& operands, std::vector<size_t> const& order);
+ContractionPath plan_greedy_contraction(std::vector<IndexList> const& operands);
+ContractionPath plan_min_fill_contraction(std::vector<IndexList> const& operands);
+
+}  // namespace qsyn::tensor
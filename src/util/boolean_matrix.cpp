@@ -7,9 +7,13 @@
 
 #include "./boolean_matrix.hpp"
 
+#include <algorithm>
+#include <bit>
 #include <cassert>
 #include <cmath>
 #include <gsl/util>
+#include <optional>
+#include <ranges>
 #include <tl/enumerate.hpp>
 #include <unordered_map>
 #include <utility>
@@ -36,7 +40,65 @@ size_t BooleanMatrixRowHash::operator()(std::vector<unsigned char> const& k) con
 }
 
 size_t BooleanMatrixRowHash::operator()(BooleanMatrix::Row const& k) const {
-    return operator()(k.get_row());
+    size_t ret = std::hash<size_t>()(k.size());
+    for (auto const& word : k.get_words()) {
+        ret ^= std::hash<BooleanMatrix::Row::word_type>()(word) + 0x9e3779b97f4a7c15 + (ret << 6) + (ret >> 2);
+    }
+    return ret;
+}
+
+BooleanMatrix::Row::Row(std::vector<unsigned char> const& r) : _words(_num_words(r.size()), 0), _size(r.size()) {
+    for (size_t i = 0; i < r.size(); ++i) {
+        if (r[i] % 2) (*this)[i] = 1;
+    }
+}
+
+BooleanMatrix::Row::Row(size_t size, unsigned char val) : _words(_num_words(size), (val % 2) ? ~word_type{0} : word_type{0}), _size(size) {
+    _clear_padding();
+}
+
+/**
+ * @brief Zero out the bits past the end of the row in the last word, so that
+ *        word-wise comparisons and popcounts only see the entries of the row.
+ *
+ */
+void BooleanMatrix::Row::_clear_padding() {
+    if (_size % word_bits != 0) {
+        _words.back() &= (word_type{1} << (_size % word_bits)) - 1;
+    }
+}
+
+/**
+ * @brief Append an entry to the end of the row
+ *
+ * @param i
+ */
+void BooleanMatrix::Row::emplace_back(unsigned char i) {
+    if (_size % word_bits == 0) _words.emplace_back(0);
+    ++_size;
+    (*this)[_size - 1] = i;
+}
+
+/**
+ * @brief Get the entries [begin, end) of the row as a new row
+ *
+ * @param begin
+ * @param end
+ * @return Row
+ */
+BooleanMatrix::Row BooleanMatrix::Row::sub_row(size_t begin, size_t end) const {
+    assert(begin <= end && end <= _size);
+    auto ret          = Row(end - begin);
+    auto const offset = begin % word_bits;
+    for (size_t i = 0; i < ret._words.size(); ++i) {
+        auto const w = begin / word_bits + i;
+        ret._words[i] = _words[w] >> offset;
+        if (offset != 0 && w + 1 < _words.size()) {
+            ret._words[i] |= _words[w + 1] << (word_bits - offset);
+        }
+    }
+    ret._clear_padding();
+    return ret;
 }
 
 /**
@@ -73,9 +135,9 @@ BooleanMatrix::Row operator*(BooleanMatrix::Row lhs, BooleanMatrix::Row const& r
  * @return Row&
  */
 BooleanMatrix::Row& BooleanMatrix::Row::operator+=(Row const& rhs) {
-    assert(_row.size() == rhs._row.size());
-    for (size_t i = 0; i < _row.size(); i++) {
-        _row[i] = (_row[i] + rhs._row[i]) % 2;
+    assert(_size == rhs._size);
+    for (size_t i = 0; i < _words.size(); i++) {
+        _words[i] ^= rhs._words[i];
     }
     return *this;
 }
@@ -87,16 +149,14 @@ BooleanMatrix::Row& BooleanMatrix::Row::operator+=(Row const& rhs) {
  * @return Row&
  */
 BooleanMatrix::Row& BooleanMatrix::Row::operator*=(unsigned char const& rhs) {
-    for (size_t i = 0; i < _row.size(); i++) {
-        _row[i] = (_row[i] * rhs) % 2;
-    }
+    if (rhs % 2 == 0) std::ranges::fill(_words, 0);
     return *this;
 }
 
 BooleanMatrix::Row& BooleanMatrix::Row::operator*=(Row const& rhs) {
-    assert(_row.size() == rhs._row.size());
-    for (size_t i = 0; i < _row.size(); i++) {
-        _row[i] = (_row[i] * rhs._row[i]) % 2;
+    assert(_size == rhs._size);
+    for (size_t i = 0; i < _words.size(); i++) {
+        _words[i] &= rhs._words[i];
     }
     return *this;
 }
@@ -106,7 +166,7 @@ BooleanMatrix::Row& BooleanMatrix::Row::operator*=(Row const& rhs) {
  *
  */
 void BooleanMatrix::Row::print_row(spdlog::level::level_enum lvl) const {
-    spdlog::log(lvl, "{}", fmt::join(_row, " "));
+    spdlog::log(lvl, "{}", fmt::join(*this, " "));
 }
 
 /**
@@ -116,10 +176,13 @@ void BooleanMatrix::Row::print_row(spdlog::level::level_enum lvl) const {
  * @return false
  */
 bool BooleanMatrix::Row::is_one_hot() const {
-    // we don't use count_if here because we want to stop early if we find a second 1
-    auto first_one = std::ranges::find(_row, 1);
-    if (first_one == _row.end()) return false;
-    return std::ranges::find(first_one + 1, _row.end(), 1) == _row.end();
+    // we don't use sum() here because we want to stop early if we find a second 1
+    size_t count = 0;
+    for (auto const& word : _words) {
+        count += std::popcount(word);
+        if (count > 1) return false;
+    }
+    return count == 1;
 }
 
 /**
@@ -129,7 +192,7 @@ bool BooleanMatrix::Row::is_one_hot() const {
  * @return false
  */
 bool BooleanMatrix::Row::is_zeros() const {
-    return std::ranges::none_of(_row, [](unsigned char const& e) { return e == 1; });
+    return std::ranges::all_of(_words, [](word_type const& word) { return word == 0; });
 }
 
 /**
@@ -139,14 +202,43 @@ bool BooleanMatrix::Row::is_zeros() const {
  */
 size_t BooleanMatrix::Row::sum() const {
     size_t sum = 0;
-    for (auto& i : _row) {
-        if (i == 1) {
-            ++sum;
-        }
+    for (auto const& word : _words) {
+        sum += std::popcount(word);
     }
     return sum;
 }
 
+/**
+ * @brief Count the entries that are 1 in both rows
+ *
+ * @param rhs
+ * @return size_t
+ */
+size_t BooleanMatrix::Row::overlap(Row const& rhs) const {
+    assert(_size == rhs._size);
+    size_t count = 0;
+    for (auto const& [lhs_word, rhs_word] : tl::views::zip(_words, rhs._words)) {
+        count += std::popcount(lhs_word & rhs_word);
+    }
+    return count;
+}
+
+/**
+ * @brief Count the entries where the rows differ, i.e., the sum of the row
+ *        they add up to, without building it
+ *
+ * @param rhs
+ * @return size_t
+ */
+size_t BooleanMatrix::Row::distance(Row const& rhs) const {
+    assert(_size == rhs._size);
+    size_t count = 0;
+    for (auto const& [lhs_word, rhs_word] : tl::views::zip(_words, rhs._words)) {
+        count += std::popcount(lhs_word ^ rhs_word);
+    }
+    return count;
+}
+
 /**
  * @brief Clear matrix and operations
  *
@@ -205,19 +297,13 @@ size_t BooleanMatrix::gaussian_elimination_skip(size_t block_size, bool do_fully
         return std::make_pair(section_begin, section_end);
     };
 
-    auto const get_sub_vec = [this](size_t row_idx, size_t section_begin, size_t section_end) {
-        auto row_begin = dvlab::iterator::next(_matrix[row_idx].get_row().begin(), section_begin);
-        auto row_end   = dvlab::iterator::next(_matrix[row_idx].get_row().begin(), section_end);
-        // NOTE - not all vector, only consider [row_begin, row_end)
-        return std::vector<unsigned char>(row_begin, row_end);
-    };
-
-    auto const clear_section_duplicates = [this, get_sub_vec, track](size_t section_begin, size_t section_end, auto row_range) {
-        std::unordered_map<std::vector<unsigned char>, size_t, BooleanMatrixRowHash> duplicated;
+    auto const clear_section_duplicates = [this, track](size_t section_begin, size_t section_end, auto row_range) {
+        std::unordered_map<Row, size_t, BooleanMatrixRowHash> duplicated;
         for (auto row_idx : row_range) {
-            auto sub_vec = get_sub_vec(row_idx, section_begin, section_end);
+            // NOTE - not all row, only consider [section_begin, section_end)
+            auto sub_vec = _matrix[row_idx].sub_row(section_begin, section_end);
 
-            if (std::ranges::all_of(sub_vec, [](unsigned char const& e) { return e == 0; })) continue;
+            if (sub_vec.is_zeros()) continue;
 
             if (duplicated.contains(sub_vec)) {
                 row_operation(duplicated[sub_vec], row_idx, track);
@@ -229,7 +315,7 @@ size_t BooleanMatrix::gaussian_elimination_skip(size_t block_size, bool do_fully
 
     auto const clear_all_1s_in_column = [this, track](size_t pivot_row_idx, size_t col_idx, auto row_range) {
         auto rows_to_clear = row_range | std::views::filter([this, col_idx](size_t row_idx) -> bool {
-                                 return _matrix[row_idx][col_idx] == 1;
+                                 return std::as_const(_matrix[row_idx])[col_idx] == 1;
                              });
         std::ranges::for_each(rows_to_clear, [this, pivot_row_idx, track](size_t row_idx) { row_operation(pivot_row_idx, row_idx, track); });
     };
@@ -290,6 +376,142 @@ size_t BooleanMatrix::gaussian_elimination_skip(size_t block_size, bool do_fully
     return rank;
 }
 
+/**
+ * @brief Perform Gaussian elimination with the Method of Four Russians (M4RI).
+ *        Columns are processed in blocks of `block_size`. Within a block, the
+ *        pivot rows are found and reduced against each other; every other row
+ *        is then cleared on the pivot columns of the block by XOR-ing a single
+ *        combination of the pivot rows, looked up from a table built in Gray-
+ *        code order, or a row of the same pattern. The row operations are
+ *        still recorded one at a time, so the track has the same form as that
+ *        of `gaussian_elimination_skip`.
+ *
+ * @param block_size the number of columns per block; clamped to `max_m4ri_block_size`
+ * @param do_fully_reduced if true, performing back-substitution from the echelon form
+ * @param track if true, record the process to operation track
+ * @return size_t (rank)
+ */
+size_t BooleanMatrix::gaussian_elimination_m4ri(size_t block_size, bool do_fully_reduced, bool track) {
+    block_size = std::clamp<size_t>(block_size, 1, max_m4ri_block_size);
+
+    struct Block {
+        size_t first_row;               // the pivot rows of the block are [first_row, first_row + pivot_cols.size())
+        std::vector<size_t> pivot_cols;
+    };
+
+    // the pivot rows to add to `row_idx` to clear its pivot columns of the block, as a bitmask
+    auto const get_pattern = [this](size_t row_idx, Block const& block) {
+        size_t pattern = 0;
+        for (auto const& [i, col] : tl::views::enumerate(block.pivot_cols)) {
+            pattern |= size_t{std::as_const(_matrix[row_idx])[col]} << i;
+        }
+        return pattern;
+    };
+
+    auto const track_pattern = [this, track](size_t row_idx, size_t pattern, Block const& block) {
+        if (!track) return;
+        for (; pattern != 0; pattern &= pattern - 1) {
+            _row_operations.emplace_back(block.first_row + std::countr_zero(pattern), row_idx);
+        }
+    };
+
+    // all 2^n combinations of the n pivot rows, each built from the previous one with a single row addition
+    auto const make_table = [this](Block const& block) {
+        auto table = std::vector<Row>(size_t{1} << block.pivot_cols.size(), Row(num_cols()));
+        for (size_t g = 1; g < table.size(); ++g) {
+            auto const prev = (g - 1) ^ ((g - 1) >> 1);
+            auto const curr = g ^ (g >> 1);
+            table[curr]     = table[prev];
+            table[curr] += _matrix[block.first_row + std::countr_zero(prev ^ curr)];
+        }
+        return table;
+    };
+
+    // Rows below the pivots that share a pattern are cleared by adding the
+    // first of them, as `gaussian_elimination_skip` does with duplicate
+    // sections. This is not done above the pivots, where the first row would
+    // bring its own pivot along.
+    auto const clear_pivot_columns = [&](Block const& block, size_t row_begin, size_t row_end, bool share_patterns) {
+        auto const table        = make_table(block);
+        auto first_with_pattern = std::vector<std::optional<size_t>>(table.size());
+        for (auto row_idx : std::views::iota(row_begin, row_end)) {
+            auto const pattern = get_pattern(row_idx, block);
+            if (pattern == 0) continue;
+            if (share_patterns && first_with_pattern[pattern].has_value()) {
+                row_operation(*first_with_pattern[pattern], row_idx, track);
+            } else if (share_patterns) {
+                first_with_pattern[pattern] = row_idx;
+            } else {
+                _matrix[row_idx] += table[pattern];
+                track_pattern(row_idx, pattern, block);
+            }
+        }
+        for (auto const& [pattern, row_idx] : tl::views::enumerate(first_with_pattern)) {
+            if (!row_idx.has_value()) continue;
+            _matrix[*row_idx] += table[pattern];
+            track_pattern(*row_idx, pattern, block);
+        }
+    };
+
+    std::vector<Block> blocks;
+    size_t rank = 0;
+
+    for (size_t block_begin = 0; block_begin < num_cols() && rank < num_rows(); block_begin += block_size) {
+        auto const block_end = std::min(num_cols(), block_begin + block_size);
+        auto block           = Block{rank, {}};
+
+        for (auto col_idx : std::views::iota(block_begin, block_end)) {
+            auto const pivot_row_idx = rank + block.pivot_cols.size();
+            if (pivot_row_idx >= num_rows()) break;
+
+            // rows are only cleared on the earlier pivot columns of the block as they are scanned
+            std::optional<size_t> row_with_one;
+            for (auto row_idx : std::views::iota(pivot_row_idx, num_rows())) {
+                auto const pattern = get_pattern(row_idx, block);
+                for (auto p = pattern; p != 0; p &= p - 1) {
+                    _matrix[row_idx] += _matrix[block.first_row + std::countr_zero(p)];
+                }
+                track_pattern(row_idx, pattern, block);
+                if (std::as_const(_matrix[row_idx])[col_idx] == 1) {
+                    row_with_one = row_idx;
+                    break;
+                }
+            }
+            if (!row_with_one.has_value()) continue;
+
+            // ensures that the pivot row has a 1 in the current column
+            if (*row_with_one != pivot_row_idx) {
+                row_operation(*row_with_one, pivot_row_idx, track);
+            }
+
+            // keeps the pivot rows of the block reduced against each other
+            for (auto const i : std::views::iota(block.first_row, pivot_row_idx)) {
+                if (std::as_const(_matrix[i])[col_idx] == 1) {
+                    row_operation(pivot_row_idx, i, track);
+                }
+            }
+
+            block.pivot_cols.emplace_back(col_idx);
+        }
+
+        if (block.pivot_cols.empty()) continue;
+
+        rank += block.pivot_cols.size();
+        clear_pivot_columns(block, rank, num_rows(), true);
+        blocks.emplace_back(std::move(block));
+    }
+
+    // NOTE - at this point the matrix is in row echelon form
+
+    if (!do_fully_reduced) return rank;
+
+    for (auto const& block : blocks | std::views::reverse) {
+        clear_pivot_columns(block, 0, block.first_row, false);
+    }
+
+    return rank;
+}
+
 size_t BooleanMatrix::matrix_rank() const {
     auto copy = *this;
     return copy.gaussian_elimination_skip(num_cols(), false, false);
@@ -434,11 +656,7 @@ void BooleanMatrix::push_zeros_column() {
 }
 
 bool BooleanMatrix::Row::operator==(Row const& rhs) const {
-    if (_row.size() != rhs._row.size()) return false;
-    for (size_t i = 0; i < _row.size(); i++) {
-        if (_row[i] != rhs._row[i]) return false;
-    }
-    return true;
+    return _size == rhs._size && _words == rhs._words;
 }
 
 dvlab::BooleanMatrix vstack(dvlab::BooleanMatrix const& a, dvlab::BooleanMatrix const& b) {
@@ -463,22 +681,20 @@ dvlab::BooleanMatrix hstack(dvlab::BooleanMatrix const& a, dvlab::BooleanMatrix
     auto ret = dvlab::BooleanMatrix();
     ret.reserve(a.num_rows(), a.num_cols() + b.num_cols());
     for (size_t i = 0; i < a.num_rows(); i++) {
-        auto row = a.get_row(i).get_row();
-        row.insert(row.end(), b.get_row(i).get_row().begin(), b.get_row(i).get_row().end());
-        ret.push_row(row);
+        auto row = a.get_row(i);
+        row.reserve(a.num_cols() + b.num_cols());
+        for (auto const bit : b.get_row(i)) row.emplace_back(bit);
+        ret.push_row(std::move(row));
     }
     return ret;
 }
 
 dvlab::BooleanMatrix transpose(dvlab::BooleanMatrix const& matrix) {
-    auto ret = dvlab::BooleanMatrix();
-    ret.reserve(matrix.num_cols(), matrix.num_rows());
-    for (size_t i = 0; i < matrix.num_cols(); i++) {
-        std::vector<unsigned char> row;
-        for (size_t j = 0; j < matrix.num_rows(); j++) {
-            row.push_back(matrix.get_row(j).get_row()[i]);
+    auto ret = dvlab::BooleanMatrix(matrix.num_cols(), matrix.num_rows());
+    for (size_t j = 0; j < matrix.num_rows(); j++) {
+        for (size_t i = 0; i < matrix.num_cols(); i++) {
+            if (matrix[j][i] == 1) ret[i][j] = 1;
         }
-        ret.push_row(row);
     }
     return ret;
 }
@@ -492,4 +708,95 @@ dvlab::BooleanMatrix identity(size_t size) {
     return ret;
 }
 
+/**
+ * @brief Compute the overlaps of all pairs of rows of the matrix
+ *
+ * @param matrix
+ */
+RowOverlaps::RowOverlaps(BooleanMatrix const& matrix)
+    : _overlaps(matrix.num_rows(), std::vector<size_t>(matrix.num_rows(), 0)),
+      _best_partners(matrix.num_rows()) {
+    for (size_t i = 0; i < matrix.num_rows(); ++i) {
+        for (size_t j = i + 1; j < matrix.num_rows(); ++j) {
+            _overlaps[i][j] = _overlaps[j][i] = matrix[i].overlap(matrix[j]);
+        }
+    }
+    for (size_t i = 0; i < matrix.num_rows(); ++i) {
+        _find_best_partner(i);
+    }
+}
+
+/**
+ * @brief Get the pair of rows with the largest overlap. Ties are broken in
+ *        favor of the lexicographically smaller pair.
+ *
+ * @return std::optional<std::pair<size_t, size_t>> : the rows, in increasing
+ *         order, or std::nullopt if no two rows overlap
+ */
+std::optional<std::pair<size_t, size_t>> RowOverlaps::max_overlap_pair() const {
+    // The smallest pair (i, j) of the largest overlap is the pick of row i,
+    // as a partner k < i would make (k, i) a smaller pair.
+    std::optional<std::pair<size_t, size_t>> ret;
+    size_t max_overlap = 0;
+    for (auto const& [i, partner] : tl::views::enumerate(_best_partners)) {
+        if (partner.overlap > max_overlap && i < partner.row) {
+            max_overlap = partner.overlap;
+            ret         = std::make_pair(i, partner.row);
+        }
+    }
+    return ret;
+}
+
+/**
+ * @brief Recompute the overlaps involving `rows` after they have been changed
+ *        in `matrix`
+ *
+ * @param matrix
+ * @param rows
+ */
+void RowOverlaps::update_rows(BooleanMatrix const& matrix, std::vector<size_t> const& rows) {
+    std::vector<bool> changed(matrix.num_rows(), false);
+    for (auto const& i : rows) changed[i] = true;
+
+    for (size_t i = 0; i < matrix.num_rows(); ++i) {
+        if (!changed[i]) continue;
+        for (size_t j = 0; j < matrix.num_rows(); ++j) {
+            // overlaps between two changed rows are computed only once
+            if (j == i || (changed[j] && j < i)) continue;
+            _overlaps[i][j] = _overlaps[j][i] = matrix[i].overlap(matrix[j]);
+        }
+    }
+
+    for (size_t i = 0; i < matrix.num_rows(); ++i) {
+        auto& partner = _best_partners[i];
+        if (changed[i] || (partner.row != SIZE_MAX && changed[partner.row])) {
+            _find_best_partner(i);
+            continue;
+        }
+        // otherwise, only the changed rows may take over as the best partner
+        for (auto const& j : rows) {
+            auto const overlap = _overlaps[i][j];
+            if (overlap > partner.overlap || (overlap == partner.overlap && overlap > 0 && j < partner.row)) {
+                partner = {overlap, j};
+            }
+        }
+    }
+}
+
+/**
+ * @brief Scan the overlaps of `row` for its best partner, i.e., the row with
+ *        the largest overlap, ties broken by the smaller index
+ *
+ * @param row
+ */
+void RowOverlaps::_find_best_partner(size_t row) {
+    auto& partner = _best_partners[row];
+    partner       = Partner{};
+    for (auto const& [j, overlap] : tl::views::enumerate(_overlaps[row])) {
+        if (j != row && overlap > partner.overlap) {
+            partner = {overlap, j};
+        }
+    }
+}
+
 }  // namespace dvlab
@@ -10,6 +10,11 @@
 #include <spdlog/spdlog.h>
 
 #include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <ranges>
 #include <tl/zip.hpp>
 #include <utility>
 #include <vector>
@@ -24,29 +29,112 @@ namespace dvlab {
 
 class BooleanMatrix {
 public:
+    /**
+     * @brief A row of a boolean matrix. Entries are bit-packed into 64-bit
+     *        words, so row additions and popcounts process 64 entries at a
+     *        time. Bits past `size()` in the last word are kept zero.
+     *
+     */
     class Row {
     public:
-        Row(std::vector<unsigned char> const& r) : _row(r) {}
-        Row(size_t size, unsigned char val) : _row(size, val) {}
-        Row(size_t size) : _row(size, 0) {}
-
-        std::vector<unsigned char> const& get_row() const { return _row; }
-        void set_row(std::vector<unsigned char> row) { _row = std::move(row); }
-        size_t size() const { return _row.size(); }
-        unsigned char& back() { return _row.back(); }
-        unsigned char const& back() const { return _row.back(); }
+        using word_type                  = std::uint64_t;
+        static constexpr size_t word_bits = std::numeric_limits<word_type>::digits;
+
+        /**
+         * @brief A proxy to a single entry of the row, as std::vector<bool>::reference.
+         *        Assigning or adding an integer takes it modulo 2.
+         *
+         */
+        class reference {
+        public:
+            reference(word_type& word, word_type mask) : _word(word), _mask(mask) {}
+            reference(reference const& other) = default;
+            ~reference()                      = default;
+
+            operator unsigned char() const { return (_word & _mask) ? 1 : 0; }  // NOLINT(hicpp-explicit-conversions) : mimics a reference to unsigned char
+
+            reference& operator=(unsigned char val) {
+                if (val % 2) {
+                    _word |= _mask;
+                } else {
+                    _word &= ~_mask;
+                }
+                return *this;
+            }
+            reference& operator=(reference const& other) { return *this = static_cast<unsigned char>(other); }  // NOLINT(cert-oop54-cpp) : self-assignment is harmless
+            reference& operator+=(unsigned char val) {
+                if (val % 2) _word ^= _mask;
+                return *this;
+            }
+            reference& operator^=(unsigned char val) { return *this += val; }
+
+        private:
+            word_type& _word;
+            word_type _mask;
+        };
+
+        class const_iterator {
+        public:
+            using value_type        = unsigned char;
+            using difference_type   = std::ptrdiff_t;
+            using iterator_category = std::bidirectional_iterator_tag;
+
+            const_iterator() = default;
+            const_iterator(Row const* row, size_t idx) : _row(row), _idx(idx) {}
+
+            unsigned char operator*() const { return (*_row)[_idx]; }
+
+            const_iterator& operator++() {
+                ++_idx;
+                return *this;
+            }
+            const_iterator operator++(int) {
+                auto tmp = *this;
+                ++_idx;
+                return tmp;
+            }
+            const_iterator& operator--() {
+                --_idx;
+                return *this;
+            }
+            const_iterator operator--(int) {
+                auto tmp = *this;
+                --_idx;
+                return tmp;
+            }
+
+            bool operator==(const_iterator const& rhs) const { return _idx == rhs._idx; }
+            bool operator!=(const_iterator const& rhs) const { return _idx != rhs._idx; }
+
+        private:
+            Row const* _row = nullptr;
+            size_t _idx     = 0;
+        };
+
+        Row(std::vector<unsigned char> const& r);
+        Row(size_t size, unsigned char val);
+        Row(size_t size) : _words(_num_words(size), 0), _size(size) {}
+
+        std::vector<unsigned char> get_row() const { return std::vector<unsigned char>(begin(), end()); }
+        void set_row(std::vector<unsigned char> const& row) { *this = Row(row); }
+        std::vector<word_type> const& get_words() const { return _words; }
+        size_t size() const { return _size; }
+        reference back() { return (*this)[_size - 1]; }
+        unsigned char back() const { return (*this)[_size - 1]; }
         size_t sum() const;
+        size_t overlap(Row const& rhs) const;
+        size_t distance(Row const& rhs) const;
 
         bool is_one_hot() const;
         bool is_zeros() const;
         void print_row(spdlog::level::level_enum lvl = spdlog::level::level_enum::off) const;
 
-        void emplace_back(unsigned char i) { _row.emplace_back(i); }
+        void emplace_back(unsigned char i);
 
-        auto begin() { return _row.begin(); }
-        auto end() { return _row.end(); }
-        auto begin() const { return _row.begin(); }
-        auto end() const { return _row.end(); }
+        const_iterator begin() const { return {this, 0}; }
+        const_iterator end() const { return {this, _size}; }
+
+        Row sub_row(size_t begin, size_t end) const;
 
         Row& operator+=(Row const& rhs);
         friend Row operator+(Row lhs, Row const& rhs);
@@ -60,20 +148,27 @@ public:
 
         bool operator==(Row const& rhs) const;
 
-        unsigned char& operator[](size_t const& i) {
-            return _row[i];
+        reference operator[](size_t const& i) {
+            return {_words[i / word_bits], word_type{1} << (i % word_bits)};
         }
-        unsigned char const& operator[](size_t const& i) const {
-            return _row[i];
+        unsigned char operator[](size_t const& i) const {
+            return (_words[i / word_bits] >> (i % word_bits)) & 1;
         }
 
-        void reserve(size_t n) { _row.reserve(n); }
+        void reserve(size_t n) { _words.reserve(_num_words(n)); }
 
     private:
-        std::vector<unsigned char> _row;
+        std::vector<word_type> _words;
+        size_t _size = 0;
+
+        static size_t _num_words(size_t n_bits) { return (n_bits + word_bits - 1) / word_bits; }
+        void _clear_padding();
     };
     using RowOperation = std::pair<size_t, size_t>;
 
+    // the widest column block for M4RI elimination; each block precomputes 2^block_size row combinations
+    static constexpr size_t max_m4ri_block_size = 8;
+
     BooleanMatrix() {}
     BooleanMatrix(std::vector<Row> const& matrix) : _matrix(matrix) {}
     BooleanMatrix(std::vector<Row>&& matrix) : _matrix(std::move(matrix)) {}
@@ -97,6 +192,7 @@ public:
 
     bool row_operation(size_t ctrl, size_t targ, bool track = false);
     size_t gaussian_elimination_skip(size_t block_size, bool do_fully_reduced, bool track = true);
+    size_t gaussian_elimination_m4ri(size_t block_size, bool do_fully_reduced, bool track = true);
     size_t matrix_rank() const;
     bool gaussian_elimination_augmented(bool track = false);
     void print_matrix(spdlog::level::level_enum lvl = spdlog::level::level_enum::off) const;
@@ -104,7 +200,7 @@ public:
     size_t row_operation_depth();
     double dense_ratio();
     void push_zeros_column();
-    void push_zeros_row() { _matrix.emplace_back(std::vector<unsigned char>(_matrix[0].size(), 0)); }
+    void push_zeros_row() { _matrix.emplace_back(_matrix[0].size()); }
     void push_row(Row const& row) { _matrix.emplace_back(row); }
     void push_row(Row&& row) { _matrix.emplace_back(std::move(row)); }
     void erase_row(size_t r) { _matrix.erase(dvlab::iterator::next(_matrix.begin(), r)); };
@@ -136,6 +232,8 @@ private:
     std::vector<RowOperation> _row_operations;
 };
 
+static_assert(std::ranges::bidirectional_range<BooleanMatrix::Row>);
+
 dvlab::BooleanMatrix vstack(dvlab::BooleanMatrix const& a, dvlab::BooleanMatrix const& b);
 
 // variadic template for vstack
@@ -160,6 +258,32 @@ dvlab::BooleanMatrix transpose(dvlab::BooleanMatrix const& matrix);
 
 dvlab::BooleanMatrix identity(size_t size);
 
+/**
+ * @brief Keeps the overlaps, i.e., the numbers of common ones, of all pairs of
+ *        rows of a matrix, together with the best partner of every row. When
+ *        rows change, only the overlaps involving them are recomputed, and a
+ *        row looks for a new partner only if it has lost its best one.
+ *
+ */
+class RowOverlaps {
+public:
+    RowOverlaps(BooleanMatrix const& matrix);
+
+    std::optional<std::pair<size_t, size_t>> max_overlap_pair() const;
+    void update_rows(BooleanMatrix const& matrix, std::vector<size_t> const& rows);
+
+private:
+    struct Partner {
+        size_t overlap = 0;
+        size_t row     = SIZE_MAX;
+    };
+
+    std::vector<std::vector<size_t>> _overlaps;
+    std::vector<Partner> _best_partners;
+
+    void _find_best_partner(size_t row);
+};
+
 struct BooleanMatrixRowHash {
     size_t operator()(std::vector<unsigned char> const& k) const;
     size_t operator()(dvlab::BooleanMatrix::Row const& k) const;
@@ -11,6 +11,7 @@
 
 #include <memory>
 #include <string>
+#include <utility>
 
 #include "./ordered_hashmap.hpp"
 
@@ -37,9 +38,10 @@ public:
     DataStructureManager(std::string_view name) : _type_name{name} {}
     virtual ~DataStructureManager() = default;
 
+    // the copied data are shared with `other` until either side writes to them
     DataStructureManager(DataStructureManager const& other) : _next_id{other._next_id}, _focused_id{other._focused_id} {
         for (auto& [id, data] : other._list) {
-            _list.emplace(id, std::make_unique<T>(*data));
+            _list.emplace(id, data);
         }
     }
     DataStructureManager(DataStructureManager&& other) noexcept = default;
@@ -69,7 +71,7 @@ public:
 
     size_t get_next_id() const { return _next_id; }
 
-    T* get() const { return size() ? _list.at(_focused_id).get() : nullptr; }
+    T* get() const { return size() ? _get_writable(_focused_id) : nullptr; }
 
     void set_by_id(size_t id, std::unique_ptr<T> t) {
         if (_list.contains(id)) {
@@ -140,7 +142,9 @@ public:
             spdlog::error("Cannot copy {0}: The {0} list is empty!!", _type_name);
             return;
         }
-        auto copy = std::make_unique<T>(*get());
+        // the copy shares the data with the original until one of them is
+        // handed out for writing by get() or find_by_id()
+        auto copy = std::shared_ptr<T>{_list.at(_focused_id)};
 
         if (_next_id <= new_id) _next_id = new_id + 1;
         _list.insert_or_assign(new_id, std::move(copy));
@@ -154,13 +158,13 @@ public:
             _print_id_does_not_exist_error_msg();
             return nullptr;
         }
-        return _list.at(id).get();
+        return _get_writable(id);
     }
 
     void print_manager() const {
         fmt::println("-> #{}: {}", _type_name, this->size());
         if (this->size()) {
-            auto name = data_structure_name(*get());
+            auto name = data_structure_name(*_list.at(_focused_id));
             fmt::println("-> Now focused on: {} {}{}", _type_name, _focused_id, name.empty() ? "" : fmt::format(" ({})", name));
         }
     }
@@ -177,7 +181,7 @@ public:
 
     void print_focus() const {
         if (this->size()) {
-            auto name = data_structure_name(*get());
+            auto name = data_structure_name(*_list.at(_focused_id));
             fmt::println("-> Now focused on: {} {}{}", _type_name, _focused_id, name.empty() ? "" : fmt::format(" ({})", name));
         } else {
             fmt::println("The {} list is empty", _type_name);
@@ -189,9 +193,17 @@ public:
 private:
     size_t _next_id    = 0;
     size_t _focused_id = 0;
-    ordered_hashmap<size_t, std::unique_ptr<T>> _list;
+    // copy-on-write: an entry may share its data with copies of it; `mutable`
+    // because handing out a pointer from a const getter may unshare the entry
+    mutable ordered_hashmap<size_t, std::shared_ptr<T>> _list;
     std::string _type_name;
 
+    T* _get_writable(size_t id) const {
+        auto& data = _list.at(id);
+        if (data.use_count() > 1) data = std::make_shared<T>(std::as_const(*data));
+        return data.get();
+    }
+
     void _print_id_does_not_exist_error_msg() const {
         fmt::println(stderr, "Error: The ID provided does not exist!!");
     }
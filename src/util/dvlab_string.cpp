@@ -75,6 +75,22 @@ size_t str_get_token(std::string_view str, std::string& tok, size_t pos, char de
     return str_get_token(str, tok, pos, std::string(1, delim));
 }
 
+// Same as above, but `tok` views into `str` instead of copying the token.
+size_t str_get_token(std::string_view str, std::string_view& tok, size_t pos, std::string_view delim) {
+    auto const begin = str.find_first_not_of(delim, pos);
+    if (begin == std::string::npos) {
+        tok = {};
+        return begin;
+    }
+    auto const end = str.find_first_of(delim, begin);
+    tok            = str.substr(begin, end - begin);
+    return end;
+}
+
+size_t str_get_token(std::string_view str, std::string_view& tok, size_t pos, char delim) {
+    return str_get_token(str, tok, pos, std::string_view(&delim, 1));
+}
+
 /**
  * @brief type-safe conversion to lower case character
  *
@@ -37,6 +37,8 @@ inline std::string_view trim_comments(std::string_view line) { return line.subst
 std::string remove_brackets(std::string const& str, char left, char right);
 size_t str_get_token(std::string_view str, std::string& tok, size_t pos = 0, std::string const& delim = " \t\n\v\f\r");
 size_t str_get_token(std::string_view str, std::string& tok, size_t pos, char delim);
+size_t str_get_token(std::string_view str, std::string_view& tok, size_t pos = 0, std::string_view delim = " \t\n\v\f\r");
+size_t str_get_token(std::string_view str, std::string_view& tok, size_t pos, char delim);
 
 namespace detail {
 template <class T>
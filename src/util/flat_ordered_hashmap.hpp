@@ -0,0 +1,138 @@
+/****************************************************************************
+  PackageName  [ util ]
+  Synopsis     [ Define flat_ordered_hashmap ]
+  Author       [ Design Verification Lab ]
+  Copyright    [ Copyright(c) 2023 DVLab, GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+/********************** Summary of this data structure **********************
+ *
+ *     flat_ordered_hashmap is an open-addressing variant of ordered_hashmap
+ * with the same interface, plus `reserve()`. Key-value pairs are iterated in
+ * the order they are inserted. See src/util/flat_ordered_hashtable.hpp for
+ * the storage layout.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <stdexcept>
+#include <utility>
+
+#include "./flat_ordered_hashtable.hpp"
+
+namespace dvlab {
+
+namespace utils {
+
+namespace detail {
+
+struct flat_map_key_of {  // NOLINT(readability-identifier-naming) : consistent with the container names
+    template <typename Pair>
+    auto const& operator()(Pair const& value) const { return value.first; }
+};
+
+}  // namespace detail
+
+template <typename Key, typename T, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class flat_ordered_hashmap final : public flat_ordered_hashtable<Key, std::pair<Key const, T>, std::pair<Key, T>, detail::flat_map_key_of, Hash, KeyEqual> {  // NOLINT(readability-identifier-naming) : flat_ordered_hashmap intentionally mimics std::unordered_map
+    using _Table_t = flat_ordered_hashtable<Key, std::pair<Key const, T>, std::pair<Key, T>, detail::flat_map_key_of, Hash, KeyEqual>;
+
+public:
+    using key_type        = typename _Table_t::key_type;
+    using mapped_type     = T;
+    using value_type      = typename _Table_t::value_type;
+    using stored_type     = typename _Table_t::stored_type;
+    using size_type       = typename _Table_t::size_type;
+    using difference_type = typename _Table_t::difference_type;
+    using hasher          = typename _Table_t::hasher;
+    using key_equal       = typename _Table_t::key_equal;
+    using iterator        = typename _Table_t::iterator;
+    using const_iterator  = typename _Table_t::const_iterator;
+
+    flat_ordered_hashmap() : _Table_t() {}
+    flat_ordered_hashmap(std::initializer_list<value_type> const& il) : _Table_t() {
+        this->reserve(il.size());
+        this->insert(il.begin(), il.end());
+    }
+
+    template <typename InputIt>
+    flat_ordered_hashmap(InputIt first, InputIt last) {
+        if constexpr (std::forward_iterator<InputIt>) {
+            this->reserve(static_cast<size_type>(std::distance(first, last)));
+        }
+        this->insert(first, last);
+    }
+
+    // lookup
+    T& at(Key const& key) {
+        auto itr = this->find(key);
+        if (itr == this->end()) {
+            throw std::out_of_range("no value corresponding to the key");
+        }
+        return itr->second;
+    }
+    T const& at(Key const& key) const {
+        auto itr = this->find(key);
+        if (itr == this->end()) {
+            throw std::out_of_range("no value corresponding to the key");
+        }
+        return itr->second;
+    }
+
+    T& operator[](Key const& key) { return try_emplace(key).first->second; }
+    T& operator[](Key&& key) { return try_emplace(std::move(key)).first->second; }
+
+    /**
+     * @brief If the key does not exist, emplace a key-value pair in place.
+     *        Otherwise, do nothing.
+     *
+     * @return std::pair<iterator, bool>. If emplacement succeeds, the pair
+     *         consists of an iterator to the emplaced pair and `true`;
+     *         otherwise, the pair consists of an iterator to the existing pair
+     *         and `false`.
+     */
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(Key const& key, Args&&... args) {
+        auto itr = this->find(key);
+        if (itr != this->end()) {
+            return std::make_pair(itr, false);
+        }
+        auto const hash = Hash{}(key);
+        this->_push_back(stored_type(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...)), hash);
+        return std::make_pair(std::prev(this->end()), true);
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(Key&& key, Args&&... args) {
+        auto itr = this->find(key);
+        if (itr != this->end()) {
+            return std::make_pair(itr, false);
+        }
+        auto const hash = Hash{}(key);
+        this->_push_back(stored_type(std::piecewise_construct, std::forward_as_tuple(std::move(key)), std::forward_as_tuple(std::forward<Args>(args)...)), hash);
+        return std::make_pair(std::prev(this->end()), true);
+    }
+
+    std::pair<iterator, bool> insert_or_assign(Key const& key, T&& obj) {
+        auto ret = try_emplace(key, std::move(obj));
+        if (!ret.second) {
+            ret.first->second = std::move(obj);
+        }
+        return ret;
+    }
+
+    std::pair<iterator, bool> insert_or_assign(Key&& key, T&& obj) {
+        auto ret = try_emplace(std::move(key), std::move(obj));
+        if (!ret.second) {
+            ret.first->second = std::move(obj);
+        }
+        return ret;
+    }
+};
+
+static_assert(std::ranges::bidirectional_range<flat_ordered_hashmap<int, int>>);
+
+}  // namespace utils
+
+}  // namespace dvlab
@@ -0,0 +1,69 @@
+/****************************************************************************
+  PackageName  [ util ]
+  Synopsis     [ Define flat_ordered_hashset ]
+  Author       [ Design Verification Lab ]
+  Copyright    [ Copyright(c) 2023 DVLab, GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+/********************** Summary of this data structure **********************
+ *
+ *     flat_ordered_hashset is an open-addressing variant of ordered_hashset
+ * with the same interface, plus `reserve()`. Elements are iterated in the
+ * order they are inserted. See src/util/flat_ordered_hashtable.hpp for the
+ * storage layout.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "./flat_ordered_hashtable.hpp"
+
+namespace dvlab {
+
+namespace utils {
+
+namespace detail {
+
+struct flat_set_key_of {  // NOLINT(readability-identifier-naming) : consistent with the container names
+    template <typename T>
+    T const& operator()(T const& value) const { return value; }
+};
+
+}  // namespace detail
+
+template <typename Key, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class flat_ordered_hashset final : public flat_ordered_hashtable<Key, Key const, Key, detail::flat_set_key_of, Hash, KeyEqual> {  // NOLINT(readability-identifier-naming) : flat_ordered_hashset intentionally mimics std::unordered_set
+    using _Table_t = flat_ordered_hashtable<Key, Key const, Key, detail::flat_set_key_of, Hash, KeyEqual>;
+
+public:
+    using key_type        = typename _Table_t::key_type;
+    using value_type      = typename _Table_t::value_type;
+    using stored_type     = typename _Table_t::stored_type;
+    using size_type       = typename _Table_t::size_type;
+    using difference_type = typename _Table_t::difference_type;
+    using hasher          = typename _Table_t::hasher;
+    using key_equal       = typename _Table_t::key_equal;
+    using container       = typename _Table_t::container;
+    using iterator        = typename _Table_t::iterator;
+    using const_iterator  = typename _Table_t::const_iterator;
+
+    flat_ordered_hashset() : _Table_t() {}
+    flat_ordered_hashset(std::initializer_list<value_type> const& il) : _Table_t() {
+        this->reserve(il.size());
+        this->insert(il.begin(), il.end());
+    }
+
+    template <typename InputIt>
+    flat_ordered_hashset(InputIt first, InputIt last) {
+        if constexpr (std::forward_iterator<InputIt>) {
+            this->reserve(static_cast<size_type>(std::distance(first, last)));
+        }
+        this->insert(first, last);
+    }
+};
+
+static_assert(std::ranges::bidirectional_range<flat_ordered_hashset<int>>);
+
+}  // namespace utils
+
+}  // namespace dvlab
@@ -0,0 +1,412 @@
+/****************************************************************************
+  PackageName  [ util ]
+  Synopsis     [ Define flat_ordered_hashtable interface ]
+  Author       [ Design Verification Lab ]
+  Copyright    [ Copyright(c) 2023 DVLab, GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+/********************** Summary of this data structure **********************
+ *
+ *     flat_ordered_hashtable is a drop-in alternative to ordered_hashtable,
+ * the common interface of flat_ordered_hashmap and flat_ordered_hashset.
+ * Elements are kept in insertion order in a dense vector, exactly like
+ * ordered_hashtable. Instead of a node-based std::unordered_map, the keys
+ * are indexed by an open-addressing table with robin-hood probing whose
+ * buckets store the element index and a hash fragment inline. Erasing from
+ * the index uses backward shifting, so the index itself never holds
+ * tombstones; the element vector is compacted once more than half of its
+ * slots are erased.
+ *
+ * For more details, please see the descriptions in
+ *     - src/util/flat_ordered_hashmap.hpp
+ *     - src/util/flat_ordered_hashset.hpp
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+namespace dvlab {
+
+namespace utils {
+
+template <typename Key, typename Value, typename StoredType, typename KeyOf, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class flat_ordered_hashtable {  // NOLINT(readability-identifier-naming) : flat_ordered_hashtable intentionally mimics std containers
+public:
+    using key_type        = Key;
+    using value_type      = Value;
+    using stored_type     = StoredType;
+    using size_type       = size_t;
+    using difference_type = std::ptrdiff_t;
+    using hasher          = Hash;
+    using key_equal       = KeyEqual;
+    using container       = std::vector<std::optional<stored_type>>;
+
+    template <typename VecIterType>
+    class OTableIterator;
+
+    using iterator       = OTableIterator<typename container::iterator>;
+    using const_iterator = OTableIterator<typename container::const_iterator>;
+
+    template <typename VecIterType>
+    class OTableIterator {
+    public:
+        using value_type        = Value;
+        using difference_type   = std::ptrdiff_t;
+        using iterator_category = std::bidirectional_iterator_tag;
+        OTableIterator() {}
+        OTableIterator(VecIterType const& itr, VecIterType const& begin, VecIterType const& end) : _itr(itr), _begin(begin), _end(end) {}
+
+        OTableIterator& operator++() noexcept {
+            ++_itr;
+            while (_itr != _end && !_itr->has_value()) {
+                ++_itr;
+            }
+            return *this;
+        }
+
+        OTableIterator operator++(int) noexcept {
+            OTableIterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        OTableIterator& operator--() noexcept {
+            --_itr;
+            while (_itr != _begin && !_itr->has_value()) {
+                --_itr;
+            }
+            return *this;
+        }
+
+        OTableIterator operator--(int) noexcept {
+            OTableIterator tmp = *this;
+            --*this;
+            return tmp;
+        }
+
+        bool operator==(OTableIterator const& rhs) const noexcept { return this->_itr == rhs._itr; }
+        bool operator!=(OTableIterator const& rhs) const noexcept { return !(*this == rhs); }
+
+        bool is_valid() const noexcept { return *(this->_itr) != std::nullopt; }
+
+        value_type& operator*() noexcept { return (value_type&)this->_itr->value(); }
+        value_type& operator*() const noexcept { return (value_type&)this->_itr->value(); }
+
+        value_type* operator->() noexcept { return (value_type*)&(this->_itr->value()); }
+        value_type* operator->() const noexcept { return (value_type*)&(this->_itr->value()); }
+
+    private:
+        VecIterType _itr;
+        VecIterType _begin;
+        VecIterType _end;
+    };
+
+    flat_ordered_hashtable() {}
+    ~flat_ordered_hashtable() = default;
+
+    flat_ordered_hashtable(flat_ordered_hashtable const& other)                = default;
+    flat_ordered_hashtable(flat_ordered_hashtable&& other) noexcept            = default;
+    flat_ordered_hashtable& operator=(flat_ordered_hashtable const& other)     = default;
+    flat_ordered_hashtable& operator=(flat_ordered_hashtable&& other) noexcept = default;
+
+    // iterators
+    iterator begin() noexcept {
+        auto itr = _data.begin();
+        while (itr != _data.end() && !itr->has_value()) ++itr;
+        return iterator(itr, this->_data.begin(), this->_data.end());
+    }
+    iterator end() noexcept { return iterator(this->_data.end(), this->_data.begin(), this->_data.end()); }
+    const_iterator begin() const noexcept {
+        auto itr = _data.begin();
+        while (itr != _data.end() && !itr->has_value()) ++itr;
+        return const_iterator(itr, this->_data.begin(), this->_data.end());
+    }
+    const_iterator end() const noexcept { return const_iterator(this->_data.end(), this->_data.begin(), this->_data.end()); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    // lookup
+    iterator find(Key const& key) {
+        auto const bucket = _find_bucket(key);
+        return bucket.has_value() ? iterator(this->_data.begin() + _buckets[*bucket].index, this->_data.begin(), this->_data.end()) : this->end();
+    }
+    const_iterator find(Key const& key) const {
+        auto const bucket = _find_bucket(key);
+        return bucket.has_value() ? const_iterator(this->_data.begin() + _buckets[*bucket].index, this->_data.begin(), this->_data.end()) : this->end();
+    }
+
+    /**
+     * @brief Return the internal index where the element with the key is stored.
+     *        As the element vector is compacted on erasure, this information
+     *        is not reliable once insertion and erasure happens.
+     *
+     * @param key
+     * @return size_type
+     */
+    size_type id(Key const& key) const {
+        auto const bucket = _find_bucket(key);
+        if (!bucket.has_value()) throw std::out_of_range("no value corresponding to the key");
+        return _buckets[*bucket].index;
+    }
+    bool contains(Key const& key) const { return _find_bucket(key).has_value(); }
+    template <typename KT>
+    bool contains(KT const& key) const { return contains(Key{key}); }
+    Key const& key(stored_type const& value) const { return KeyOf{}(value); }
+
+    // properties
+    size_t size() const { return _size; }
+    bool empty() const { return (this->size() == 0); }
+    bool operator==(flat_ordered_hashtable const& rhs) const {
+        if (_size != rhs._size) return false;
+
+        return std::all_of(this->begin(), this->end(), [&rhs](auto const& item) {
+            return rhs.contains(KeyOf{}(item));
+        });
+    }
+    bool operator!=(flat_ordered_hashtable const& rhs) const { return !(*this == rhs); }
+
+    // container manipulation
+    void clear() {
+        _data.clear();
+        _buckets.clear();
+        _size = 0;
+    }
+    void reserve(size_type n);
+
+    std::pair<iterator, bool> insert(value_type&& value) { return emplace(std::move(value)); }
+    std::pair<iterator, bool> insert(value_type const& value) { return emplace(value); }
+
+    template <typename InputIt>
+    void insert(InputIt const& first, InputIt const& last) {
+        for (auto itr = first; itr != last; ++itr) {
+            emplace(*itr);
+        }
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Args&&... args);
+
+    void sweep();
+
+    size_t erase(Key const& key);
+    size_t erase(iterator const& itr) { return erase(KeyOf{}(*itr)); }
+
+    template <typename F>
+    void sort(F lambda);
+
+protected:
+    struct Bucket {
+        uint32_t index;  // position in _data
+        uint32_t hash;   // low bits of the key hash; saves most key comparisons
+        uint32_t dist;   // 1 + probe distance from the home bucket; 0 marks an empty bucket
+    };
+
+    static constexpr size_t min_buckets = 8;
+
+    container _data               = {};
+    std::vector<Bucket> _buckets = {};
+    size_t _size                 = 0;
+
+    // std::hash is the identity for integers on common standard libraries, which makes
+    // consecutive keys pile up into long probe sequences; scramble the bits first
+    static uint32_t _fragment(size_t hash) {
+        auto const h = static_cast<uint64_t>(hash) * 0x9e3779b97f4a7c15ull;
+        return static_cast<uint32_t>(h >> 32);
+    }
+    size_t _mask() const { return _buckets.size() - 1; }
+    bool _needs_growth(size_t n) const { return n * 8 > _buckets.size() * 7; }  // max load factor 7/8
+
+    std::optional<size_t> _find_bucket(Key const& key) const;
+    void _insert_bucket(Bucket bucket);
+    void _rehash(size_t n_buckets);
+    void _push_back(stored_type&& value, size_t hash);
+};
+
+//------------------------------------------------------
+//  lookup
+//------------------------------------------------------
+
+/**
+ * @brief Find the bucket holding `key`. The probe stops early as soon as a
+ *        bucket closer to its home than the current probe distance is met.
+ *
+ * @param key
+ * @return std::optional<size_t> the bucket position
+ */
+template <typename Key, typename Value, typename StoredType, typename KeyOf, typename Hash, typename KeyEqual>
+std::optional<size_t> flat_ordered_hashtable<Key, Value, StoredType, KeyOf, Hash, KeyEqual>::_find_bucket(Key const& key) const {
+    if (_buckets.empty()) return std::nullopt;
+    auto const hash     = Hash{}(key);
+    auto const fragment = _fragment(hash);
+    auto pos            = fragment & _mask();
+    for (uint32_t dist = 1;; ++dist, pos = (pos + 1) & _mask()) {
+        auto const& bucket = _buckets[pos];
+        if (bucket.dist < dist) return std::nullopt;  // also covers empty buckets
+        if (bucket.hash == fragment && KeyEqual{}(this->key(*_data[bucket.index]), key)) return pos;
+    }
+}
+
+//------------------------------------------------------
+//  container manipulation
+//------------------------------------------------------
+
+/**
+ * @brief Reserve room for `n` elements so that no rehashing happens until
+ *        the size exceeds `n`.
+ *
+ * @param n
+ */
+template <typename Key, typename Value, typename StoredType, typename KeyOf, typename Hash, typename KeyEqual>
+void flat_ordered_hashtable<Key, Value, StoredType, KeyOf, Hash, KeyEqual>::reserve(size_type n) {
+    _data.reserve(n);
+    auto n_buckets = std::bit_ceil(std::max(min_buckets, n + n / 7 + 1));
+    if (n_buckets > _buckets.size()) _rehash(n_buckets);
+}
+
+/**
+ * @brief Emplace an element in place. Note that if the emplacement fails,
+ *        the values are still moved-from.
+ *
+ * @return std::pair<iterator, bool>. If emplacement succeeds, the pair
+ *         consists of an iterator to the emplaced element and `true`;
+ *         otherwise, the pair consists of an iterator to the existing element
+ *         and `false`.
+ */
+template <typename Key, typename Value, typename StoredType, typename KeyOf, typename Hash, typename KeyEqual>
+template <typename... Args>
+std::pair<typename flat_ordered_hashtable<Key, Value, StoredType, KeyOf, Hash, KeyEqual>::iterator, bool>
+flat_ordered_hashtable<Key, Value, StoredType, KeyOf, Hash, KeyEqual>::emplace(Args&&... args) {
+    stored_type value(std::forward<Args>(args)...);
+    if (auto const bucket = _find_bucket(this->key(value)); bucket.has_value()) {
+        return {iterator(_data.begin() + _buckets[*bucket].index, _data.begin(), _data.end()), false};
+    }
+    auto const hash = Hash{}(this->key(value));
+    _push_back(std::move(value), hash);
+    return {iterator(std::prev(_data.end()), _data.begin(), _data.end()), true};
+}
+
+/**
+ * @brief Delete the placeholders for erased data and renumber the index.
+ *
+ */
+template <typename Key, typename Value, typename StoredType, typename KeyOf, typename Hash, typename KeyEqual>
+void flat_ordered_hashtable<Key, Value, StoredType, KeyOf, Hash, KeyEqual>::sweep() {
+    std::vector<uint32_t> old_to_new(_data.size());
+    uint32_t next = 0;
+    for (size_t i = 0; i < _data.size(); ++i) {
+        if (!_data[i].has_value()) continue;
+        old_to_new[i] = next;
+        if (next != i) _data[next] = std::move(_data[i]);
+        ++next;
+    }
+    _data.resize(next);
+    for (auto& bucket : _buckets) {
+        if (bucket.dist != 0) bucket.index = old_to_new[bucket.index];
+    }
+}
+
+/**
+ * @brief Erase the element with the given key. The element slot is left as a
+ *        placeholder; the element vector is compacted once more than half of
+ *        its slots are placeholders.
+ *
+ * @param key
+ * @return size_t : the number of element deleted
+ */
+template <typename Key, typename Value, typename StoredType, typename KeyOf, typename Hash, typename KeyEqual>
+size_t flat_ordered_hashtable<Key, Value, StoredType, KeyOf, Hash, KeyEqual>::erase(Key const& key) {
+    auto const bucket = _find_bucket(key);
+    if (!bucket.has_value()) return 0;
+
+    _data[_buckets[*bucket].index] = std::nullopt;
+    --_size;
+
+    // backward-shift the following buckets so that no tombstone is left in the index
+    auto pos  = *bucket;
+    auto next = (pos + 1) & _mask();
+    while (_buckets[next].dist > 1) {
+        _buckets[pos] = _buckets[next];
+        --_buckets[pos].dist;
+        pos  = next;
+        next = (next + 1) & _mask();
+    }
+    _buckets[pos].dist = 0;
+
+    if (_data.size() >= 16 && _data.size() > _size * 2) {
+        this->sweep();
+    }
+    return 1;
+}
+
+template <typename Key, typename Value, typename StoredType, typename KeyOf, typename Hash, typename KeyEqual>
+template <typename F>
+void flat_ordered_hashtable<Key, Value, StoredType, KeyOf, Hash, KeyEqual>::sort(F lambda) {
+    std::erase_if(_data, [](std::optional<stored_type> const& v) { return !v.has_value(); });
+    std::sort(this->_data.begin(), this->_data.end(), [&lambda](std::optional<stored_type> const& a, std::optional<stored_type> const& b) {
+        return lambda(*a, *b);
+    });
+    _rehash(_buckets.size());
+}
+
+//------------------------------------------------------
+//  private helpers
+//------------------------------------------------------
+
+/**
+ * @brief Place `bucket` with robin-hood probing: whenever the probed bucket
+ *        is closer to its home than the one being placed, they are swapped.
+ *
+ * @param bucket
+ */
+template <typename Key, typename Value, typename StoredType, typename KeyOf, typename Hash, typename KeyEqual>
+void flat_ordered_hashtable<Key, Value, StoredType, KeyOf, Hash, KeyEqual>::_insert_bucket(Bucket bucket) {
+    auto pos = bucket.hash & _mask();
+    bucket.dist = 1;
+    while (_buckets[pos].dist != 0) {
+        if (_buckets[pos].dist < bucket.dist) std::swap(bucket, _buckets[pos]);
+        pos = (pos + 1) & _mask();
+        ++bucket.dist;
+    }
+    _buckets[pos] = bucket;
+}
+
+/**
+ * @brief Rebuild the index with `n_buckets` buckets. The element vector is
+ *        compacted on the way.
+ *
+ * @param n_buckets must be a power of two
+ */
+template <typename Key, typename Value, typename StoredType, typename KeyOf, typename Hash, typename KeyEqual>
+void flat_ordered_hashtable<Key, Value, StoredType, KeyOf, Hash, KeyEqual>::_rehash(size_t n_buckets) {
+    std::erase_if(_data, [](std::optional<stored_type> const& v) { return !v.has_value(); });
+    _buckets.assign(std::max(n_buckets, min_buckets), Bucket{0, 0, 0});
+    for (size_t i = 0; i < _data.size(); ++i) {
+        // the home bucket only depends on the low bits of the hash, so the fragment suffices
+        _insert_bucket({static_cast<uint32_t>(i), _fragment(Hash{}(this->key(*_data[i]))), 0});
+    }
+}
+
+template <typename Key, typename Value, typename StoredType, typename KeyOf, typename Hash, typename KeyEqual>
+void flat_ordered_hashtable<Key, Value, StoredType, KeyOf, Hash, KeyEqual>::_push_back(stored_type&& value, size_t hash) {
+    if (_data.size() >= std::numeric_limits<uint32_t>::max()) {
+        throw std::length_error("flat_ordered_hashtable cannot hold more than 2^32 - 1 slots");
+    }
+    if (_buckets.empty() || _needs_growth(_size + 1)) {
+        _rehash(std::max(min_buckets, _buckets.size() * 2));
+    }
+    _data.emplace_back(std::move(value));
+    ++_size;
+    _insert_bucket({static_cast<uint32_t>(_data.size() - 1), _fragment(hash), 0});
+}
+
+}  // namespace utils
+}  // namespace dvlab
@@ -0,0 +1,84 @@
+/****************************************************************************
+  PackageName  [ util ]
+  Synopsis     [ RAII wrapper for read-only memory-mapped files ]
+  Author       [ Design Verification Lab ]
+  Copyright    [ Copyright(c) 2023 DVLab, GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#include "./mapped_file.hpp"
+
+#include <fcntl.h>
+#include <spdlog/spdlog.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+namespace dvlab {
+
+namespace utils {
+
+/**
+ * @brief Map the file at `path` into memory.
+ *
+ * @param path
+ * @return std::optional<MappedFile> the mapping, or std::nullopt if the file
+ *         cannot be opened or mapped
+ */
+std::optional<MappedFile> MappedFile::open(std::filesystem::path const& path) {
+    auto const fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        spdlog::error("Cannot open the file \"{}\": {}", path.string(), std::strerror(errno));
+        return std::nullopt;
+    }
+
+    struct stat st {};
+    if (::fstat(fd, &st) != 0) {
+        spdlog::error("Cannot stat the file \"{}\": {}", path.string(), std::strerror(errno));
+        ::close(fd);
+        return std::nullopt;
+    }
+
+    auto const size = static_cast<size_t>(st.st_size);
+    // mmap rejects empty mappings; an empty file is an empty view
+    if (size == 0) {
+        ::close(fd);
+        return MappedFile{nullptr, 0};
+    }
+
+    void* const data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping stays valid after the descriptor is closed
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        spdlog::error("Cannot map the file \"{}\": {}", path.string(), std::strerror(errno));
+        return std::nullopt;
+    }
+    return MappedFile{static_cast<std::byte const*>(data), size};
+}
+
+MappedFile::~MappedFile() {
+    if (_data != nullptr) {
+        ::munmap(const_cast<std::byte*>(_data), _size);
+    }
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : _data{std::exchange(other._data, nullptr)}, _size{std::exchange(other._size, 0)} {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        if (_data != nullptr) {
+            ::munmap(const_cast<std::byte*>(_data), _size);
+        }
+        _data = std::exchange(other._data, nullptr);
+        _size = std::exchange(other._size, 0);
+    }
+    return *this;
+}
+
+}  // namespace utils
+
+}  // namespace dvlab
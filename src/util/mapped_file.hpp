@@ -0,0 +1,50 @@
+/****************************************************************************
+  PackageName  [ util ]
+  Synopsis     [ RAII wrapper for read-only memory-mapped files ]
+  Author       [ Design Verification Lab ]
+  Copyright    [ Copyright(c) 2023 DVLab, GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string_view>
+
+namespace dvlab {
+
+namespace utils {
+
+/**
+ * @brief A read-only view of a whole file, mapped into memory. The mapping
+ *        is released when the object is destroyed.
+ *
+ */
+class MappedFile {
+public:
+    static std::optional<MappedFile> open(std::filesystem::path const& path);
+
+    ~MappedFile();
+    // deletes copy ctors and assignment operators because the mapping is unique
+    MappedFile(MappedFile const&)            = delete;
+    MappedFile& operator=(MappedFile const&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    std::span<std::byte const> bytes() const { return {_data, _size}; }
+    std::string_view text() const { return {reinterpret_cast<char const*>(_data), _size}; }
+    size_t size() const { return _size; }
+
+private:
+    MappedFile(std::byte const* data, size_t size) : _data{data}, _size{size} {}
+
+    std::byte const* _data = nullptr;
+    size_t _size           = 0;
+};
+
+}  // namespace utils
+
+}  // namespace dvlab
@@ -183,6 +183,10 @@ public:
 
     // container manipulation
     void clear();
+    void reserve(size_t n) {
+        this->_key2id.reserve(n);
+        this->_data.reserve(n);
+    }
     std::pair<iterator, bool> insert(value_type&& value);
     std::pair<iterator, bool> insert(value_type const& value) { return this->insert(std::move(value)); }
 
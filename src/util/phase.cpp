@@ -23,11 +23,11 @@ namespace dvlab {
  */
 std::string Phase::get_ascii_string() const {
     std::string str;
-    if (_rational.numerator() != 1)
-        str += std::to_string(_rational.numerator()) + "*";
+    if (numerator() != 1)
+        str += std::to_string(numerator()) + "*";
     str += "pi";
-    if (_rational.denominator() != 1)
-        str += "/" + std::to_string(_rational.denominator());
+    if (denominator() != 1)
+        str += "/" + std::to_string(denominator());
     return str;
 }
 
@@ -38,11 +38,11 @@ std::string Phase::get_ascii_string() const {
  */
 std::string Phase::get_print_string() const {
     return (
-               _rational.numerator() == 1 ? ""
-               : _rational.numerator() == -1
+               numerator() == 1 ? ""
+               : numerator() == -1
                    ? "-"
-                   : std::to_string(_rational.numerator())) +
-           ((_rational.numerator() != 0) ? "\u03C0" : "") + ((_rational.denominator() != 1) ? ("/" + std::to_string(_rational.denominator())) : "");
+                   : std::to_string(numerator())) +
+           ((numerator() != 0) ? "\u03C0" : "") + ((denominator() != 1) ? ("/" + std::to_string(denominator())) : "");
 }
 
 std::ostream& operator<<(std::ostream& os, dvlab::Phase const& p) {
@@ -9,11 +9,16 @@
 
 #include <fmt/core.h>
 
+#include <algorithm>
+#include <bit>
 #include <cmath>
+#include <concepts>
+#include <cstdint>
 #include <iosfwd>
 #include <numbers>
 #include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "util/dvlab_string.hpp"
@@ -31,13 +36,13 @@ concept unitless = requires(T t) {
 class Phase {
 public:
     using IntegralType = Rational::IntegralType;
-    constexpr Phase() : _rational(0, 1) {}
+    constexpr Phase() = default;
     // explicitly ban `Phase phase = n;` to prevent confusing code
-    constexpr explicit Phase(IntegralType n) : _rational(n, 1) { normalize(); }
-    constexpr Phase(IntegralType n, IntegralType d) : _rational(n, d) { normalize(); }
+    constexpr explicit Phase(IntegralType n) { _set_dyadic(n, 0); }
+    constexpr Phase(IntegralType n, IntegralType d);
     template <class T>
     requires std::floating_point<T>
-    Phase(T f, T eps = 1e-4) : _rational(f / std::numbers::pi_v<T>, eps / std::numbers::pi_v<T>) { normalize(); }
+    Phase(T f, T eps = 1e-4) { _set_rational(Rational(f / std::numbers::pi_v<T>, eps / std::numbers::pi_v<T>)); }
 
     friend std::ostream& operator<<(std::ostream& os, Phase const& p);
     constexpr Phase operator+() const;
@@ -64,15 +69,20 @@ public:
 
     template <class T>
     requires std::floating_point<T>
-    constexpr static T phase_to_floating_point(Phase const& p) { return std::numbers::pi_v<T> * Rational::rational_to_floating_point<T>(p._rational); }
+    constexpr static T phase_to_floating_point(Phase const& p) {
+        return std::numbers::pi_v<T> * static_cast<T>(p.numerator()) / static_cast<T>(p.denominator());
+    }
 
     constexpr static float phase_to_f(Phase const& p) { return phase_to_floating_point<float>(p); }
     constexpr static double phase_to_d(Phase const& p) { return phase_to_floating_point<double>(p); }
     constexpr static long double phase_to_ld(Phase const& p) { return phase_to_floating_point<long double>(p); }
 
-    Rational get_rational() const { return _rational; }
-    constexpr IntegralType numerator() const { return _rational.numerator(); }
-    constexpr IntegralType denominator() const { return _rational.denominator(); }
+    constexpr Rational get_rational() const { return Rational(numerator(), denominator()); }
+    constexpr IntegralType numerator() const { return _is_dyadic ? _dyadic.numerator : _rational.numerator; }
+    constexpr IntegralType denominator() const { return _is_dyadic ? IntegralType{1} << _dyadic.exponent : _rational.denominator; }
+
+    // whether the phase is k·π/2^m and takes the shift-and-add fast path
+    constexpr bool is_dyadic() const { return _is_dyadic; }
 
     template <class T>
     requires std::floating_point<T>
@@ -102,17 +112,107 @@ public:
     static bool str_to_phase(std::string_view str, Phase& p);
 
 private:
-    dvlab::Rational _rational;
+    // A phase is stored in exactly one of two forms. Phases of the form
+    // k·π/2^m, which are almost all phases in practice, are kept as the pair
+    // (k, m) so that arithmetic is shifts and adds instead of gcds; the others
+    // are kept as the reduced fraction p·π/q. Both forms are normalized, so
+    // each fits in two ints. The exponent is capped so that numerator() and
+    // denominator() stay exact; a result that fits neither form, such as
+    // π/2^31, throws std::overflow_error from Rational.
+    static constexpr int max_dyadic_exponent = std::numeric_limits<IntegralType>::digits - 1;
+
+    struct DyadicForm {
+        IntegralType numerator = 0;
+        IntegralType exponent  = 0;
+    };
+    struct RationalForm {
+        IntegralType numerator;
+        IntegralType denominator;
+    };
+
+    union {
+        DyadicForm _dyadic{};
+        RationalForm _rational;  // only active if !_is_dyadic
+    };
+    bool _is_dyadic = true;
+
+    constexpr void _set_dyadic(std::int64_t numerator, int exponent);
+    constexpr void _set_rational(Rational q);
 };
 
+constexpr Phase::Phase(IntegralType n, IntegralType d) {
+    auto const abs_d = static_cast<std::uint64_t>(d < 0 ? -static_cast<std::int64_t>(d) : d);
+    if (std::has_single_bit(abs_d) && std::countr_zero(abs_d) <= max_dyadic_exponent) {
+        _set_dyadic(d < 0 ? -static_cast<std::int64_t>(n) : n, std::countr_zero(abs_d));
+    } else {
+        _set_rational(Rational(n, d));
+    }
+}
+
+/**
+ * @brief Set the phase to k·π/2^m, normalized to (-pi, pi]. The numerator may
+ *        be any intermediate result; it is reduced mod 2^(m+1), i.e., mod 2pi,
+ *        before it is narrowed.
+ *
+ */
+constexpr void Phase::_set_dyadic(std::int64_t numerator, int exponent) {
+    auto const period = std::int64_t{2} << exponent;
+    numerator &= period - 1;
+    if (numerator > period / 2) numerator -= period;
+    if (numerator == 0) {
+        exponent = 0;
+    } else {
+        // strip the common factors of 2
+        auto const shift = std::min(std::countr_zero(static_cast<std::uint64_t>(numerator)), exponent);
+        numerator >>= shift;
+        exponent -= shift;
+    }
+    _dyadic    = {.numerator = static_cast<IntegralType>(numerator), .exponent = exponent};
+    _is_dyadic = true;
+}
+
+/**
+ * @brief Set the phase to q·π, normalized to (-pi, pi]. Takes the dyadic form
+ *        if q has a small enough power-of-two denominator
+ *
+ */
+constexpr void Phase::_set_rational(Rational q) {
+    constexpr auto floor = [](Rational const& r) -> IntegralType { return (r.numerator() - (r.numerator() >= 0 ? 0 : r.denominator())) / r.denominator(); };
+    q -= (floor(q / 2) * 2);
+    if (q > 1) q -= 2;
+    auto const d = static_cast<std::uint64_t>(q.denominator());
+    if (std::has_single_bit(d) && std::countr_zero(d) <= max_dyadic_exponent) {
+        _set_dyadic(q.numerator(), std::countr_zero(d));
+        return;
+    }
+    _rational  = {.numerator = q.numerator(), .denominator = q.denominator()};
+    _is_dyadic = false;
+}
+
 constexpr Phase& Phase::operator*=(unitless auto const& rhs) {
-    this->_rational *= rhs;
-    normalize();
+    if constexpr (std::integral<std::remove_cvref_t<decltype(rhs)>>) {
+        if (is_dyadic()) {
+            // only rhs mod 2^(m+1) matters, which keeps the product in range
+            auto const period = std::uint64_t{2} << _dyadic.exponent;
+            _set_dyadic(_dyadic.numerator * static_cast<std::int64_t>(static_cast<std::uint64_t>(rhs) & (period - 1)), _dyadic.exponent);
+            return *this;
+        }
+    }
+    _set_rational(get_rational() * rhs);
     return *this;
 }
 constexpr Phase& Phase::operator/=(unitless auto const& rhs) {
-    this->_rational /= rhs;
-    normalize();
+    using T = std::remove_cvref_t<decltype(rhs)>;
+    if constexpr (std::integral<T> && !std::same_as<T, bool>) {
+        // dividing by ±2^s only moves the binary point
+        auto const negative = std::cmp_less(rhs, 0);
+        auto const abs_rhs  = negative ? 0 - static_cast<std::uint64_t>(rhs) : static_cast<std::uint64_t>(rhs);
+        if (is_dyadic() && std::has_single_bit(abs_rhs) && std::countr_zero(abs_rhs) <= max_dyadic_exponent - _dyadic.exponent) {
+            _set_dyadic(negative ? -_dyadic.numerator : _dyadic.numerator, _dyadic.exponent + std::countr_zero(abs_rhs));
+            return *this;
+        }
+    }
+    _set_rational(get_rational() / rhs);
     return *this;
 }
 constexpr Phase operator*(Phase lhs, unitless auto const& rhs) {
@@ -132,17 +232,25 @@ constexpr Phase Phase::operator+() const {
 }
 
 constexpr Phase Phase::operator-() const {
-    return Phase(-_rational.numerator(), _rational.denominator());
+    return Phase{} - *this;
 }
 
 constexpr Phase& Phase::operator+=(Phase const& rhs) {
-    this->_rational += rhs._rational;
-    normalize();
+    if (is_dyadic() && rhs.is_dyadic()) {
+        auto const exponent = std::max(_dyadic.exponent, rhs._dyadic.exponent);
+        _set_dyadic((std::int64_t{_dyadic.numerator} << (exponent - _dyadic.exponent)) + (std::int64_t{rhs._dyadic.numerator} << (exponent - rhs._dyadic.exponent)), exponent);
+    } else {
+        _set_rational(get_rational() + rhs.get_rational());
+    }
     return *this;
 }
 constexpr Phase& Phase::operator-=(Phase const& rhs) {
-    this->_rational -= rhs._rational;
-    normalize();
+    if (is_dyadic() && rhs.is_dyadic()) {
+        auto const exponent = std::max(_dyadic.exponent, rhs._dyadic.exponent);
+        _set_dyadic((std::int64_t{_dyadic.numerator} << (exponent - _dyadic.exponent)) - (std::int64_t{rhs._dyadic.numerator} << (exponent - rhs._dyadic.exponent)), exponent);
+    } else {
+        _set_rational(get_rational() - rhs.get_rational());
+    }
     return *this;
 }
 constexpr Phase operator+(Phase lhs, Phase const& rhs) {
@@ -154,11 +262,15 @@ constexpr Phase operator-(Phase lhs, Phase const& rhs) {
     return lhs;
 }
 constexpr Rational operator/(Phase const& lhs, Phase const& rhs) {
-    Rational q = lhs._rational / rhs._rational;
+    Rational q = lhs.get_rational() / rhs.get_rational();
     return q;
 }
+// both sides are in canonical form, so a dyadic phase never equals a non-dyadic one
 constexpr bool Phase::operator==(Phase const& rhs) const {
-    return _rational == rhs._rational;
+    if (is_dyadic() != rhs.is_dyadic()) return false;
+    return is_dyadic()
+               ? _dyadic.numerator == rhs._dyadic.numerator && _dyadic.exponent == rhs._dyadic.exponent
+               : _rational.numerator == rhs._rational.numerator && _rational.denominator == rhs._rational.denominator;
 }
 constexpr bool Phase::operator!=(Phase const& rhs) const {
     return !(*this == rhs);
@@ -233,13 +345,15 @@ bool Phase::str_to_phase(std::string_view str, Phase& p) {
 }
 
 /**
- * @brief Normalize the phase to 0-2pi
+ * @brief Normalize the phase to (-pi, pi]
  *
  */
 constexpr void Phase::normalize() {
-    constexpr auto floor = [](Rational const& q) -> IntegralType { return (q.numerator() - (q.numerator() >= 0 ? 0 : q.denominator())) / q.denominator(); };
-    _rational -= (floor(_rational / 2) * 2);
-    if (_rational > 1) _rational -= 2;
+    if (is_dyadic()) {
+        _set_dyadic(_dyadic.numerator, _dyadic.exponent);
+    } else {
+        _set_rational(get_rational());
+    }
 }
 
 }  // namespace dvlab
@@ -11,10 +11,12 @@
 #include <cassert>
 #include <cmath>
 #include <concepts>
+#include <cstdint>
 #include <gsl/util>
 #include <iosfwd>
 #include <limits>
 #include <numeric>
+#include <stdexcept>
 
 //--- Rational Numbers ----------------------------------
 // This class maintains the canonicity of stored rational numbers by simplifying the numerator/denominator whenever possible.
@@ -132,9 +134,15 @@ constexpr void Rational::reduce() {
         _numerator   = -_numerator;
         _denominator = -_denominator;
     }
-    IntegralType const gcd = std::gcd(static_cast<IntegralType>(_numerator), static_cast<IntegralType>(_denominator));
-    _numerator /= gcd;
-    _denominator /= gcd;
+    // the operands may be the product of two IntegralTypes, so reduce them in 64 bits
+    auto const gcd = std::gcd(static_cast<std::int64_t>(_numerator), static_cast<std::int64_t>(_denominator));
+    _numerator /= static_cast<double>(gcd);
+    _denominator /= static_cast<double>(gcd);
+    if (_numerator < std::numeric_limits<IntegralType>::min() ||
+        _numerator > std::numeric_limits<IntegralType>::max() ||
+        _denominator > std::numeric_limits<IntegralType>::max()) {
+        throw std::overflow_error("Rational number out of the range of IntegralType");
+    }
 }
 
 //----------------------------------------
@@ -0,0 +1,216 @@
+/****************************************************************************
+  PackageName  [ util ]
+  Synopsis     [ Define slab_pool, a slab allocator with free-list reuse ]
+  Author       [ Design Verification Lab ]
+  Copyright    [ Copyright(c) 2023 DVLab, GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+/********************** Summary of this data structure **********************
+ *
+ *     slab_pool hands out storage for objects of a single type from large
+ * contiguous slabs. Destroyed objects are threaded onto an intrusive free
+ * list and reused by later allocations. Objects never move once created,
+ * so pointers to them stay valid until they are destroyed.
+ *
+ *     The pool does not track which slots are alive; the owner is
+ * responsible for destroying every object it created before the pool goes
+ * away. Slabs are returned to the system only when the pool is destroyed.
+ *
+ *     A pool may adopt objects created by another pool, e.g., to let
+ * independent parts of a data structure be modified on different threads.
+ * The adopted objects are destroyed through the adopting pool, and the pool
+ * that created them is kept alive until no other pool refers to it.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace dvlab {
+
+namespace utils {
+
+template <typename T, size_t SlabSize = 256>
+class slab_pool {  // NOLINT(readability-identifier-naming) : slab_pool intentionally mimics std containers
+public:
+    struct statistics {
+        size_t num_slabs;
+        size_t capacity;   // total number of slots in all slabs
+        size_t num_live;   // slots holding a live object
+        size_t num_freed;  // slots on the free list, i.e., holes between live objects
+
+        double occupancy() const { return capacity == 0 ? 0. : static_cast<double>(num_live) / static_cast<double>(capacity); }
+        double fragmentation() const { return capacity == 0 ? 0. : static_cast<double>(num_freed) / static_cast<double>(capacity); }
+    };
+
+    slab_pool() = default;
+    ~slab_pool() = default;
+
+    slab_pool(slab_pool const&)            = delete;
+    slab_pool& operator=(slab_pool const&) = delete;
+    slab_pool(slab_pool&&) noexcept        = default;
+    slab_pool& operator=(slab_pool&&)      = default;
+
+    template <typename... Args>
+    T* create(Args&&... args) {
+        auto slot = _acquire();
+        try {
+            return std::construct_at(reinterpret_cast<T*>(slot), std::forward<Args>(args)...);
+        } catch (...) {
+            _push_free(slot);
+            --_num_live;
+            throw;
+        }
+    }
+
+    void destroy(T* obj) {
+        std::destroy_at(obj);
+        _push_free(reinterpret_cast<Slot*>(obj));
+        --_num_live;
+    }
+
+    /**
+     * @brief Make sure that at least `n` more objects can be created without
+     *        allocating another slab. The missing slots are allocated as one slab.
+     *
+     * @param n
+     */
+    void reserve(size_t n) {
+        auto const available = _num_freed + (_bump_end - _bump);
+        if (available >= n) return;
+        _new_slab(std::max(n - available, SlabSize));
+    }
+
+    /**
+     * @brief Take over the responsibility for destroying `n` objects created
+     *        by `owner`. Their slots join the free list of this pool when they
+     *        are destroyed, so `owner` is kept alive as long as this pool
+     *        refers to it. The statistics count the adopted objects as live
+     *        in this pool, but their slots as part of the capacity of `owner`.
+     *
+     * @param owner
+     * @param n
+     */
+    void adopt(std::shared_ptr<slab_pool> const& owner, size_t n) {
+        if (owner.get() == this) return;
+        owner->_num_live -= n;
+        _num_live += n;
+        _add_upstream(owner);
+    }
+
+    /**
+     * @brief Take over all slabs of `other`. Objects created by `other` stay
+     *        where they are and must afterwards be destroyed through this pool.
+     *        Pools that `other` adopted objects from are taken over as well,
+     *        and merged into this one once nothing else refers to them.
+     *
+     * @param other
+     */
+    void merge(slab_pool&& other) {
+        if (this == &other) return;
+        // the unused tail of other's current slab becomes ordinary free slots
+        while (other._bump != other._bump_end) {
+            other._push_free(other._bump++);
+        }
+        while (other._free_list != nullptr) {
+            auto slot        = other._free_list;
+            other._free_list = slot->next;
+            _push_free(slot);
+        }
+        _slabs.insert(_slabs.end(),
+                      std::make_move_iterator(other._slabs.begin()),
+                      std::make_move_iterator(other._slabs.end()));
+        _capacity += other._capacity;
+        _num_live += other._num_live;
+
+        other._slabs.clear();
+        other._capacity  = 0;
+        other._num_live  = 0;
+        other._num_freed = 0;
+        other._bump      = nullptr;
+        other._bump_end  = nullptr;
+
+        for (auto const& upstream : other._upstream) _add_upstream(upstream);
+        other._upstream.clear();
+        _merge_unshared_upstream();
+    }
+
+    size_t size() const { return _num_live; }
+    bool empty() const { return _num_live == 0; }
+
+    statistics get_statistics() const {
+        return {_slabs.size(), _capacity, _num_live, _num_freed};
+    }
+
+private:
+    union Slot {
+        Slot* next;
+        alignas(T) std::byte storage[sizeof(T)];
+    };
+
+    std::vector<std::unique_ptr<Slot[]>> _slabs;
+    // pools that created some of the objects this pool destroys
+    std::vector<std::shared_ptr<slab_pool>> _upstream;
+    Slot* _free_list = nullptr;
+    Slot* _bump      = nullptr;
+    Slot* _bump_end  = nullptr;
+    size_t _capacity  = 0;
+    size_t _num_live  = 0;
+    size_t _num_freed = 0;
+
+    Slot* _acquire() {
+        ++_num_live;
+        if (_free_list != nullptr) {
+            auto slot  = _free_list;
+            _free_list = slot->next;
+            --_num_freed;
+            return slot;
+        }
+        if (_bump == _bump_end) {
+            _new_slab(SlabSize);
+        }
+        return _bump++;
+    }
+
+    void _push_free(Slot* slot) {
+        slot->next = _free_list;
+        _free_list = slot;
+        ++_num_freed;
+    }
+
+    void _add_upstream(std::shared_ptr<slab_pool> const& pool) {
+        if (pool.get() == this || std::ranges::find(_upstream, pool) != _upstream.end()) return;
+        _upstream.emplace_back(pool);
+    }
+
+    void _merge_unshared_upstream() {
+        while (true) {
+            auto const it = std::ranges::find_if(_upstream, [](auto const& pool) { return pool.use_count() == 1; });
+            if (it == _upstream.end()) return;
+            auto const pool = std::move(*it);
+            _upstream.erase(it);
+            merge(std::move(*pool));
+        }
+    }
+
+    void _new_slab(size_t n) {
+        // the unused tail of the current slab would otherwise be lost
+        while (_bump != _bump_end) {
+            _push_free(_bump++);
+        }
+        _slabs.emplace_back(std::make_unique_for_overwrite<Slot[]>(n));
+        _bump     = _slabs.back().get();
+        _bump_end = _bump + n;
+        _capacity += n;
+    }
+};
+
+}  // namespace utils
+
+}  // namespace dvlab
@@ -0,0 +1,269 @@
+/****************************************************************************
+  PackageName  [ util ]
+  Synopsis     [ Define small_ordered_hashset ]
+  Author       [ Design Verification Lab ]
+  Copyright    [ Copyright(c) 2023 DVLab, GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+/********************** Summary of this data structure **********************
+ *
+ *     small_ordered_hashset is an ordered_hashset with a small-buffer opti-
+ * mization. Up to `N` elements are stored inline, in insertion order, and
+ * looked up by linear search; this needs no heap allocation at all. The
+ * first insertion beyond `N` elements moves everything into a heap-allocated
+ * flat_ordered_hashset, and the set moves back inline once erasures shrink
+ * it to `N / 2` elements. Iteration follows the order of insertion in both
+ * modes.
+ *
+ * Caveats:
+ * 1.  Erasing an inline element shifts the elements after it, so, as with
+ *     ordered_hashset, one should not insert or erase during traversal.
+ *
+ * 2.  Only const iterators are provided, since the elements are the keys.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <utility>
+
+#include "./flat_ordered_hashset.hpp"
+
+namespace dvlab {
+
+namespace utils {
+
+template <typename Key, size_t N, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class small_ordered_hashset final {  // NOLINT(readability-identifier-naming) : small_ordered_hashset intentionally mimics std::unordered_set
+    static_assert(N > 0, "small_ordered_hashset needs a non-empty inline buffer");
+
+public:
+    using key_type        = Key;
+    using value_type      = Key const;
+    using size_type       = size_t;
+    using difference_type = std::ptrdiff_t;
+    using hasher          = Hash;
+    using key_equal       = KeyEqual;
+    using spilled_type    = flat_ordered_hashset<Key, Hash, KeyEqual>;
+
+    class const_iterator {
+    public:
+        using value_type        = Key;
+        using difference_type   = std::ptrdiff_t;
+        using iterator_category = std::bidirectional_iterator_tag;
+
+        const_iterator() {}
+        explicit const_iterator(Key const* ptr) : _ptr(ptr) {}
+        explicit const_iterator(typename spilled_type::iterator const& itr) : _itr(itr), _spilled(true) {}
+
+        const_iterator& operator++() noexcept {
+            if (_spilled) {
+                ++_itr;
+            } else {
+                ++_ptr;
+            }
+            return *this;
+        }
+
+        const_iterator operator++(int) noexcept {
+            const_iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        const_iterator& operator--() noexcept {
+            if (_spilled) {
+                --_itr;
+            } else {
+                --_ptr;
+            }
+            return *this;
+        }
+
+        const_iterator operator--(int) noexcept {
+            const_iterator tmp = *this;
+            --*this;
+            return tmp;
+        }
+
+        bool operator==(const_iterator const& rhs) const noexcept {
+            return _spilled ? (_itr == rhs._itr) : (_ptr == rhs._ptr);
+        }
+        bool operator!=(const_iterator const& rhs) const noexcept { return !(*this == rhs); }
+
+        Key const& operator*() const noexcept { return _spilled ? *_itr : *_ptr; }
+        Key const* operator->() const noexcept { return &**this; }
+
+    private:
+        Key const* _ptr = nullptr;
+        typename spilled_type::iterator _itr;
+        bool _spilled = false;
+    };
+
+    using iterator = const_iterator;
+
+    small_ordered_hashset() = default;
+    ~small_ordered_hashset() = default;
+
+    small_ordered_hashset(std::initializer_list<Key> const& il) : small_ordered_hashset(il.begin(), il.end()) {}
+
+    template <typename InputIt>
+    small_ordered_hashset(InputIt first, InputIt last) { this->insert(first, last); }
+
+    small_ordered_hashset(small_ordered_hashset const& other)
+        : _inline(other._inline),
+          _size(other._size),
+          _spilled(other._spilled ? std::make_unique<spilled_type>(*other._spilled) : nullptr) {}
+
+    small_ordered_hashset(small_ordered_hashset&& other) noexcept
+        : _inline(std::move(other._inline)),
+          _size(std::exchange(other._size, 0)),
+          _spilled(std::move(other._spilled)) {}
+
+    small_ordered_hashset& operator=(small_ordered_hashset copy) noexcept {
+        swap(copy);
+        return *this;
+    }
+
+    void swap(small_ordered_hashset& other) noexcept {
+        std::swap(_inline, other._inline);
+        std::swap(_size, other._size);
+        std::swap(_spilled, other._spilled);
+    }
+
+    friend void swap(small_ordered_hashset& lhs, small_ordered_hashset& rhs) noexcept { lhs.swap(rhs); }
+
+    // iterators
+    const_iterator begin() const noexcept {
+        return _spilled ? const_iterator(_spilled->begin()) : const_iterator(_inline.data());
+    }
+    const_iterator end() const noexcept {
+        return _spilled ? const_iterator(_spilled->end()) : const_iterator(_inline.data() + _size);
+    }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    // lookup
+    const_iterator find(Key const& key) const {
+        if (_spilled) return const_iterator(_spilled->find(key));
+        return const_iterator(_inline.data() + _inline_index(key));
+    }
+    bool contains(Key const& key) const {
+        return _spilled ? _spilled->contains(key) : _inline_index(key) != _size;
+    }
+
+    // properties
+    size_t size() const { return _spilled ? _spilled->size() : _size; }
+    bool empty() const { return this->size() == 0; }
+    /**
+     * @brief Return whether the elements have been moved out of the inline buffer.
+     */
+    bool is_spilled() const { return _spilled != nullptr; }
+
+    // container manipulation
+    void clear() {
+        _spilled.reset();
+        _size = 0;
+    }
+
+    void reserve(size_t n) {
+        if (n <= N && !_spilled) return;
+        if (!_spilled) _spill();
+        _spilled->reserve(n);
+    }
+
+    std::pair<iterator, bool> insert(Key const& value) { return this->emplace(value); }
+
+    template <typename InputIt>
+    void insert(InputIt first, InputIt last) {
+        for (auto itr = first; itr != last; ++itr) {
+            this->emplace(*itr);
+        }
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Args&&... args);
+
+    size_t erase(Key const& key);
+    size_t erase(const_iterator const& itr) { return this->erase(Key{*itr}); }
+
+private:
+    std::array<Key, N> _inline = {};
+    size_t _size               = 0;  // number of inline elements; unused once spilled
+    std::unique_ptr<spilled_type> _spilled;
+
+    void _spill() {
+        _spilled = std::make_unique<spilled_type>();
+        _spilled->reserve(2 * N);
+        _spilled->insert(std::make_move_iterator(_inline.begin()), std::make_move_iterator(_inline.begin() + _size));
+        _size = 0;
+    }
+
+    size_t _inline_index(Key const& key) const {
+        auto const last = _inline.begin() + _size;
+        return static_cast<size_t>(std::find_if(_inline.begin(), last, [&key](Key const& item) { return key_equal{}(item, key); }) - _inline.begin());
+    }
+};
+
+/**
+ * @brief Emplace an element to the set. The element is stored inline if
+ *        there is room; otherwise the set is spilled to the heap.
+ *
+ * @return std::pair<iterator, bool>. The iterator points to the element with
+ *         the same key, and the bool indicates whether the insertion happened.
+ */
+template <typename Key, size_t N, typename Hash, typename KeyEqual>
+template <typename... Args>
+std::pair<typename small_ordered_hashset<Key, N, Hash, KeyEqual>::iterator, bool>
+small_ordered_hashset<Key, N, Hash, KeyEqual>::emplace(Args&&... args) {
+    Key value(std::forward<Args>(args)...);
+    if (!_spilled) {
+        auto const idx = _inline_index(value);
+        if (idx != _size) return {const_iterator(_inline.data() + idx), false};
+        if (_size < N) {
+            _inline[_size] = std::move(value);
+            return {const_iterator(_inline.data() + _size++), true};
+        }
+        _spill();
+    }
+    auto const [itr, inserted] = _spilled->emplace(std::move(value));
+    return {const_iterator(itr), inserted};
+}
+
+/**
+ * @brief Erase the element with the given key.
+ *
+ * @return size_t : the number of element deleted
+ */
+template <typename Key, size_t N, typename Hash, typename KeyEqual>
+size_t small_ordered_hashset<Key, N, Hash, KeyEqual>::erase(Key const& key) {
+    if (_spilled) {
+        if (_spilled->erase(key) == 0) return 0;
+        if (_spilled->size() <= N / 2) {
+            _size = 0;
+            for (auto const& item : std::as_const(*_spilled)) {
+                _inline[_size++] = item;
+            }
+            _spilled.reset();
+        }
+        return 1;
+    }
+    auto const idx = _inline_index(key);
+    if (idx == _size) return 0;
+    std::move(_inline.begin() + idx + 1, _inline.begin() + _size, _inline.begin() + idx);
+    --_size;
+    return 1;
+}
+
+static_assert(std::ranges::bidirectional_range<small_ordered_hashset<int, 4>>);
+static_assert(std::ranges::sized_range<small_ordered_hashset<int, 4>>);
+
+}  // namespace utils
+
+}  // namespace dvlab
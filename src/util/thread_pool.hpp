@@ -0,0 +1,148 @@
+/****************************************************************************
+  PackageName  [ util ]
+  Synopsis     [ Define thread_pool, a fixed set of workers for fork-join loops ]
+  Author       [ Design Verification Lab ]
+  Copyright    [ Copyright(c) 2023 DVLab, GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+/********************** Summary of this data structure **********************
+ *
+ *     thread_pool keeps `num_threads - 1` workers alive and runs fork-join
+ * loops on them. `parallel_for(n, f)` calls `f(i)` for every i in [0, n)
+ * and returns only after all calls have finished; the calling thread takes
+ * part in the work, so a pool of one thread runs everything inline. If the
+ * workers are busy with another loop, e.g., when `parallel_for` is called
+ * from inside a task, the tasks also run inline instead of waiting.
+ *
+ *     The tasks are handed out in increasing order of i, but nothing is
+ * guaranteed about which thread runs which task. Callers that need
+ * reproducible results should write each task's output to its own slot and
+ * combine the slots in order afterwards.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dvlab {
+
+namespace utils {
+
+class thread_pool {  // NOLINT(readability-identifier-naming) : thread_pool intentionally mimics std utilities
+public:
+    explicit thread_pool(size_t num_threads = 1) {
+        num_threads = std::max(num_threads, size_t{1});
+        _workers.reserve(num_threads - 1);
+        for (size_t i = 1; i < num_threads; ++i) {
+            _workers.emplace_back([this] { _worker_loop(); });
+        }
+    }
+
+    ~thread_pool() {
+        {
+            std::lock_guard lock{_mutex};
+            _shutting_down = true;
+        }
+        _work_available.notify_all();
+        for (auto& worker : _workers) worker.join();
+    }
+
+    thread_pool(thread_pool const&)            = delete;
+    thread_pool& operator=(thread_pool const&) = delete;
+    thread_pool(thread_pool&&)                 = delete;
+    thread_pool& operator=(thread_pool&&)      = delete;
+
+    size_t num_threads() const { return _workers.size() + 1; }
+
+    /**
+     * @brief Call `f(i)` for every i in [0, n) on the threads of the pool and
+     *        wait for all of them. If any call throws, the first exception is
+     *        rethrown here after the others have finished.
+     *
+     * @param n
+     * @param f
+     */
+    void parallel_for(size_t n, std::function<void(size_t)> const& f) {
+        if (n == 0) return;
+        // only one loop may use the workers at a time
+        if (_workers.empty() || n == 1 || _in_use.test_and_set()) {
+            for (size_t i = 0; i < n; ++i) f(i);
+            return;
+        }
+
+        {
+            std::lock_guard lock{_mutex};
+            _task      = &f;
+            _num_tasks = n;
+            _next_task.store(0);
+            _num_busy  = _workers.size();
+            _exception = nullptr;
+            ++_generation;
+        }
+        _work_available.notify_all();
+
+        _run_tasks();
+
+        std::unique_lock lock{_mutex};
+        _work_done.wait(lock, [this] { return _num_busy == 0; });
+        _task = nullptr;
+        _in_use.clear();
+        if (_exception) std::rethrow_exception(_exception);
+    }
+
+private:
+    std::vector<std::thread> _workers;
+    std::atomic_flag _in_use;
+    std::mutex _mutex;
+    std::condition_variable _work_available;
+    std::condition_variable _work_done;
+
+    std::function<void(size_t)> const* _task = nullptr;
+    size_t _num_tasks                        = 0;
+    std::atomic<size_t> _next_task           = 0;
+    size_t _num_busy                         = 0;
+    size_t _generation                       = 0;
+    bool _shutting_down                      = false;
+    std::exception_ptr _exception;
+
+    void _run_tasks() {
+        for (auto i = _next_task.fetch_add(1); i < _num_tasks; i = _next_task.fetch_add(1)) {
+            try {
+                (*_task)(i);
+            } catch (...) {
+                std::lock_guard lock{_mutex};
+                if (!_exception) _exception = std::current_exception();
+            }
+        }
+    }
+
+    void _worker_loop() {
+        size_t seen_generation = 0;
+        while (true) {
+            {
+                std::unique_lock lock{_mutex};
+                _work_available.wait(lock, [&] { return _shutting_down || _generation != seen_generation; });
+                if (_shutting_down) return;
+                seen_generation = _generation;
+            }
+
+            _run_tasks();
+
+            std::lock_guard lock{_mutex};
+            if (--_num_busy == 0) _work_done.notify_one();
+        }
+    }
+};
+
+}  // namespace utils
+
+}  // namespace dvlab
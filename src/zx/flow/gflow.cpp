@@ -246,10 +246,6 @@ dvlab::BooleanMatrix GFlow::_prepare_matrix(ZXVertex* v, size_t i, dvlab::Boolea
         ++itr;
     }
 
-    for (size_t j = 0; j < augmented_matrix.num_rows(); ++j) {
-        augmented_matrix[j][augmented_matrix.num_cols() - 1] %= 2;
-    }
-
     return augmented_matrix;
 }
 
@@ -1,28 +1,76 @@
+#include <spdlog/spdlog.h>
+
 #include <algorithm>
+#include <chrono>
 #include <cstddef>
+#include <thread>
+#include <tl/enumerate.hpp>
 #include <util/util.hpp>
 
 #include "./rules/zx_rules_template.hpp"
 #include "./simplify.hpp"
+#include "util/thread_pool.hpp"
 #include "zx/zx_partition.hpp"
 #include "zx/zxgraph.hpp"
 
 namespace qsyn::zx::simplify {
 
+namespace {
+
+struct PartitionReport {
+    size_t num_vertices_before = 0;
+    size_t num_vertices_after  = 0;
+    size_t t_count_after       = 0;
+    long long duration_us      = 0;
+};
+
+}  // namespace
+
 /**
  * @brief partition the graph into 2^numPartitions partitions and reduce each partition separately
  *        then merge the partitions together for n rounds (experimental)
  *
  * @param numPartitions number of partitions to create
- * @param iterations number of iterations
+ * @param n_threads number of partitions to reduce concurrently; 0 means one per hardware core
  */
-void partition_reduce(ZXGraph& g, size_t n_partitions) {
+void partition_reduce(ZXGraph& g, size_t n_partitions, size_t n_threads) {
+    using namespace std::chrono;
+    TracedScope const trace{g, "routine", "partition_reduce"};
     hadamard_rule_simp(g);
     auto const partitions        = kl_partition(g, n_partitions);
     auto const [subgraphs, cuts] = ZXGraph::create_subgraphs(std::move(g), partitions);
 
-    for (auto& graph : subgraphs) {
-        dynamic_reduce(*graph);
+    if (n_threads == 0) {
+        n_threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    // the subgraphs share no vertices and allocate from their own vertex pools,
+    // so they can be reduced concurrently
+    std::vector<PartitionReport> reports(subgraphs.size());
+    dvlab::utils::thread_pool pool{std::min(n_threads, subgraphs.size())};
+    pool.parallel_for(subgraphs.size(), [&](size_t i) {
+        auto const start = high_resolution_clock::now();
+        auto context      = trace.nested_context();
+        context.partition = i;
+        TraceContextGuard const guard{*subgraphs[i], context};
+
+        reports[i].num_vertices_before = subgraphs[i]->num_vertices();
+        dynamic_reduce(*subgraphs[i]);
+        reports[i].num_vertices_after = subgraphs[i]->num_vertices();
+        reports[i].t_count_after      = t_count(*subgraphs[i]);
+
+        reports[i].duration_us = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+    });
+
+    // report after all partitions are done so that the order is fixed
+    for (auto const& [i, report] : tl::views::enumerate(reports)) {
+        spdlog::info(
+            "Partition {}: {} -> {} vertices, T-count {}, {:.3f} ms",
+            i,
+            report.num_vertices_before,
+            report.num_vertices_after,
+            report.t_count_after,
+            static_cast<double>(report.duration_us) / 1'000.0);
     }
 
     g = ZXGraph::from_subgraphs(subgraphs, cuts);
@@ -24,31 +24,24 @@ using MatchType = HadamardRule::MatchType;
 std::vector<MatchType> HadamardRule::find_matches(
     ZXGraph const& graph,
     std::optional<ZXVertexList> candidates) const {
-    std::vector<MatchType> matches;
-
+    auto const scan_order = _scan_order(graph, candidates);
     if (!candidates.has_value()) {
         candidates = graph.get_vertices();
     }
 
     // Find all H-boxes
-    for (auto const& v : graph.get_vertices()) {
-        if (!v->is_hbox() || graph.num_neighbors(v) != 2) continue;
-
-        auto [nv0, _0] = graph.get_first_neighbor(v);
-        auto [nv1, _1] = graph.get_second_neighbor(v);
-
-        if (!candidates->contains(nv0) || !candidates->contains(nv1)) continue;
+    auto proposals = _propose_in_parallel<MatchProposal<MatchType>>(
+        scan_order,
+        [&](ZXVertex* v, std::vector<MatchProposal<MatchType>>& out) {
+            if (!v->is_hbox() || graph.num_neighbors(v) != 2) return;
 
-        matches.emplace_back(v);
+            auto [nv0, _0] = graph.get_first_neighbor(v);
+            auto [nv1, _1] = graph.get_second_neighbor(v);
 
-        if (_allow_overlapping_candidates) continue;
-
-        candidates->erase(v);
-        candidates->erase(nv0);
-        candidates->erase(nv1);
-    }
+            out.push_back({v, {nv0, nv1, v}, 2});
+        });
 
-    return matches;
+    return _resolve_conflicts(std::move(proposals), *candidates, _allow_overlapping_candidates);
 }
 
 void HadamardRule::apply(ZXGraph& graph, std::vector<MatchType> const& matches) const {
@@ -22,27 +22,22 @@ using MatchType = IdentityRemovalRule::MatchType;
  */
 std::vector<MatchType> IdentityRemovalRule::find_matches(
     ZXGraph const& graph, std::optional<ZXVertexList> candidates) const {
-    std::vector<MatchType> matches;
-
+    auto const scan_order = _scan_order(graph, candidates);
     if (!candidates.has_value()) {
         candidates = graph.get_vertices();
     }
 
-    for (auto const& v : graph.get_vertices()) {
-        if (!candidates->contains(v)) continue;
-
-        if (v->phase() != Phase(0)) continue;
-        if (!v->is_zx()) continue;
-        if (graph.num_neighbors(v) != 2) continue;
-
-        matches.emplace_back(v->get_id());
+    auto proposals = _propose_in_parallel<MatchProposal<MatchType>>(
+        scan_order,
+        [&](ZXVertex* v, std::vector<MatchProposal<MatchType>>& out) {
+            if (v->phase() != Phase(0)) return;
+            if (!v->is_zx()) return;
+            if (graph.num_neighbors(v) != 2) return;
 
-        if (_allow_overlapping_candidates) continue;
-
-        candidates->erase(v);
-        candidates->erase(graph.get_first_neighbor(v).first);
-        candidates->erase(graph.get_second_neighbor(v).first);
-    }
+            out.push_back({MatchType{v->get_id()},
+                           {v, graph.get_first_neighbor(v).first, graph.get_second_neighbor(v).first},
+                           1});
+        });
 
-    return matches;
+    return _resolve_conflicts(std::move(proposals), *candidates, _allow_overlapping_candidates);
 }
@@ -25,40 +25,34 @@ using MatchType = LocalComplementRule::MatchType;
 std::vector<MatchType> LocalComplementRule::find_matches(
     ZXGraph const& graph,
     std::optional<ZXVertexList> candidates) const {
-    std::vector<MatchType> matches;
-
+    auto const scan_order = _scan_order(graph, candidates);
     if (!candidates.has_value()) {
         candidates = graph.get_vertices();
     }
 
-    for (auto const& v : graph.get_vertices()) {
-        if (!candidates->contains(v)) continue;
-        if (!v->is_z()) continue;
-        if (v->phase().denominator() != 2) continue;
-
-        if (std::ranges::any_of(
-                graph.get_neighbors(v),
-                [&](auto const& epair) {
-                    auto const& [nb, etype] = epair;
-                    return etype != EdgeType::hadamard ||
-                           !nb->is_z() ||
-                           !candidates->contains(nb);
-                })) {
-            continue;
-        }
-
-        for (auto const& [nb, _] : graph.get_neighbors(v)) {
-            if (!_allow_overlapping_candidates) {
-                candidates->erase(nb);
+    auto proposals = _propose_in_parallel<MatchProposal<MatchType>>(
+        scan_order,
+        [&](ZXVertex* v, std::vector<MatchProposal<MatchType>>& out) {
+            if (!v->is_z()) return;
+            if (v->phase().denominator() != 2) return;
+
+            if (std::ranges::any_of(
+                    graph.get_neighbors(v),
+                    [&](auto const& epair) {
+                        auto const& [nb, etype] = epair;
+                        return etype != EdgeType::hadamard || !nb->is_z();
+                    })) {
+                return;
             }
-        }
 
-        matches.emplace_back(v->get_id());
+            // v and all its neighbors have to be available
+            std::vector<ZXVertex*> footprint{v};
+            footprint.reserve(graph.num_neighbors(v) + 1);
+            for (auto const& [nb, _] : graph.get_neighbors(v)) footprint.emplace_back(nb);
+            auto const num_required = footprint.size();
 
-        if (!_allow_overlapping_candidates) {
-            candidates->erase(v);
-        }
-    }
+            out.push_back({MatchType{v->get_id()}, std::move(footprint), num_required});
+        });
 
-    return matches;
+    return _resolve_conflicts(std::move(proposals), *candidates, _allow_overlapping_candidates);
 }
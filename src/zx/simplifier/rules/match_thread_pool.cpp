@@ -0,0 +1,48 @@
+/****************************************************************************
+  PackageName  [ simplifier ]
+  Synopsis     [ Define the thread pool shared by the rule matchers ]
+  Author       [ Design Verification Lab ]
+  Copyright    [ Copyright(c) 2023 DVLab, GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+
+#include "./zx_rules_template.hpp"
+
+namespace qsyn::zx {
+
+namespace {
+
+// a function-local static, so that concurrent first calls initialize it only once
+std::unique_ptr<dvlab::utils::thread_pool>& match_thread_pool_holder() {
+    static auto pool = std::make_unique<dvlab::utils::thread_pool>(1);
+    return pool;
+}
+
+}  // namespace
+
+/**
+ * @brief Set the number of threads the rules use to find matches. Must not be
+ *        called while a rule is looking for matches.
+ *
+ * @param n_threads 0 means one thread per hardware core
+ */
+void set_num_match_threads(size_t n_threads) {
+    if (n_threads == 0) {
+        n_threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    if (get_num_match_threads() == n_threads) return;
+    match_thread_pool_holder() = std::make_unique<dvlab::utils::thread_pool>(n_threads);
+}
+
+size_t get_num_match_threads() {
+    return match_thread_pool_holder()->num_threads();
+}
+
+dvlab::utils::thread_pool& match_thread_pool() {
+    return *match_thread_pool_holder();
+}
+
+}  // namespace qsyn::zx
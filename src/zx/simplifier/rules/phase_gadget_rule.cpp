@@ -34,9 +34,7 @@ struct ZXVerticesHash {
  */
 std::vector<MatchType> PhaseGadgetRule::find_matches(
     ZXGraph const& graph, std::optional<ZXVertexList> candidates) const {
-    if (!candidates.has_value()) {
-        candidates = graph.get_vertices();
-    }
+    auto const scan_order = _scan_order(graph, candidates);
 
     std::vector<MatchType> matches;
 
@@ -45,26 +43,40 @@ std::vector<MatchType> PhaseGadgetRule::find_matches(
 
     std::vector<ZXVertex*> axels;
     std::vector<ZXVertex*> leaves;
-    for (auto const& v : graph.get_vertices()) {
-        if (!candidates->contains(v)) continue;
-        if (v->phase().denominator() <= 2 || graph.num_neighbors(v) != 1) continue;
 
-        ZXVertex* nb = graph.get_first_neighbor(v).first;
+    struct GadgetProposal {
+        ZXVertex* leaf;
+        ZXVertex* axel;
+        std::vector<ZXVertex*> group;  // the neighbors of the axel other than the leaf, sorted
+    };
 
-        if (nb->phase().denominator() != 1) continue;
-        if (nb->is_boundary()) continue;
-        if (axel2leaf.contains(nb)) continue;
+    // collecting the groups is the expensive part, so it is done in parallel
+    auto const proposals = _propose_in_parallel<GadgetProposal>(
+        scan_order,
+        [&](ZXVertex* v, std::vector<GadgetProposal>& out) {
+            if (v->phase().denominator() <= 2 || graph.num_neighbors(v) != 1) return;
 
-        axel2leaf[nb] = v;
+            ZXVertex* nb = graph.get_first_neighbor(v).first;
 
-        std::vector<ZXVertex*> group;
+            if (nb->phase().denominator() != 1) return;
+            if (nb->is_boundary()) return;
 
-        for (auto& [nb2, _] : graph.get_neighbors(nb)) {
-            if (nb2 != v) group.emplace_back(nb2);
-        }
+            std::vector<ZXVertex*> group;
 
-        if (!group.empty()) {
+            for (auto& [nb2, _] : graph.get_neighbors(nb)) {
+                if (nb2 != v) group.emplace_back(nb2);
+            }
             std::ranges::sort(group);
+
+            out.push_back({v, nb, std::move(group)});
+        });
+
+    for (auto const& [v, nb, group] : proposals) {
+        if (axel2leaf.contains(nb)) continue;
+
+        axel2leaf[nb] = v;
+
+        if (!group.empty()) {
             if (group2axel.contains(group)) {
                 group2axel.at(group).emplace_back(nb);
             } else {
@@ -80,12 +92,13 @@ std::vector<MatchType> PhaseGadgetRule::find_matches(
         bool flip_axel   = false;
         for (auto const& axel : tmp_axels) {
             ZXVertex* const& leaf = axel2leaf[axel];
+            // an axel with phase pi is flipped to 0 by negating its leaf; `apply` does the flip
             if (axel->phase() == Phase(1)) {
-                flip_axel     = true;
-                axel->phase() = Phase(0);
-                leaf->phase() = (-1) * axel2leaf[axel]->phase();
+                flip_axel = true;
+                total_phase -= leaf->phase();
+            } else {
+                total_phase += leaf->phase();
             }
-            total_phase += axel2leaf[axel]->phase();
             axels.emplace_back(axel);
             leaves.emplace_back(axel2leaf[axel]);
         }
@@ -106,7 +119,8 @@ void PhaseGadgetRule::apply(ZXGraph& graph, std::vector<MatchType> const& matche
         std::vector<ZXVertex*> const& rm_axels  = get<1>(match);
         std::vector<ZXVertex*> const& rm_leaves = get<2>(match);
         ZXVertex* leaf                          = rm_leaves[0];
-        leaf->phase()                           = new_phase;
+        if (rm_axels[0]->phase() == Phase(1)) graph.set_phase(rm_axels[0], Phase(0));
+        graph.set_phase(leaf, new_phase);
         op.vertices_to_remove.insert(std::end(op.vertices_to_remove), std::begin(rm_axels) + 1, std::end(rm_axels));
         op.vertices_to_remove.insert(std::end(op.vertices_to_remove), std::begin(rm_leaves) + 1, std::end(rm_leaves));
     }
@@ -23,19 +23,17 @@ using MatchType = PivotRule::MatchType;
 std::vector<MatchType> PivotRule::find_matches(
     ZXGraph const& graph,
     std::optional<ZXVertexList> candidates) const {
-    std::vector<MatchType> matches;
-
+    auto const scan_order = _scan_order(graph, candidates);
     if (!candidates.has_value()) {
         candidates = graph.get_vertices();
     }
 
-    graph.for_each_edge([&](EdgePair const& epair) {
+    auto const propose = [&](EdgePair const& epair, std::vector<MatchProposal<MatchType>>& out) {
         if (epair.second != EdgeType::hadamard) return;
 
         // 2: Get Neighbors
         auto [vs, vt] = epair.first;
 
-        if (!candidates->contains(vs) || !candidates->contains(vt)) return;
         if (!vs->is_z() || !vt->is_z()) return;
 
         // 3: Check Neighbors Phase
@@ -55,16 +53,20 @@ std::vector<MatchType> PivotRule::find_matches(
                 }
             }
         }
-        matches.emplace_back(vs->get_id(), vt->get_id());
 
-        if (_allow_overlapping_candidates) return;
+        std::vector<ZXVertex*> footprint{vs, vt};
+        footprint.reserve(graph.num_neighbors(vs) + graph.num_neighbors(vt) + 2);
+        for (auto& [v, _] : graph.get_neighbors(vs)) footprint.emplace_back(v);
+        for (auto& [v, _] : graph.get_neighbors(vt)) footprint.emplace_back(v);
 
-        candidates->erase(vs);
-        candidates->erase(vt);
+        out.push_back({MatchType{vs->get_id(), vt->get_id()}, std::move(footprint), 2});
+    };
 
-        for (auto& [v, _] : graph.get_neighbors(vs)) candidates->erase(v);
-        for (auto& [v, _] : graph.get_neighbors(vt)) candidates->erase(v);
-    });
+    auto proposals = _propose_in_parallel<MatchProposal<MatchType>>(
+        scan_order,
+        [&](ZXVertex* v, std::vector<MatchProposal<MatchType>>& out) {
+            _for_each_edge_from(graph, v, [&](EdgePair const& epair) { propose(epair, out); });
+        });
 
-    return matches;
+    return _resolve_conflicts(std::move(proposals), *candidates, _allow_overlapping_candidates);
 }
@@ -21,32 +21,31 @@ using MatchType = SpiderFusionRule::MatchType;
 std::vector<MatchType> SpiderFusionRule::find_matches(
     ZXGraph const& graph,
     std::optional<ZXVertexList> candidates) const {
-    std::vector<MatchType> match_type_vec;
-
+    auto const scan_order = _scan_order(graph, candidates);
     if (!candidates.has_value()) {
         candidates = graph.get_vertices();
     }
 
-    graph.for_each_edge([&](EdgePair const& epair) {
-        if (epair.second != EdgeType::simple) return;
-        ZXVertex* v0 = epair.first.first;
-        ZXVertex* v1 = epair.first.second;  // to be merged to v0
+    auto proposals = _propose_in_parallel<MatchProposal<MatchType>>(
+        scan_order,
+        [&](ZXVertex* v, std::vector<MatchProposal<MatchType>>& out) {
+            _for_each_edge_from(graph, v, [&](EdgePair const& epair) {
+                if (epair.second != EdgeType::simple) return;
+                ZXVertex* v0 = epair.first.first;
+                ZXVertex* v1 = epair.first.second;  // to be merged to v0
 
-        if (!candidates->contains(v0) || !candidates->contains(v1)) return;
+                if ((v0->type() != v1->type()) || !(v0->is_x() || v0->is_z())) return;
 
-        if ((v0->type() == v1->type()) && (v0->is_x() || v0->is_z())) {
-            match_type_vec.emplace_back(v0, v1);
-            if (_allow_overlapping_candidates) return;
-            candidates->erase(v0);
-            candidates->erase(v1);
-            // NOTE: Cannot choose the vertex connected to the vertices that will be merged
-            for (auto& [nb, _] : graph.get_neighbors(v1)) {
-                candidates->erase(nb);
-            }
-        }
-    });
+                // NOTE: Cannot choose the vertex connected to the vertices that will be merged
+                std::vector<ZXVertex*> footprint{v0, v1};
+                footprint.reserve(graph.num_neighbors(v1) + 2);
+                for (auto& [nb, _] : graph.get_neighbors(v1)) footprint.emplace_back(nb);
+
+                out.push_back({{v0, v1}, std::move(footprint), 2});
+            });
+        });
 
-    return match_type_vec;
+    return _resolve_conflicts(std::move(proposals), *candidates, _allow_overlapping_candidates);
 }
 
 /**
@@ -58,7 +57,7 @@ void SpiderFusionRule::apply(ZXGraph& graph, std::vector<MatchType> const& match
     ZXOperation op;
 
     for (auto [v0, v1] : matches) {
-        v0->phase() += v1->phase();
+        graph.set_phase(v0, v0->phase() + v1->phase());
 
         for (auto& [neighbor, edgeType] : graph.get_neighbors(v1)) {
             if (neighbor == v0) continue;
@@ -83,7 +83,7 @@ void StateCopyRule::apply(ZXGraph& graph, std::vector<MatchType> const& matches)
                 op.edges_to_add.emplace_back(std::make_pair(a, new_v), EdgeType::hadamard);
 
             } else {
-                neighbor->phase() += npi->phase();
+                graph.set_phase(neighbor, neighbor->phase() + npi->phase());
             }
         }
     }
@@ -7,14 +7,41 @@
 
 #pragma once
 
+#include <algorithm>
+#include <optional>
+#include <ranges>
 #include <string>
 #include <vector>
 
+#include "util/thread_pool.hpp"
 #include "zx/zxgraph.hpp"
 #include "zx/zxgraph_action.hpp"
 
 namespace qsyn::zx {
 
+/**
+ * @brief Set the number of threads the rules use to find matches. The matches
+ *        found do not depend on this number.
+ *
+ * @param n_threads 0 means one thread per hardware core
+ */
+void set_num_match_threads(size_t n_threads);
+size_t get_num_match_threads();
+dvlab::utils::thread_pool& match_thread_pool();
+
+/**
+ * @brief A match found by the parallel scan, before the conflicts between
+ *        matches are resolved.
+ *
+ * @tparam Match
+ */
+template <typename Match>
+struct MatchProposal {
+    Match match;
+    std::vector<ZXVertex*> footprint;  // the vertices the match reserves
+    size_t num_required;               // the first `num_required` vertices of the footprint must not be reserved by earlier matches
+};
+
 struct ZXOperation {
     // std::vector<ZXVertex*> vertices_to_add;
     std::vector<EdgePair> edges_to_add;
@@ -27,7 +54,116 @@ public:
     virtual ~ZXRuleBase()                = default;
     virtual std::string get_name() const = 0;
 
+    /**
+     * @brief If every match that can appear after `apply` lies within this
+     *        distance of a changed vertex (see ZXGraph::start_change_log),
+     *        the simplifier only rescans that region in later rounds.
+     *        Such rules must scan `candidates` in graph order so that the
+     *        matches found are exactly those of a full scan.
+     *
+     * @return std::optional<size_t> the radius, or std::nullopt if the whole
+     *         graph has to be rescanned every round
+     */
+    virtual std::optional<size_t> match_radius() const { return std::nullopt; }
+
 protected:
+    /**
+     * @brief Get the vertices to scan for matches in the order they appear in
+     *        the graph, regardless of the order of `candidates`.
+     *
+     * @param graph
+     * @param candidates if not specified, all vertices of the graph
+     * @return std::vector<ZXVertex*>
+     */
+    static std::vector<ZXVertex*> _scan_order(ZXGraph const& graph, std::optional<ZXVertexList> const& candidates) {
+        if (!candidates.has_value()) {
+            return {graph.get_vertices().begin(), graph.get_vertices().end()};
+        }
+        std::vector<ZXVertex*> order;
+        order.reserve(candidates->size());
+        for (auto const& v : *candidates) {
+            if (graph.get_vertices().contains(v)) order.emplace_back(v);
+        }
+        std::ranges::sort(order, {}, [&graph](ZXVertex* v) { return graph.get_vertices().id(v); });
+        return order;
+    }
+
+    /**
+     * @brief Visit the edges from `v` to the neighbors with larger IDs, in the
+     *        same order as ZXGraph::for_each_edge.
+     */
+    template <typename F>
+    static void _for_each_edge_from(ZXGraph const& graph, ZXVertex* v, F lambda) {
+        for (auto const& [nb, etype] : graph.get_neighbors(v)) {
+            if (nb->get_id() > v->get_id())
+                lambda(make_edge_pair(v, nb, etype));
+        }
+    }
+
+    /**
+     * @brief Call `propose(v, proposals)` for every vertex in `scan_order`,
+     *        splitting the vertices into shards that are scanned in parallel.
+     *        `propose` must only read the graph. The proposals are returned in
+     *        the same order as a sequential scan would have produced them.
+     *
+     * @param scan_order
+     * @param propose
+     */
+    template <typename Proposal, typename F>
+    static std::vector<Proposal> _propose_in_parallel(std::vector<ZXVertex*> const& scan_order, F const& propose) {
+        // below this, waking up the workers costs more than the scan itself
+        constexpr size_t min_shard_size = 1024;
+
+        auto& pool            = match_thread_pool();
+        auto const num_shards = std::min(pool.num_threads() * 4, (scan_order.size() + min_shard_size - 1) / min_shard_size);
+
+        if (num_shards <= 1) {
+            std::vector<Proposal> proposals;
+            for (auto const& v : scan_order) propose(v, proposals);
+            return proposals;
+        }
+
+        std::vector<std::vector<Proposal>> shards(num_shards);
+        pool.parallel_for(num_shards, [&](size_t i) {
+            auto const first = scan_order.size() * i / num_shards;
+            auto const last  = scan_order.size() * (i + 1) / num_shards;
+            for (size_t j = first; j < last; ++j) propose(scan_order[j], shards[i]);
+        });
+
+        auto proposals = std::move(shards.front());
+        for (auto& shard : shards | std::views::drop(1)) {
+            proposals.insert(proposals.end(), std::make_move_iterator(shard.begin()), std::make_move_iterator(shard.end()));
+        }
+        return proposals;
+    }
+
+    /**
+     * @brief Accept the proposals greedily in order, skipping those that
+     *        require a vertex already reserved by an earlier match. This is
+     *        what the sequential scans do, so the result does not depend on
+     *        the number of threads.
+     *
+     * @param proposals
+     * @param candidates the vertices not reserved yet; updated in place
+     * @param allow_overlapping if true, accepted matches do not reserve their footprints
+     */
+    template <typename Match>
+    static std::vector<Match> _resolve_conflicts(
+        std::vector<MatchProposal<Match>>&& proposals, ZXVertexList& candidates, bool allow_overlapping) {
+        std::vector<Match> matches;
+        for (auto& [match, footprint, num_required] : proposals) {
+            if (!std::ranges::all_of(
+                    footprint | std::views::take(num_required),
+                    [&](ZXVertex* v) { return candidates.contains(v); })) {
+                continue;
+            }
+            matches.emplace_back(std::move(match));
+            if (allow_overlapping) continue;
+            for (auto const& v : footprint) candidates.erase(v);
+        }
+        return matches;
+    }
+
     void _update(ZXGraph& graph, ZXOperation const& op) const {
         // TODO: add vertices is not implemented yet
         for (auto& edge : op.edges_to_add) {
@@ -129,6 +265,7 @@ private:
 class IdentityRemovalRule : public ZXRuleMatcher<IdentityRemoval> {
 public:
     std::string get_name() const override { return "Identity Removal Rule"; }
+    std::optional<size_t> match_radius() const override { return 2; }
     std::vector<MatchType> find_matches(
         ZXGraph const& graph,
         std::optional<ZXVertexList> candidates = std::nullopt) const override;
@@ -140,6 +277,7 @@ private:
 class LocalComplementRule : public ZXRuleMatcher<LComp> {
 public:
     std::string get_name() const override { return "Local Complementation Rule"; }
+    std::optional<size_t> match_radius() const override { return 2; }
     std::vector<MatchType> find_matches(
         ZXGraph const& graph,
         std::optional<ZXVertexList> candidates = std::nullopt) const override;
@@ -175,6 +313,7 @@ private:
 class PivotRule : public ZXRuleMatcher<Pivot> {
 public:
     std::string get_name() const override { return "Pivot Rule"; }
+    std::optional<size_t> match_radius() const override { return 2; }
     std::vector<MatchType> find_matches(
         ZXGraph const& graph,
         std::optional<ZXVertexList> candidates = std::nullopt) const override;
@@ -209,6 +348,7 @@ private:
 class SpiderFusionRule : public ZXRuleTemplate<std::pair<ZXVertex*, ZXVertex*>> {
 public:
     std::string get_name() const override { return "Spider Fusion Rule"; }
+    std::optional<size_t> match_radius() const override { return 2; }
     std::vector<MatchType> find_matches(
         ZXGraph const& graph,
         std::optional<ZXVertexList> candidates = std::nullopt) const override;
@@ -221,6 +361,7 @@ private:
 class HadamardRule : public ZXRuleTemplate<ZXVertex*> {
 public:
     std::string get_name() const override { return "Hadamard Rule"; }
+    std::optional<size_t> match_radius() const override { return 2; }
     std::vector<MatchType> find_matches(
         ZXGraph const& graph,
         std::optional<ZXVertexList> candidates = std::nullopt) const override;
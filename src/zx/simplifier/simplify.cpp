@@ -32,6 +32,88 @@ void report_simplification_result(
     }
 }
 
+/**
+ * @brief Collect the vertices within `radius` of the dirty vertices. If the
+ *        region grows beyond a quarter of the graph, scanning the whole graph
+ *        is about as cheap as maintaining the candidate list.
+ *
+ * @param g
+ * @param dirty_vertices
+ * @param radius
+ * @return std::optional<ZXVertexList> the region, or std::nullopt to scan
+ *         the whole graph
+ */
+std::optional<ZXVertexList> dirty_region(
+    ZXGraph const& g, std::vector<ZXVertex*> const& dirty_vertices, size_t radius) {
+    auto const max_size = g.num_vertices() / 4;
+    if (dirty_vertices.size() > max_size) return std::nullopt;
+
+    ZXVertexList region{dirty_vertices.begin(), dirty_vertices.end()};
+    auto frontier = dirty_vertices;
+
+    for (size_t d = 0; d < radius && !frontier.empty(); ++d) {
+        std::vector<ZXVertex*> next_frontier;
+        for (auto const& v : frontier) {
+            for (auto const& [nb, _] : g.get_neighbors(v)) {
+                if (!region.emplace(nb).second) continue;
+                if (region.size() > max_size) return std::nullopt;
+                next_frontier.emplace_back(nb);
+            }
+        }
+        frontier = std::move(next_frontier);
+    }
+
+    return region;
+}
+
+IncrementalScan::IncrementalScan(ZXGraph& g, std::string name, std::optional<size_t> radius)
+    : _graph{g}, _name{std::move(name)}, _radius{radius} {
+    if (!_radius.has_value()) return;
+    if (_graph.is_logging_changes()) {
+        _position = _graph.get_change_log_bookmark(_name);
+    } else {
+        _graph.start_change_log();
+        _owns_change_log = true;
+    }
+}
+
+IncrementalScan::~IncrementalScan() {
+    if (!_radius.has_value()) return;
+    if (_owns_change_log) {
+        _graph.stop_change_log();
+    } else if (_position.has_value()) {
+        _graph.set_change_log_bookmark(_name, *_position);
+    }
+}
+
+/**
+ * @brief Get the candidates for the next round of matching.
+ *
+ * @return std::optional<ZXVertexList> the vertices to scan, or std::nullopt
+ *         to scan the whole graph
+ */
+std::optional<ZXVertexList> IncrementalScan::next_candidates() {
+    if (!_radius.has_value()) return std::nullopt;
+
+    auto candidates = _position.has_value()
+                          ? dirty_region(_graph, _graph.get_changed_vertices(*_position), *_radius)
+                          : std::nullopt;
+    _position       = _graph.change_log_position();
+    return candidates;
+}
+
+/**
+ * @brief Rules without a match radius may change phases without touching any
+ *        edge, which the change log does not see. After they have been
+ *        applied, the other rules have to rescan the whole graph once.
+ *
+ */
+void IncrementalScan::notify_applied() {
+    if (!_radius.has_value() && _graph.is_logging_changes()) {
+        _graph.clear_change_log_bookmarks();
+    }
+}
+
 // Basic rules simplification
 size_t bialgebra_simp(ZXGraph& g) {
     return simplify(g, BialgebraRule());
@@ -119,15 +201,28 @@ void to_graph_like(ZXGraph& g) {
  * @return the number of iterations
  */
 size_t interior_clifford_simp(ZXGraph& g) {
+    TracedScope const trace{g, "routine", "interior_clifford_simp"};
     to_graph_like(g);
+
+    // let each rule resume from the changes made since it last ran, so that
+    // the late iterations only rescan the regions touched by the other rules
+    auto const owns_change_log = !g.is_logging_changes();
+    if (owns_change_log) g.start_change_log();
+
+    size_t result = 0;
     for (size_t iterations = 0; !stop_requested(); iterations++) {
         auto const i1 = identity_removal_simp(g);
         auto const i2 = spider_fusion_simp(g);
         auto const i3 = pivot_simp(g);
         auto const i4 = local_complement_simp(g);
-        if (i1 + i2 + i3 + i4 == 0) return iterations;
+        if (i1 + i2 + i3 + i4 == 0) {
+            result = iterations;
+            break;
+        }
     }
-    return 0;
+
+    if (owns_change_log) g.stop_change_log();
+    return result;
 }
 
 /**
@@ -137,6 +232,7 @@ size_t interior_clifford_simp(ZXGraph& g) {
  * @return the number of iterations
  */
 size_t clifford_simp(ZXGraph& g) {
+    TracedScope const trace{g, "routine", "clifford_simp"};
     size_t iterations = 0;
     while (true) {
         auto const i1 = interior_clifford_simp(g);
@@ -152,6 +248,10 @@ size_t clifford_simp(ZXGraph& g) {
  *
  */
 void full_reduce(ZXGraph& g) {
+    TracedScope const trace{g, "routine", "full_reduce"};
+    auto const owns_change_log = !g.is_logging_changes();
+    if (owns_change_log) g.start_change_log();
+
     interior_clifford_simp(g);
     pivot_gadget_simp(g);
     while (!stop_requested()) {
@@ -161,6 +261,8 @@ void full_reduce(ZXGraph& g) {
         auto i2 = pivot_gadget_simp(g);
         if (i1 + i2 == 0) break;
     }
+
+    if (owns_change_log) g.stop_change_log();
 }
 
 /**
@@ -169,13 +271,18 @@ void full_reduce(ZXGraph& g) {
  *
  */
 void dynamic_reduce(ZXGraph& g) {
-    // copy the graph's structure
+    TracedScope const trace{g, "routine", "dynamic_reduce"};
     hadamard_rule_simp(g);
-    ZXGraph copied_graph = g;
     spdlog::info("Full Reduce:");
-    // to obtain the T-optimal
-    full_reduce(copied_graph);
-    auto t_optimal = t_count(copied_graph);
+    // to obtain the T-optimal. The reduction runs on a copy rather than in a
+    // rolled-back transaction, as a rollback does not restore the order in
+    // which the vertices and neighbors are visited
+    auto const t_optimal = [&g, &trace]() {
+        ZXGraph copied_graph = g;
+        TraceContextGuard const guard{copied_graph, trace.nested_context()};
+        full_reduce(copied_graph);
+        return t_count(copied_graph);
+    }();
 
     spdlog::info("Dynamic Reduce: (T-optimal: {})", t_optimal);
     dynamic_reduce(g, t_optimal);
@@ -220,6 +327,7 @@ void dynamic_reduce(ZXGraph& g, size_t optimal_t_count) {
  *
  */
 void symbolic_reduce(ZXGraph& g) {
+    TracedScope const trace{g, "routine", "symbolic_reduce"};
     interior_clifford_simp(g);
     pivot_gadget_simp(g);
     state_copy_simp(g);
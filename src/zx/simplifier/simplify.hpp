@@ -8,9 +8,12 @@
 #pragma once
 
 #include <cstddef>
+#include <optional>
+#include <string>
 #include <type_traits>
 
 #include "./rules/zx_rules_template.hpp"
+#include "./trace.hpp"
 
 extern bool stop_requested();
 
@@ -41,7 +44,7 @@ void full_reduce(ZXGraph& g);
 void dynamic_reduce(ZXGraph& g);
 void dynamic_reduce(ZXGraph& g, size_t optimal_t_count);
 void symbolic_reduce(ZXGraph& g);
-void partition_reduce(ZXGraph& g, size_t n_partitions);
+void partition_reduce(ZXGraph& g, size_t n_partitions, size_t n_threads = 1);
 void causal_flow_opt(ZXGraph& g,
                      size_t max_lcomp_unfusions,
                      size_t max_pivot_unfusions);
@@ -53,6 +56,38 @@ void to_graph_like(ZXGraph& g);
 
 void report_simplification_result(
     std::string_view rule_name, std::span<size_t> match_counts);
+
+std::optional<ZXVertexList> dirty_region(
+    ZXGraph const& g, std::vector<ZXVertex*> const& dirty_vertices, size_t radius);
+
+/**
+ * @brief Decides which vertices a rule needs to scan in each round. For rules
+ *        with a match radius, the changes to the graph are logged, and each
+ *        round only scans the region around the vertices changed since the
+ *        previous one. If the graph was already logging changes, the scan
+ *        also resumes from where the same rule left off last time.
+ */
+class IncrementalScan {
+public:
+    IncrementalScan(ZXGraph& g, std::string name, std::optional<size_t> radius);
+    ~IncrementalScan();
+
+    IncrementalScan(IncrementalScan const&)            = delete;
+    IncrementalScan& operator=(IncrementalScan const&) = delete;
+    IncrementalScan(IncrementalScan&&)                 = delete;
+    IncrementalScan& operator=(IncrementalScan&&)      = delete;
+
+    std::optional<ZXVertexList> next_candidates();
+    void notify_applied();
+
+private:
+    ZXGraph& _graph;
+    std::string _name;
+    std::optional<size_t> _radius;
+    std::optional<size_t> _position;  // where the previous round read the change log
+    bool _owns_change_log = false;
+};
+
 /**
  * @brief apply the rule on the zx graph
  *
@@ -64,15 +99,21 @@ size_t simplify(ZXGraph& g, Rule const& rule) {
     hadamard_rule_simp(g);
 
     std::vector<size_t> match_counts;
+    IncrementalScan scan{g, rule.get_name(), rule.match_radius()};
+    TracedScope trace{g, "rule", rule.get_name()};
 
     while (!stop_requested()) {
-        auto const matches = rule.find_matches(g);
+        trace.begin_iteration();
+        auto const matches = rule.find_matches(g, scan.next_candidates());
+        trace.end_matching(matches.size());
         if (matches.empty()) {
             break;
         }
         match_counts.emplace_back(matches.size());
 
         rule.apply(g, matches);
+        scan.notify_applied();
+        trace.end_iteration();
     }
 
     report_simplification_result(rule.get_name(), match_counts);
@@ -89,10 +130,14 @@ template <typename Rule>
 requires std::is_base_of<ZXRuleTemplate<typename Rule::MatchType>, Rule>::value
 size_t hadamard_simplify(ZXGraph& g, Rule rule) {
     std::vector<size_t> match_counts;
+    IncrementalScan scan{g, rule.get_name(), rule.match_radius()};
+    TracedScope trace{g, "rule", rule.get_name()};
 
     while (!stop_requested()) {
+        trace.begin_iteration();
         auto const old_vertex_count = g.num_vertices();
-        auto const matches          = rule.find_matches(g);
+        auto const matches          = rule.find_matches(g, scan.next_candidates());
+        trace.end_matching(matches.size());
 
         if (matches.empty()) {
             break;
@@ -100,6 +145,8 @@ size_t hadamard_simplify(ZXGraph& g, Rule rule) {
         match_counts.emplace_back(matches.size());
 
         rule.apply(g, matches);
+        scan.notify_applied();
+        trace.end_iteration();
         if (g.num_vertices() >= old_vertex_count) break;
     }
 
@@ -0,0 +1,185 @@
+/****************************************************************************
+  PackageName  [ simplifier ]
+  Synopsis     [ Implement the telemetry trace of the simplification routines ]
+  Author       [ Design Verification Lab ]
+  Copyright    [ Copyright(c) 2023 DVLab, GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#include "./trace.hpp"
+
+#include <sys/resource.h>
+
+#include <atomic>
+#include <cassert>
+#include <nlohmann/json.hpp>
+#include <ostream>
+#include <unordered_map>
+
+#include "zx/zxgraph.hpp"
+
+namespace qsyn::zx::simplify {
+
+namespace {
+
+std::atomic<SimplificationTrace*> active_trace = nullptr;
+
+// the contexts of the graphs with open scopes or guards. A graph without an
+// entry is at depth 0 and belongs to no partition
+std::mutex trace_contexts_mutex;
+std::unordered_map<ZXGraph const*, TraceContext> trace_contexts;
+
+// the context of the scope being opened on g, which nests the next one deeper
+TraceContext open_trace_scope(ZXGraph const& g) {
+    std::lock_guard const lock{trace_contexts_mutex};
+    auto& context = trace_contexts[&g];
+    auto const opened = context;
+    context.depth++;
+    return opened;
+}
+
+void close_trace_scope(ZXGraph const& g) {
+    std::lock_guard const lock{trace_contexts_mutex};
+    auto const it = trace_contexts.find(&g);
+    assert(it != trace_contexts.end() && it->second.depth > 0);
+    it->second.depth--;
+    // the entry is back to the default; keep the map from holding stale
+    // addresses that a later graph might reuse
+    if (it->second.depth == 0 && !it->second.partition.has_value()) {
+        trace_contexts.erase(it);
+    }
+}
+
+double to_milliseconds(TracedScope::Clock::duration d) {
+    return std::chrono::duration<double, std::milli>(d).count();
+}
+
+// the peak resident set size of the process so far, in KiB
+long peak_memory_kib() {
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#ifdef __APPLE__
+    // macOS reports memory usage in bytes
+    return usage.ru_maxrss / 1024;  // NOLINT(cppcoreguidelines-pro-type-union-access) : conform to POSIX
+#else
+    // Linux reports memory usage in kibibytes
+    return usage.ru_maxrss;  // NOLINT(cppcoreguidelines-pro-type-union-access) : conform to POSIX
+#endif
+}
+
+void add_deltas(nlohmann::json& record, GraphStatistics const& before, GraphStatistics const& after) {
+    auto const delta = [](size_t from, size_t to) { return static_cast<long long>(to) - static_cast<long long>(from); };
+    record["vertices"]       = after.num_vertices;
+    record["edges"]          = after.num_edges;
+    record["t_count"]        = after.t_count;
+    record["vertices_delta"] = delta(before.num_vertices, after.num_vertices);
+    record["edges_delta"]    = delta(before.num_edges, after.num_edges);
+    record["t_count_delta"]  = delta(before.t_count, after.t_count);
+    record["peak_rss_kib"]   = peak_memory_kib();
+}
+
+}  // namespace
+
+void SimplificationTrace::write_line(std::string_view line) {
+    std::lock_guard const lock{_mutex};
+    _os << line << '\n';
+}
+
+SimplificationTrace* get_simplification_trace() {
+    return active_trace.load();
+}
+
+void set_simplification_trace(SimplificationTrace* trace) {
+    active_trace.store(trace);
+}
+
+TraceContextGuard::TraceContextGuard(ZXGraph const& g, TraceContext const& context) {
+    if (get_simplification_trace() == nullptr) return;
+    _graph = &g;
+    std::lock_guard const lock{trace_contexts_mutex};
+    trace_contexts.insert_or_assign(_graph, context);
+}
+
+TraceContextGuard::~TraceContextGuard() {
+    if (_graph == nullptr) return;
+    std::lock_guard const lock{trace_contexts_mutex};
+    trace_contexts.erase(_graph);
+}
+
+GraphStatistics GraphStatistics::of(ZXGraph const& g) {
+    return {
+        .num_vertices = g.num_vertices(),
+        .num_edges    = g.num_edges(),
+        .t_count      = zx::t_count(g),
+    };
+}
+
+TracedScope::TracedScope(ZXGraph const& g, std::string_view kind, std::string_view name)
+    : _trace{get_simplification_trace()}, _graph{g}, _kind{kind}, _name{name} {
+    if (_trace == nullptr) return;
+    _context      = open_trace_scope(_graph);
+    _stats_before = GraphStatistics::of(_graph);
+    _start        = Clock::now();
+}
+
+TracedScope::~TracedScope() {
+    if (_trace == nullptr) return;
+    close_trace_scope(_graph);
+
+    auto record = nlohmann::json{
+        {"kind", _kind},
+        {"name", _name},
+        {"depth", _context.depth},
+        {"time_ms", to_milliseconds(Clock::now() - _start)},
+    };
+    if (_context.partition.has_value()) record["partition"] = *_context.partition;
+    if (_kind == "rule") {
+        record["iterations"] = _num_iterations;
+        record["matches"]    = _num_matches;
+        record["match_ms"]   = to_milliseconds(_match_time);
+        record["apply_ms"]   = to_milliseconds(_apply_time);
+    }
+    add_deltas(record, _stats_before, GraphStatistics::of(_graph));
+    _trace->write_line(record.dump());
+}
+
+void TracedScope::begin_iteration() {
+    if (_trace == nullptr) return;
+    _iteration_stats_before = GraphStatistics::of(_graph);
+    _iteration_start        = Clock::now();
+}
+
+/**
+ * @brief Mark the end of matching in this iteration. If nothing matched, the
+ *        time still counts towards the matching time of the rule.
+ *
+ * @param num_matches
+ */
+void TracedScope::end_matching(size_t num_matches) {
+    if (_trace == nullptr) return;
+    _apply_start       = Clock::now();
+    _iteration_matches = num_matches;
+    _match_time += _apply_start - _iteration_start;
+}
+
+void TracedScope::end_iteration() {
+    if (_trace == nullptr) return;
+    auto const apply_time = Clock::now() - _apply_start;
+    _apply_time += apply_time;
+    _num_iterations++;
+    _num_matches += _iteration_matches;
+
+    auto record = nlohmann::json{
+        {"kind", "iteration"},
+        {"name", _name},
+        {"depth", _context.depth + 1},
+        {"iteration", _num_iterations},
+        {"matches", _iteration_matches},
+        {"match_ms", to_milliseconds(_apply_start - _iteration_start)},
+        {"apply_ms", to_milliseconds(apply_time)},
+    };
+    if (_context.partition.has_value()) record["partition"] = *_context.partition;
+    add_deltas(record, _iteration_stats_before, GraphStatistics::of(_graph));
+    _trace->write_line(record.dump());
+}
+
+}  // namespace qsyn::zx::simplify
@@ -0,0 +1,137 @@
+/****************************************************************************
+  PackageName  [ simplifier ]
+  Synopsis     [ Define the telemetry trace of the simplification routines ]
+  Author       [ Design Verification Lab ]
+  Copyright    [ Copyright(c) 2023 DVLab, GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <iosfwd>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace qsyn::zx {
+
+class ZXGraph;
+
+namespace simplify {
+
+/**
+ * @brief A sink for the telemetry of the simplification routines. Each rule
+ *        iteration, rule call and composite routine is written as one JSON
+ *        object per line. Lines from concurrent simplifications, e.g., the
+ *        partitions of partition_reduce, are interleaved but never torn.
+ *
+ */
+class SimplificationTrace {
+public:
+    explicit SimplificationTrace(std::ostream& os) : _os{os} {}
+
+    void write_line(std::string_view line);
+
+private:
+    std::mutex _mutex;
+    std::ostream& _os;
+};
+
+// the trace the simplifications write to, or nullptr if tracing is off
+SimplificationTrace* get_simplification_trace();
+void set_simplification_trace(SimplificationTrace* trace);
+
+struct GraphStatistics {
+    size_t num_vertices = 0;
+    size_t num_edges    = 0;
+    size_t t_count      = 0;
+
+    static GraphStatistics of(ZXGraph const& g);
+};
+
+/**
+ * @brief What the traced scopes on a graph report besides their own
+ *        measurements. Records from a graph that stands for a partition of
+ *        a larger one carry its partition number, so that the interleaved
+ *        lines of concurrent partitions can be told apart. The depth is that
+ *        of the next scope opened on the graph; a graph that is simplified
+ *        on behalf of another one, e.g., a partition or a copy, starts below
+ *        the scope that owns it.
+ *
+ */
+struct TraceContext {
+    std::optional<size_t> partition;
+    size_t depth = 0;
+};
+
+/**
+ * @brief Attaches a trace context to a graph for the lifetime of the guard.
+ *        Does nothing if no trace is active when constructed.
+ *
+ */
+class TraceContextGuard {
+public:
+    TraceContextGuard(ZXGraph const& g, TraceContext const& context);
+    ~TraceContextGuard();
+
+    TraceContextGuard(TraceContextGuard const&)            = delete;
+    TraceContextGuard& operator=(TraceContextGuard const&) = delete;
+    TraceContextGuard(TraceContextGuard&&)                 = delete;
+    TraceContextGuard& operator=(TraceContextGuard&&)      = delete;
+
+private:
+    ZXGraph const* _graph = nullptr;
+};
+
+/**
+ * @brief Records the wall time and the graph deltas of a rule call or a
+ *        composite routine into the active trace. For rules, the iteration
+ *        hooks further split the time into matching and applying. Does
+ *        nothing if no trace is active when constructed.
+ *
+ */
+class TracedScope {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    TracedScope(ZXGraph const& g, std::string_view kind, std::string_view name);
+    ~TracedScope();
+
+    TracedScope(TracedScope const&)            = delete;
+    TracedScope& operator=(TracedScope const&) = delete;
+    TracedScope(TracedScope&&)                 = delete;
+    TracedScope& operator=(TracedScope&&)      = delete;
+
+    void begin_iteration();
+    void end_matching(size_t num_matches);
+    void end_iteration();
+
+    // the context for a graph simplified on behalf of this scope's graph
+    TraceContext nested_context() const { return {.partition = _context.partition, .depth = _context.depth + 1}; }
+
+private:
+    SimplificationTrace* _trace;
+    ZXGraph const& _graph;
+    std::string _kind;
+    std::string _name;
+    TraceContext _context;
+
+    Clock::time_point _start;
+    GraphStatistics _stats_before;
+
+    size_t _num_iterations = 0;
+    size_t _num_matches    = 0;
+    Clock::duration _match_time{};
+    Clock::duration _apply_time{};
+
+    Clock::time_point _iteration_start;
+    Clock::time_point _apply_start;
+    size_t _iteration_matches = 0;
+    GraphStatistics _iteration_stats_before;
+};
+
+}  // namespace simplify
+
+}  // namespace qsyn::zx
@@ -0,0 +1,381 @@
+/****************************************************************************
+  PackageName  [ zx ]
+  Synopsis     [ Define the binary ZXGraph format (.zxb) ]
+  Author       [ Design Verification Lab ]
+  Copyright    [ Copyright(c) 2023 DVLab, GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+/*
+ * Layout of a .zxb file. All integers are little-endian, and every section
+ * starts at a multiple of 8 bytes so that the file can be used in place
+ * after mmap-ing it.
+ *
+ *   ZXBHeader                                 64 bytes
+ *   ZXBVertex   vertices[num_vertices]        32 bytes each
+ *   uint64_t    offsets[num_vertices + 1]     CSR row offsets into `adjacency`
+ *   uint32_t    adjacency[num_adjacency]      (neighbor index << 1) | is_hadamard
+ *   (padding to 8 bytes)
+ *   ZXBPhase    phases[num_phases]            deduplicated rational phases
+ *
+ * The vertex table lists the inputs first, then the outputs, then the other
+ * vertices. Each edge is stored in the adjacency lists of both endpoints.
+ */
+
+#include <spdlog/spdlog.h>
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "./zx_def.hpp"
+#include "./zx_io.hpp"
+#include "./zxgraph.hpp"
+#include "util/mapped_file.hpp"
+#include "util/phase.hpp"
+#include "util/util.hpp"
+
+namespace qsyn::zx {
+
+namespace detail {
+
+constexpr char zxb_magic[8]          = {'Q', 'S', 'Y', 'N', 'Z', 'X', 'B', '\0'};
+constexpr std::uint32_t zxb_version  = 1;
+constexpr std::uint32_t zxb_byte_tag = 0x01020304;
+
+struct ZXBHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byte_tag;  // detects files written with a different byte order
+    std::uint64_t num_vertices;
+    std::uint64_t num_inputs;
+    std::uint64_t num_outputs;
+    std::uint64_t num_adjacency;
+    std::uint64_t num_phases;
+    std::uint64_t reserved;
+};
+
+struct ZXBVertex {
+    std::uint64_t id;
+    std::uint64_t qubit;
+    float row;
+    float col;
+    std::uint32_t phase_index;
+    std::uint8_t type;
+    std::uint8_t reserved[3];
+};
+
+struct ZXBPhase {
+    std::int32_t numerator;
+    std::int32_t denominator;
+};
+
+static_assert(sizeof(ZXBHeader) == 64 && std::is_trivially_copyable_v<ZXBHeader>);
+static_assert(sizeof(ZXBVertex) == 32 && std::is_trivially_copyable_v<ZXBVertex>);
+static_assert(sizeof(ZXBPhase) == 8 && std::is_trivially_copyable_v<ZXBPhase>);
+static_assert(std::endian::native == std::endian::little, "the .zxb format assumes a little-endian host");
+
+constexpr size_t align_to_8(size_t n) { return (n + 7) & ~size_t{7}; }
+
+std::uint8_t to_zxb_type(VertexType vt) {
+    switch (vt) {
+        case VertexType::boundary:
+            return 0;
+        case VertexType::z:
+            return 1;
+        case VertexType::x:
+            return 2;
+        case VertexType::h_box:
+            return 3;
+        default:
+            DVLAB_UNREACHABLE("unsupported vertex type");
+            return 0;  // silence warning
+    }
+}
+
+std::optional<VertexType> from_zxb_type(std::uint8_t type) {
+    switch (type) {
+        case 0:
+            return VertexType::boundary;
+        case 1:
+            return VertexType::z;
+        case 2:
+            return VertexType::x;
+        case 3:
+            return VertexType::h_box;
+        default:
+            return std::nullopt;
+    }
+}
+
+/**
+ * @brief Views into the sections of a mapped .zxb file. The spans point
+ *        directly into the mapping.
+ *
+ */
+struct ZXBSections {
+    ZXBHeader const* header = nullptr;
+    std::span<ZXBVertex const> vertices;
+    std::span<std::uint64_t const> offsets;
+    std::span<std::uint32_t const> adjacency;
+    std::span<ZXBPhase const> phases;
+};
+
+/**
+ * @brief Locate the sections of a .zxb file and check that they are
+ *        consistent with each other.
+ *
+ * @param bytes the file content
+ * @return std::optional<ZXBSections> the sections, or std::nullopt if the file is malformed
+ */
+std::optional<ZXBSections> get_zxb_sections(std::span<std::byte const> bytes) {
+    if (bytes.size() < sizeof(ZXBHeader)) {
+        spdlog::error("the file is too small to be a .zxb file!!");
+        return std::nullopt;
+    }
+    auto const* header = reinterpret_cast<ZXBHeader const*>(bytes.data());
+    if (std::memcmp(header->magic, zxb_magic, sizeof(zxb_magic)) != 0) {
+        spdlog::error("the file is not a .zxb file!!");
+        return std::nullopt;
+    }
+    if (header->byte_tag != zxb_byte_tag) {
+        spdlog::error("the .zxb file is written in an unsupported byte order!!");
+        return std::nullopt;
+    }
+    if (header->version != zxb_version) {
+        spdlog::error("unsupported .zxb version {} (expected {})!!", header->version, zxb_version);
+        return std::nullopt;
+    }
+
+    // bound the counts before computing section sizes so that they cannot overflow
+    auto const max_count = bytes.size() / sizeof(std::uint32_t);
+    if (header->num_vertices > max_count || header->num_adjacency > max_count || header->num_phases > max_count ||
+        header->num_inputs > header->num_vertices || header->num_outputs > header->num_vertices - header->num_inputs) {
+        spdlog::error("the .zxb header is corrupted!!");
+        return std::nullopt;
+    }
+
+    auto const vertex_offset    = sizeof(ZXBHeader);
+    auto const offsets_offset   = vertex_offset + header->num_vertices * sizeof(ZXBVertex);
+    auto const adjacency_offset = offsets_offset + (header->num_vertices + 1) * sizeof(std::uint64_t);
+    auto const phase_offset     = align_to_8(adjacency_offset + header->num_adjacency * sizeof(std::uint32_t));
+    auto const end_offset       = phase_offset + header->num_phases * sizeof(ZXBPhase);
+    if (end_offset != bytes.size()) {
+        spdlog::error("the .zxb file has size {} but its header describes {} bytes!!", bytes.size(), end_offset);
+        return std::nullopt;
+    }
+
+    auto const* base = bytes.data();
+    return ZXBSections{
+        .header    = header,
+        .vertices  = {reinterpret_cast<ZXBVertex const*>(base + vertex_offset), header->num_vertices},
+        .offsets   = {reinterpret_cast<std::uint64_t const*>(base + offsets_offset), header->num_vertices + 1},
+        .adjacency = {reinterpret_cast<std::uint32_t const*>(base + adjacency_offset), header->num_adjacency},
+        .phases    = {reinterpret_cast<ZXBPhase const*>(base + phase_offset), header->num_phases},
+    };
+}
+
+std::optional<ZXGraph> build_graph_from_zxb(ZXBSections const& sections, bool keep_id) {
+    auto const& [header, vertices, offsets, adjacency, phases] = sections;
+
+    for (auto const& [numerator, denominator] : phases) {
+        if (denominator <= 0) {
+            spdlog::error("failed to build the graph: invalid phase {}/{}!!", numerator, denominator);
+            return std::nullopt;
+        }
+    }
+
+    ZXGraph graph;
+    std::vector<ZXVertex*> index_to_vertex;
+    index_to_vertex.reserve(vertices.size());
+
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        auto const& record = vertices[i];
+        auto const vtype   = from_zxb_type(record.type);
+        if (!vtype.has_value()) {
+            spdlog::error("failed to build the graph: vertex {} has unsupported type {}!!", record.id, record.type);
+            return std::nullopt;
+        }
+        auto const is_input  = i < header->num_inputs;
+        auto const is_output = !is_input && i < header->num_inputs + header->num_outputs;
+        if ((is_input || is_output) != (vtype == VertexType::boundary)) {
+            spdlog::error("failed to build the graph: vertex {} is misplaced in the vertex table!!", record.id);
+            return std::nullopt;
+        }
+        if (record.phase_index >= phases.size()) {
+            spdlog::error("failed to build the graph: vertex {} refers to a missing phase!!", record.id);
+            return std::nullopt;
+        }
+
+        auto const phase = Phase(phases[record.phase_index].numerator, phases[record.phase_index].denominator);
+        ZXVertex* v      = nullptr;
+        if (is_input) {
+            v = keep_id ? graph.add_input(record.id, record.qubit, record.row, record.col)
+                        : graph.add_input(record.qubit, record.row, record.col);
+        } else if (is_output) {
+            v = keep_id ? graph.add_output(record.id, record.qubit, record.row, record.col)
+                        : graph.add_output(record.qubit, record.row, record.col);
+        } else {
+            v = keep_id ? graph.add_vertex(record.id, *vtype, phase, record.row, record.col)
+                        : graph.add_vertex(*vtype, phase, record.row, record.col);
+        }
+        // duplicated IDs or qubits have been reported by the graph
+        if (v == nullptr) return std::nullopt;
+        index_to_vertex.emplace_back(v);
+    }
+
+    if (offsets.front() != 0 || offsets.back() != adjacency.size()) {
+        spdlog::error("failed to build the graph: corrupted adjacency offsets!!");
+        return std::nullopt;
+    }
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        if (offsets[i] > offsets[i + 1]) {
+            spdlog::error("failed to build the graph: corrupted adjacency offsets!!");
+            return std::nullopt;
+        }
+        for (auto const entry : adjacency.subspan(offsets[i], offsets[i + 1] - offsets[i])) {
+            auto const j = static_cast<size_t>(entry >> 1);
+            if (j >= vertices.size()) {
+                spdlog::error("failed to build the graph: cannot find vertex with index {}!!", j);
+                return std::nullopt;
+            }
+            // each edge is listed by both endpoints; add it from the smaller one
+            if (j <= i) continue;
+            auto const etype = (entry & 1) ? EdgeType::hadamard : EdgeType::simple;
+            if (graph.is_neighbor(index_to_vertex[i], index_to_vertex[j], etype)) continue;
+            graph.add_edge(index_to_vertex[i], index_to_vertex[j], etype);
+        }
+    }
+    return graph;
+}
+
+}  // namespace detail
+
+/**
+ * @brief Read a ZXGraph from the binary format (.zxb). The file is memory-mapped
+ *        and the graph is built directly from the mapping.
+ *
+ * @param filepath
+ * @param keep_id if true, keep the IDs as written in file; if false, rearrange the vertex IDs
+ * @return std::optional<ZXGraph> the graph, or std::nullopt if the file cannot be read
+ */
+std::optional<ZXGraph> from_zxb(std::filesystem::path const& filepath, bool keep_id) {
+    auto const file = dvlab::utils::MappedFile::open(filepath);
+    if (!file) return std::nullopt;
+
+    auto const sections = detail::get_zxb_sections(file->bytes());
+    if (!sections) {
+        spdlog::error("failed to parse the file \"{}\"!!", filepath.string());
+        return std::nullopt;
+    }
+
+    return detail::build_graph_from_zxb(*sections, keep_id);
+}
+
+/**
+ * @brief Write the ZXGraph in the binary format (.zxb)
+ *
+ * @param filename
+ * @return true if correctly write a graph into .zxb
+ * @return false
+ */
+bool ZXGraph::write_zxb(std::filesystem::path const& filename) const {
+    using detail::ZXBPhase, detail::ZXBVertex;
+
+    // the adjacency entries reserve one bit for the edge type
+    if (num_vertices() > (size_t{1} << 31)) {
+        spdlog::error("the graph is too large for the .zxb format!!");
+        return false;
+    }
+
+    std::vector<ZXVertex*> order;
+    order.reserve(num_vertices());
+    order.insert(order.end(), get_inputs().begin(), get_inputs().end());
+    order.insert(order.end(), get_outputs().begin(), get_outputs().end());
+    for (auto* v : get_vertices()) {
+        if (!v->is_boundary()) order.emplace_back(v);
+    }
+
+    std::unordered_map<ZXVertex*, std::uint32_t> vertex_to_index;
+    vertex_to_index.reserve(order.size());
+    for (auto* v : order) {
+        vertex_to_index.emplace(v, static_cast<std::uint32_t>(vertex_to_index.size()));
+    }
+
+    std::vector<ZXBVertex> vertices;
+    std::vector<ZXBPhase> phases;
+    std::unordered_map<std::uint64_t, std::uint32_t> phase_to_index;
+    std::vector<std::uint64_t> offsets;
+    std::vector<std::uint32_t> adjacency;
+    vertices.reserve(order.size());
+    offsets.reserve(order.size() + 1);
+    adjacency.reserve(2 * num_edges());
+
+    offsets.emplace_back(0);
+    for (auto* v : order) {
+        auto const numerator   = static_cast<std::int32_t>(v->phase().numerator());
+        auto const denominator = static_cast<std::int32_t>(v->phase().denominator());
+        auto const phase_key   = (std::uint64_t{static_cast<std::uint32_t>(numerator)} << 32) | static_cast<std::uint32_t>(denominator);
+        auto const [phase_it, inserted] = phase_to_index.try_emplace(phase_key, static_cast<std::uint32_t>(phases.size()));
+        if (inserted) phases.push_back({numerator, denominator});
+
+        vertices.push_back({
+            .id          = v->get_id(),
+            .qubit       = v->get_qubit(),
+            .row         = v->get_row(),
+            .col         = v->get_col(),
+            .phase_index = phase_it->second,
+            .type        = detail::to_zxb_type(v->type()),
+            .reserved    = {},
+        });
+
+        for (auto const& [nb, etype] : get_neighbors(v)) {
+            adjacency.emplace_back((vertex_to_index.at(nb) << 1) | (etype == EdgeType::hadamard ? 1 : 0));
+        }
+        offsets.emplace_back(adjacency.size());
+    }
+
+    detail::ZXBHeader header{};
+    std::memcpy(header.magic, detail::zxb_magic, sizeof(detail::zxb_magic));
+    header.version       = detail::zxb_version;
+    header.byte_tag      = detail::zxb_byte_tag;
+    header.num_vertices  = vertices.size();
+    header.num_inputs    = get_inputs().size();
+    header.num_outputs   = get_outputs().size();
+    header.num_adjacency = adjacency.size();
+    header.num_phases    = phases.size();
+
+    std::ofstream zxb_file{filename, std::ios::binary};
+    if (!zxb_file.is_open()) {
+        spdlog::error("Cannot open the file \"{}\"!!", filename.string());
+        return false;
+    }
+
+    auto write_section = [&zxb_file]<typename T>(std::span<T const> section) {
+        zxb_file.write(reinterpret_cast<char const*>(section.data()), static_cast<std::streamsize>(section.size_bytes()));
+    };
+    write_section(std::span<detail::ZXBHeader const>{&header, 1});
+    write_section(std::span<ZXBVertex const>{vertices});
+    write_section(std::span<std::uint64_t const>{offsets});
+    write_section(std::span<std::uint32_t const>{adjacency});
+    // pad the adjacency section to 8 bytes
+    constexpr char padding[8] = {};
+    auto const adjacency_bytes = adjacency.size() * sizeof(std::uint32_t);
+    zxb_file.write(padding, static_cast<std::streamsize>(detail::align_to_8(adjacency_bytes) - adjacency_bytes));
+    write_section(std::span<ZXBPhase const>{phases});
+
+    if (!zxb_file) {
+        spdlog::error("failed to write the file \"{}\"!!", filename.string());
+        return false;
+    }
+    return true;
+}
+
+}  // namespace qsyn::zx
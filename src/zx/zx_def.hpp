@@ -20,6 +20,7 @@
 #include "util/ordered_hashmap.hpp"
 #include "util/ordered_hashset.hpp"
 #include "util/phase.hpp"
+#include "util/small_ordered_hashset.hpp"
 #include "util/text_format.hpp"
 
 namespace qsyn::zx {
@@ -67,7 +68,9 @@ struct EdgePairHash {
                (std::hash<EdgeType>()(k.second) << 1);
     }
 };
-using Neighbors = dvlab::utils::ordered_hashset<NeighborPair, NeighborPairHash>;
+// Most vertices of a graph-like diagram have only a handful of neighbors, so
+// they are stored inline and only spilled to a hash set for high-degree vertices
+using Neighbors = dvlab::utils::small_ordered_hashset<NeighborPair, 4, NeighborPairHash>;
 
 struct ZXCutHash {
     size_t operator()(ZXCut const& cut) const {
@@ -9,6 +9,7 @@
 #include <fmt/std.h>
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
 #include <cstring>
@@ -18,12 +19,16 @@
 #include <iterator>
 #include <nlohmann/json.hpp>
 #include <optional>
+#include <ranges>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "./zxgraph.hpp"
 #include "qsyn/qsyn_type.hpp"
+#include "util/mapped_file.hpp"
 #include "util/phase.hpp"
 #include "util/sysdep.hpp"
 #include "util/tmp_files.hpp"
@@ -35,153 +40,237 @@ namespace qsyn::zx {
 
 namespace detail {
 
-struct VertexInfo {
-    char type         = 'Z';
-    QubitIdType qubit = 0;
-    float row         = 0.f;
-    float column      = 0.f;
-    std::vector<std::pair<char, size_t>> neighbors;
-    Phase phase;
-};
-
-using StorageType = dvlab::utils::ordered_hashmap<size_t, VertexInfo>;
-
 class ZXFileParser {
 public:
-    std::optional<StorageType> parse(std::istream& f);
+    std::optional<ZXGraph> parse(std::string_view content, bool keep_id);
 
     static constexpr std::string_view supported_vertex_type = "IOZXH";
     static constexpr std::string_view supported_edge_type   = "SH";
 
 private:
+    // an edge whose other endpoint has not been declared yet
+    struct PendingEdge {
+        ZXVertex* v;
+        EdgeType etype;
+    };
+
     size_t _line_no = 1;
+    bool _keep_id   = false;
+    ZXGraph _graph;
+    std::unordered_map<size_t, ZXVertex*> _id_to_vertex;
     std::unordered_set<QubitIdType> _taken_input_qubits;
     std::unordered_set<QubitIdType> _taken_output_qubits;
+    QubitIdType _max_input_qubit_id  = 0;
+    QubitIdType _max_output_qubit_id = 0;
+
+    // edges to vertices not declared yet, by the ID of the missing vertex;
+    // released as soon as that vertex is declared
+    std::unordered_map<size_t, std::vector<PendingEdge>> _pending_edges;
+
+    // reused across lines to avoid reallocating
+    std::vector<std::string_view> _tokens;
 
     // parsing subroutines
-    bool _tokenize(std::string const& line, std::vector<std::string>& tokens);
+    bool _parse_line(std::string_view line);
+    bool _tokenize(std::string_view line);
+
+    std::optional<std::pair<char, size_t>> _parse_type_and_id(std::string_view token);
 
-    std::optional<std::pair<char, size_t>> _parse_type_and_id(StorageType const& storage, std::string const& token);
+    bool _parse_row(std::string_view token, float& row);
+    bool _parse_column(std::string_view token, float& column);
 
-    bool _parse_row(std::string const& token, float& row);
-    bool _parse_column(std::string const& token, float& column);
+    bool _parse_neighbors(std::string_view token, std::pair<char, size_t>& neighbor);
 
-    bool _parse_neighbors(std::string const& token, std::pair<char, size_t>& neighbor);
+    void _add_edge(ZXVertex* v, ZXVertex* nb, EdgeType etype);
 
     void _print_failed_at_line_no() const {
         spdlog::error("Error: failed to read line {}!!", _line_no);
     }
 };
 
+namespace {
+
+std::string_view strip_spaces(std::string_view str) {
+    auto const begin = str.find_first_not_of(" \t\n\v\f\r");
+    if (begin == std::string_view::npos) return {};
+    auto const end = str.find_last_not_of(" \t\n\v\f\r");
+    return str.substr(begin, end + 1 - begin);
+}
+
+}  // namespace
+
 /**
- * @brief Parse each line in the istream
+ * @brief Parse the content of a .zx file line by line and build the graph
+ *        on the fly. Tokens are views into `content`, so no per-vertex
+ *        storage is kept besides the graph itself.
  *
- * @param f
- * @return true if the file is successfully parsed
- * @return false if the format of any lines are wrong
+ * @param content
+ * @param keep_id if true, keep the IDs as written in file; if false, rearrange the vertex IDs
+ * @return std::optional<ZXGraph> the graph, or std::nullopt if the format of any line is wrong
  */
-std::optional<StorageType> ZXFileParser::parse(std::istream& f) {
+std::optional<ZXGraph> ZXFileParser::parse(std::string_view content, bool keep_id) {
     // each line should be in the format of
     // <I|O><Vertex id>   [(<Qubit, Column>)] [<<S|H><neighbor id>...] [size_t qubit_id]
     // <Z|X|H><Vertex id> [(<Qubit, Column>)] [<<S|H><neighbor id>...] [Phase phase]
-    auto storage = StorageType{};
-    _taken_input_qubits.clear();
-    _taken_output_qubits.clear();
-    _line_no = 1;
+    *this    = ZXFileParser{};
+    _keep_id = keep_id;
 
-    QubitIdType max_input_qubit_id  = 0;
-    QubitIdType max_output_qubit_id = 0;
-
-    for (std::string line; std::getline(f, line); _line_no++) {
-        line = dvlab::str::trim_spaces(dvlab::str::trim_comments(line));
+    for (size_t begin = 0; begin < content.size(); _line_no++) {
+        auto const end  = std::min(content.find('\n', begin), content.size());
+        auto const line = strip_spaces(dvlab::str::trim_comments(content.substr(begin, end - begin)));
+        begin           = end + 1;
         if (line.empty()) continue;
 
-        std::vector<std::string> tokens;
-        if (!_tokenize(line, tokens)) return std::nullopt;
+        if (!_parse_line(line)) return std::nullopt;
+    }
 
-        VertexInfo info;
+    if (!_pending_edges.empty()) {
+        spdlog::error("failed to build the graph: cannot find vertex with ID {}!!", std::ranges::min(_pending_edges | std::views::keys));
+        return std::nullopt;
+    }
 
-        auto const type_and_id = _parse_type_and_id(storage, tokens[0]);
-        if (!type_and_id) return std::nullopt;
+    return std::move(_graph);
+}
 
-        info.type = type_and_id->first;
-        auto id   = type_and_id->second;
+/**
+ * @brief Parse a non-empty line, add its vertex to the graph and queue its edges
+ *
+ * @param line
+ * @return true
+ * @return false
+ */
+bool ZXFileParser::_parse_line(std::string_view line) {
+    if (!_tokenize(line)) return false;
 
-        if (info.type == 'H') info.phase = Phase(1);
+    auto const type_and_id = _parse_type_and_id(_tokens[0]);
+    if (!type_and_id) return false;
 
-        switch (info.type) {
-            case 'I': {
-                if (auto const qubit = dvlab::str::from_string<int>(tokens.back()); qubit.has_value() && tokens.size() > 3) {
-                    tokens.pop_back();
-                    info.qubit         = qubit.value();
-                    max_input_qubit_id = std::max(max_input_qubit_id, info.qubit);
-                } else {
-                    info.qubit = max_input_qubit_id++;
-                }
-                if (_taken_input_qubits.contains(info.qubit)) {
-                    _print_failed_at_line_no();
-                    spdlog::error("duplicated input qubit ID ({})!!", info.qubit);
-                    return std::nullopt;
-                }
-                _taken_input_qubits.insert(info.qubit);
-                info.row = static_cast<float>(info.qubit);
-                break;
+    auto const [type, id] = *type_and_id;
+
+    QubitIdType qubit = 0;
+    float row         = 0.f;
+    float column      = 0.f;
+    Phase phase       = (type == 'H') ? Phase(1) : Phase(0);
+
+    switch (type) {
+        case 'I': {
+            if (auto const qubit_id = dvlab::str::from_string<int>(_tokens.back()); qubit_id.has_value() && _tokens.size() > 3) {
+                _tokens.pop_back();
+                qubit               = qubit_id.value();
+                _max_input_qubit_id = std::max(_max_input_qubit_id, qubit);
+            } else {
+                qubit = _max_input_qubit_id++;
             }
-            case 'O': {
-                if (auto const qubit = dvlab::str::from_string<int>(tokens.back()); qubit.has_value() && tokens.size() > 3) {
-                    tokens.pop_back();
-                    info.qubit          = qubit.value();
-                    max_output_qubit_id = std::max(max_output_qubit_id, info.qubit);
-                } else {
-                    info.qubit = max_output_qubit_id++;
-                }
-                if (_taken_output_qubits.contains(info.qubit)) {
-                    _print_failed_at_line_no();
-                    spdlog::error("duplicated output qubit ID ({})!!", info.qubit);
-                    return std::nullopt;
-                }
-                info.row = static_cast<float>(info.qubit);
-                break;
+            if (_taken_input_qubits.contains(qubit)) {
+                _print_failed_at_line_no();
+                spdlog::error("duplicated input qubit ID ({})!!", qubit);
+                return false;
             }
-            default: {
-                if (auto const phase = Phase::from_string(tokens.back()); phase.has_value() && tokens.size() > 3) {
-                    tokens.pop_back();
-                    info.phase = phase.value();
-                }
-                info.row = 0;
-                break;
+            _taken_input_qubits.insert(qubit);
+            row = static_cast<float>(qubit);
+            break;
+        }
+        case 'O': {
+            if (auto const qubit_id = dvlab::str::from_string<int>(_tokens.back()); qubit_id.has_value() && _tokens.size() > 3) {
+                _tokens.pop_back();
+                qubit                = qubit_id.value();
+                _max_output_qubit_id = std::max(_max_output_qubit_id, qubit);
+            } else {
+                qubit = _max_output_qubit_id++;
+            }
+            if (_taken_output_qubits.contains(qubit)) {
+                _print_failed_at_line_no();
+                spdlog::error("duplicated output qubit ID ({})!!", qubit);
+                return false;
             }
+            _taken_output_qubits.insert(qubit);
+            row = static_cast<float>(qubit);
+            break;
+        }
+        default: {
+            if (Phase parsed_phase; _tokens.size() > 3 && Phase::str_to_phase(_tokens.back(), parsed_phase)) {
+                _tokens.pop_back();
+                phase = parsed_phase;
+            }
+            break;
+        }
+    }
+
+    if (!_parse_row(_tokens[1], row)) return false;
+    if (!_parse_column(_tokens[2], column)) return false;
+
+    auto const opt_id = _keep_id ? std::make_optional(id) : std::nullopt;
+
+    ZXVertex* v = std::invoke([&]() -> ZXVertex* {
+        switch (type) {
+            case 'I':
+                return opt_id ? _graph.add_input(*opt_id, qubit, row, column) : _graph.add_input(qubit, row, column);
+            case 'O':
+                return opt_id ? _graph.add_output(*opt_id, qubit, row, column) : _graph.add_output(qubit, row, column);
+            case 'Z':
+                return _graph.add_vertex(opt_id, VertexType::z, phase, row, column);
+            case 'X':
+                return _graph.add_vertex(opt_id, VertexType::x, phase, row, column);
+            case 'H':
+                return _graph.add_vertex(opt_id, VertexType::h_box, phase, row, column);
+            default:
+                DVLAB_UNREACHABLE("unsupported vertex type");
+                return nullptr;  // silence warning
         }
+    });
 
-        if (!_parse_row(tokens[1], info.row)) return std::nullopt;
-        if (!_parse_column(tokens[2], info.column)) return std::nullopt;
+    if (v == nullptr) {
+        _print_failed_at_line_no();
+        return false;
+    }
+    _id_to_vertex.emplace(id, v);
 
-        std::pair<char, size_t> neighbor;
-        for (size_t i = 3; i < tokens.size(); ++i) {
-            if (!_parse_neighbors(tokens[i], neighbor)) return std::nullopt;
-            info.neighbors.emplace_back(neighbor);
+    // the edges declared earlier towards this vertex come before its own, so
+    // the edges between any two vertices are still added in declaration order
+    if (auto node = _pending_edges.extract(id); !node.empty()) {
+        for (auto const& [u, etype] : node.mapped()) {
+            _add_edge(u, v, etype);
         }
+    }
 
-        storage.emplace(id, info);
+    std::pair<char, size_t> neighbor;
+    for (size_t i = 3; i < _tokens.size(); ++i) {
+        if (!_parse_neighbors(_tokens[i], neighbor)) return false;
+        auto const etype = (neighbor.first == 'S') ? EdgeType::simple : EdgeType::hadamard;
+        if (auto const nb_it = _id_to_vertex.find(neighbor.second); nb_it != _id_to_vertex.end()) {
+            _add_edge(v, nb_it->second, etype);
+        } else {
+            _pending_edges[neighbor.second].push_back({v, etype});
+        }
     }
 
-    return storage;
+    return true;
+}
+
+/**
+ * @brief Add an edge read from the file. An edge listed on both of its
+ *        endpoints is added only once.
+ *
+ */
+void ZXFileParser::_add_edge(ZXVertex* v, ZXVertex* nb, EdgeType etype) {
+    if (_graph.is_neighbor(v, nb, etype)) return;
+    _graph.add_edge(v, nb, etype);
 }
 
 /**
  * @brief Tokenize the line
  *
  * @param line
- * @param tokens
  * @return true
  * @return false
  */
-bool ZXFileParser::_tokenize(std::string const& line, std::vector<std::string>& tokens) {
-    std::string token;
+bool ZXFileParser::_tokenize(std::string_view line) {
+    _tokens.clear();
+    std::string_view token;
 
     // parse first token
     size_t pos = dvlab::str::str_get_token(line, token);
-    tokens.emplace_back(token);
+    _tokens.emplace_back(token);
 
     // parsing parenthesis
 
@@ -207,8 +296,8 @@ bool ZXFileParser::_tokenize(std::string const& line, std::vector<std::string>&
     switch (parenthesis_case) {
         case ParenthesisCase::none:
             // coordinate info is left out
-            tokens.emplace_back("-");
-            tokens.emplace_back("-");
+            _tokens.emplace_back("-");
+            _tokens.emplace_back("-");
             break;
         case ParenthesisCase::left:
             _print_failed_at_line_no();
@@ -229,23 +318,23 @@ bool ZXFileParser::_tokenize(std::string const& line, std::vector<std::string>&
                 return false;
             }
 
-            token = dvlab::str::trim_spaces(token);
+            token = strip_spaces(token);
             if (token.empty()) {
                 _print_failed_at_line_no();
                 spdlog::error("missing argument before comma!!");
                 return false;
             }
-            tokens.emplace_back(token);
+            _tokens.emplace_back(token);
 
             dvlab::str::str_get_token(line, token, pos + 1, ')');
 
-            token = dvlab::str::trim_spaces(token);
+            token = strip_spaces(token);
             if (token.empty()) {
                 _print_failed_at_line_no();
                 spdlog::error("missing argument before right parenthesis!!");
                 return false;
             }
-            tokens.emplace_back(token);
+            _tokens.emplace_back(token);
 
             pos = right_paren_pos + 1;
             break;
@@ -255,7 +344,7 @@ bool ZXFileParser::_tokenize(std::string const& line, std::vector<std::string>&
     pos = dvlab::str::str_get_token(line, token, pos);
 
     while (!token.empty()) {
-        tokens.emplace_back(token);
+        _tokens.emplace_back(token);
         pos = dvlab::str::str_get_token(line, token, pos);
     }
 
@@ -266,12 +355,9 @@ bool ZXFileParser::_tokenize(std::string const& line, std::vector<std::string>&
  * @brief Parse type and id
  *
  * @param token
- * @param type
- * @param id
- * @return true
- * @return false
+ * @return std::optional<std::pair<char, size_t>> the type and the id, or std::nullopt if the token is invalid
  */
-std::optional<std::pair<char, size_t>> ZXFileParser::_parse_type_and_id(StorageType const& storage, std::string const& token) {
+std::optional<std::pair<char, size_t>> ZXFileParser::_parse_type_and_id(std::string_view token) {
     auto type = dvlab::str::toupper(token[0]);
 
     if (type == 'G') {
@@ -302,7 +388,7 @@ std::optional<std::pair<char, size_t>> ZXFileParser::_parse_type_and_id(StorageT
         return std::nullopt;
     }
 
-    if (storage.contains(id.value())) {
+    if (_id_to_vertex.contains(id.value())) {
         _print_failed_at_line_no();
         spdlog::error("duplicated vertex ID ({})!!", id);
         return std::nullopt;
@@ -312,24 +398,25 @@ std::optional<std::pair<char, size_t>> ZXFileParser::_parse_type_and_id(StorageT
 }
 
 /**
- * @brief Parse qubit
+ * @brief Parse row
  *
  * @param token
- * @param type input or output
- * @param qubit will store the qubit after parsing
+ * @param row will store the row after parsing
  * @return true
  * @return false
  */
-bool ZXFileParser::_parse_row(std::string const& token, float& row) {
+bool ZXFileParser::_parse_row(std::string_view token, float& row) {
     if (token == "-") {
         return true;
     }
 
-    if (!dvlab::str::str_to_f(token, row)) {
+    auto const parsed = dvlab::str::from_string<float>(token);
+    if (!parsed) {
         _print_failed_at_line_no();
         spdlog::error("row ({}) is not an floating-point number!!", token);
         return false;
     }
+    row = parsed.value();
 
     return true;
 }
@@ -342,17 +429,19 @@ bool ZXFileParser::_parse_row(std::string const& token, float& row) {
  * @return true
  * @return false
  */
-bool ZXFileParser::_parse_column(std::string const& token, float& column) {
+bool ZXFileParser::_parse_column(std::string_view token, float& column) {
     if (token == "-") {
         column = 0;
         return true;
     }
 
-    if (!dvlab::str::str_to_f(token, column)) {
+    auto const parsed = dvlab::str::from_string<float>(token);
+    if (!parsed) {
         _print_failed_at_line_no();
         spdlog::error("column ({}) is not an floating-point number!!", token);
         return false;
     }
+    column = parsed.value();
 
     return true;
 }
@@ -365,9 +454,8 @@ bool ZXFileParser::_parse_column(std::string const& token, float& column) {
  * @return true
  * @return false
  */
-bool ZXFileParser::_parse_neighbors(std::string const& token, std::pair<char, size_t>& neighbor) {
+bool ZXFileParser::_parse_neighbors(std::string_view token, std::pair<char, size_t>& neighbor) {
     auto const type = dvlab::str::toupper(token[0]);
-    unsigned id     = 0;
     if (supported_edge_type.find(type) == std::string::npos) {
         _print_failed_at_line_no();
         spdlog::error("unsupported edge type ({})!!", type);
@@ -382,59 +470,17 @@ bool ZXFileParser::_parse_neighbors(std::string const& token, std::pair<char, si
         return false;
     }
 
-    if (!dvlab::str::str_to_u(neighbor_string, id)) {
+    auto const id = dvlab::str::from_string<unsigned>(neighbor_string);
+    if (!id) {
         _print_failed_at_line_no();
         spdlog::error("neighbor vertex ID ({}) is not an unsigned integer!!", neighbor_string);
         return false;
     }
 
-    neighbor = {type, id};
+    neighbor = {type, id.value()};
     return true;
 }
 
-std::optional<ZXGraph> build_graph_from_parser_storage(StorageType const& storage, bool keep_id) {
-    ZXGraph graph;
-    std::unordered_map<size_t, ZXVertex*> id2_vertex;
-
-    for (auto& [id, info] : storage) {
-        ZXVertex* v = std::invoke(
-            // clang++ does not support structured binding capture by reference with OpenMP
-            [&info = info, &graph]() -> ZXVertex* {
-                switch (info.type) {
-                    case 'I':
-                        return graph.add_input(info.qubit, info.row, info.column);
-                    case 'O':
-                        return graph.add_output(info.qubit, info.row, info.column);
-                    case 'Z':
-                        return graph.add_vertex(VertexType::z, info.phase, info.row, info.column);
-                    case 'X':
-                        return graph.add_vertex(VertexType::x, info.phase, info.row, info.column);
-                    case 'H':
-                        return graph.add_vertex(VertexType::h_box, info.phase, info.row, info.column);
-                    default:
-                        DVLAB_UNREACHABLE("unsupported vertex type");
-                        return nullptr;  // silence warning
-                }
-            });
-
-        if (keep_id) v->set_id(id);
-        id2_vertex[id] = v;
-    }
-
-    for (auto& [vid, info] : storage) {
-        for (auto& [type, nbid] : info.neighbors) {
-            if (!id2_vertex.contains(nbid)) {
-                spdlog::error("failed to build the graph: cannot find vertex with ID {}!!", nbid);
-                return std::nullopt;
-            }
-            auto const etype = (type == 'S') ? EdgeType::simple : EdgeType::hadamard;
-            if (graph.is_neighbor(id2_vertex[vid], id2_vertex[nbid], etype)) continue;
-            graph.add_edge(id2_vertex[vid], id2_vertex[nbid], etype);
-        }
-    }
-    return graph;
-}
-
 std::optional<ZXGraph> build_graph_from_json(nlohmann::json const& data) {
     ZXGraph graph;
     std::unordered_map<std::string, ZXVertex*> vertex_storage;
@@ -528,32 +574,34 @@ std::optional<ZXGraph> build_graph_from_json(nlohmann::json const& data) {
  * @return false
  */
 std::optional<ZXGraph> from_zx(std::filesystem::path const& filepath, bool keep_id) {
-    std::ifstream zx_file(filepath);
+    auto const zx_file = dvlab::utils::MappedFile::open(filepath);
 
-    if (!zx_file.is_open()) {
+    if (!zx_file) {
         spdlog::error("Cannot open the file \"{}\"!!", filepath);
         return std::nullopt;
     }
 
-    auto const storage = detail::ZXFileParser{}.parse(zx_file);
+    auto graph = detail::ZXFileParser{}.parse(zx_file->text(), keep_id);
 
-    if (!storage) {
+    if (!graph) {
         spdlog::error("failed to parse the file \"{}\"!!", filepath.string());
         return std::nullopt;
     }
 
-    return build_graph_from_parser_storage(storage.value(), keep_id);
+    return graph;
 }
 
 std::optional<ZXGraph> from_zx(std::istream& istr, bool keep_id) {
-    auto const storage = detail::ZXFileParser{}.parse(istr);
+    std::string const content{std::istreambuf_iterator<char>{istr}, std::istreambuf_iterator<char>{}};
 
-    if (!storage) {
+    auto graph = detail::ZXFileParser{}.parse(content, keep_id);
+
+    if (!graph) {
         spdlog::error("failed to parse the input stream!!");
         return std::nullopt;
     }
 
-    return build_graph_from_parser_storage(storage.value(), keep_id);
+    return graph;
 }
 
 /**
@@ -20,6 +20,7 @@ namespace zx {
 std::optional<ZXGraph> from_zx(std::filesystem::path const& filename, bool keep_id = false);
 std::optional<ZXGraph> from_zx(std::istream& istr, bool keep_id = false);
 std::optional<ZXGraph> from_json(std::filesystem::path const& filename);
+std::optional<ZXGraph> from_zxb(std::filesystem::path const& filename, bool keep_id = false);
 
 }  // namespace zx
 
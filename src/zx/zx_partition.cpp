@@ -56,6 +56,9 @@ std::pair<std::vector<ZXGraph*>, std::vector<ZXCut>> ZXGraph::create_subgraphs(Z
     // by pass the output qubit id collision check in the copy constructor
     auto next_boundary_qubit_id = max_qubit_id;
 
+    // the subgraphs adopt their vertices from this pool
+    auto& vertex_pool = g._get_vertex_pool();
+
     for (auto& partition : partitions) {
         ZXVertexList subgraph_inputs;
         ZXVertexList subgraph_outputs;
@@ -80,7 +83,7 @@ std::pair<std::vector<ZXGraph*>, std::vector<ZXCut>> ZXGraph::create_subgraphs(Z
             for (auto const& [neighbor, edgeType] : g.get_neighbors(vertex)) {
                 if (partition.contains(neighbor)) continue;
 
-                auto boundary = new ZXVertex(next_vertex_id++, next_boundary_qubit_id--, VertexType::boundary, Phase(), 0, 0);
+                auto boundary = vertex_pool.create(next_vertex_id++, next_boundary_qubit_id--, VertexType::boundary, Phase(), 0, 0);
                 inner_cuts.emplace(vertex, neighbor, edgeType);
                 cut_to_boundary[{vertex, neighbor, edgeType}] = boundary;
 
@@ -104,7 +107,10 @@ std::pair<std::vector<ZXGraph*>, std::vector<ZXCut>> ZXGraph::create_subgraphs(Z
         for (auto const& vertex : boundary_vertices) {
             partition.insert(vertex);
         }
-        subgraphs.push_back(new ZXGraph(partition, subgraph_inputs, subgraph_outputs));
+        // each subgraph gets its own pool so that they can be modified concurrently
+        auto subgraph_pool = std::make_shared<ZXVertexPool>();
+        subgraph_pool->adopt(g._vertex_pool, partition.size());
+        subgraphs.push_back(new ZXGraph(partition, subgraph_inputs, subgraph_outputs, subgraph_pool));
     }
 
     for (auto&& [i, g] : tl::views::enumerate(subgraphs)) {
@@ -138,8 +144,17 @@ ZXGraph ZXGraph::from_subgraphs(std::vector<ZXGraph*> const& subgraphs, std::vec
     ZXVertexList vertices;
     ZXVertexList inputs;
     ZXVertexList outputs;
+    std::shared_ptr<ZXVertexPool> vertex_pool = std::make_shared<ZXVertexPool>();
 
     for (auto subgraph : subgraphs) {
+        // the pool the subgraphs were split from is merged in once no subgraph pool refers to it
+        if (subgraph->_vertex_pool && subgraph->_vertex_pool != vertex_pool) {
+            if (vertex_pool->empty()) {
+                vertex_pool = subgraph->_vertex_pool;
+            } else {
+                vertex_pool->merge(std::move(*subgraph->_vertex_pool));
+            }
+        }
         vertices.insert(subgraph->get_vertices().begin(), subgraph->get_vertices().end());
         inputs.insert(subgraph->get_inputs().begin(), subgraph->get_inputs().end());
         outputs.insert(subgraph->get_outputs().begin(), subgraph->get_outputs().end());
@@ -161,8 +176,8 @@ ZXGraph ZXGraph::from_subgraphs(std::vector<ZXGraph*> const& subgraphs, std::vec
         outputs.erase(b2);
         v1->_neighbors.emplace(v2, new_edge_type);
         v2->_neighbors.emplace(v1, new_edge_type);
-        delete b1;
-        delete b2;
+        vertex_pool->destroy(b1);
+        vertex_pool->destroy(b2);
     }
 
     for (auto subgraph : subgraphs) {
@@ -171,7 +186,7 @@ ZXGraph ZXGraph::from_subgraphs(std::vector<ZXGraph*> const& subgraphs, std::vec
         delete subgraph;
     }
 
-    return ZXGraph(vertices, inputs, outputs);
+    return ZXGraph(vertices, inputs, outputs, vertex_pool);
 }
 
 /*****************************************************/
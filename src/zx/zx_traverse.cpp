@@ -7,6 +7,7 @@
 
 #include <spdlog/spdlog.h>
 
+#include <atomic>
 #include <cstddef>
 #include <list>
 #include <stack>
@@ -16,37 +17,54 @@
 
 namespace qsyn::zx {
 
+namespace {
+
+// Traversals mark the vertices they visit with a fresh epoch instead of
+// keeping a set of visited vertices. The counter is shared by all graphs so
+// that vertices moved between graphs never carry a stale mark.
+std::atomic<size_t> traversal_epoch_counter = 0;
+
+size_t new_traversal_epoch() { return ++traversal_epoch_counter; }
+
+}  // namespace
+
 /**
- * @brief Update Topological Order
+ * @brief Get the topological order of the vertices, which is recomputed only
+ *        if the graph has changed since the last call
  *
  */
-std::vector<ZXVertex*> ZXGraph::create_topological_order() const {
-    std::vector<ZXVertex*> topological_order;
-    std::unordered_set<ZXVertex*> dfs_counters;
+std::vector<ZXVertex*> const& ZXGraph::get_topological_order() const {
+    if (_topological_order_version == _topology_version) return _topological_order;
+
+    auto const epoch = new_traversal_epoch();
+    _topological_order.clear();
+    _topological_order.reserve(_vertices.size());
     for (auto const& v : _inputs) {
-        if (!dfs_counters.contains(v))
-            _dfs(dfs_counters, topological_order, v);
+        if (v->_traversal_epoch != epoch)
+            _dfs(epoch, _topological_order, v);
     }
     for (auto const& v : _outputs) {
-        if (!dfs_counters.contains(v))
-            _dfs(dfs_counters, topological_order, v);
+        if (v->_traversal_epoch != epoch)
+            _dfs(epoch, _topological_order, v);
     }
-    reverse(topological_order.begin(), topological_order.end());
-    spdlog::trace("Topological order from first input: {}", fmt::join(topological_order | std::views::transform([](auto const& v) { return v->get_id(); }), " "));
-    spdlog::trace("Size of topological order: {}", topological_order.size());
+    reverse(_topological_order.begin(), _topological_order.end());
+    _topological_order_version = _topology_version;
+    spdlog::trace("Topological order from first input: {}", fmt::join(_topological_order | std::views::transform([](auto const& v) { return v->get_id(); }), " "));
+    spdlog::trace("Size of topological order: {}", _topological_order.size());
 
-    return topological_order;
+    return _topological_order;
 }
 
 /**
  * @brief Performing DFS from currentVertex
  *
+ * @param epoch the mark of the vertices visited in this traversal
  * @param currentVertex
  */
-void ZXGraph::_dfs(std::unordered_set<ZXVertex*>& visited_vertices, std::vector<ZXVertex*>& topological_order, ZXVertex* v) const {
+void ZXGraph::_dfs(size_t epoch, std::vector<ZXVertex*>& topological_order, ZXVertex* v) const {
     std::stack<std::pair<bool, ZXVertex*>> dfs;
 
-    if (!visited_vertices.contains(v)) {
+    if (v->_traversal_epoch != epoch) {
         dfs.emplace(false, v);
     }
     while (!dfs.empty()) {
@@ -56,14 +74,14 @@ void ZXGraph::_dfs(std::unordered_set<ZXVertex*>& visited_vertices, std::vector<
             topological_order.emplace_back(vertex);
             continue;
         }
-        if (visited_vertices.contains(vertex)) {
+        if (vertex->_traversal_epoch == epoch) {
             continue;
         }
-        visited_vertices.emplace(vertex);
+        vertex->_traversal_epoch = epoch;
         dfs.emplace(true, vertex);
 
         for (auto const& [nb, _] : this->get_neighbors(vertex)) {
-            if (!visited_vertices.contains(nb)) {
+            if (nb->_traversal_epoch != epoch) {
                 dfs.emplace(false, nb);
             }
         }
@@ -75,15 +93,15 @@ void ZXGraph::_dfs(std::unordered_set<ZXVertex*>& visited_vertices, std::vector<
  *
  */
 std::vector<ZXVertex*> ZXGraph::create_breadth_level() const {
-    std::unordered_set<ZXVertex*> bfs_counters;
+    auto const epoch = new_traversal_epoch();
     std::vector<ZXVertex*> breadth_order;
     for (auto const& v : _inputs) {
-        if (!bfs_counters.contains(v))
-            _bfs(bfs_counters, breadth_order, v);
+        if (v->_traversal_epoch != epoch)
+            _bfs(epoch, breadth_order, v);
     }
     for (auto const& v : _outputs) {
-        if (!bfs_counters.contains(v))
-            _bfs(bfs_counters, breadth_order, v);
+        if (v->_traversal_epoch != epoch)
+            _bfs(epoch, breadth_order, v);
     }
 
     return breadth_order;
@@ -92,23 +110,24 @@ std::vector<ZXVertex*> ZXGraph::create_breadth_level() const {
 /**
  * @brief Performing BFS from currentVertex
  *
+ * @param epoch the mark of the vertices visited in this traversal
  * @param current_vertex
  */
-void ZXGraph::_bfs(std::unordered_set<ZXVertex*>& visited_vertices, std::vector<ZXVertex*>& topological_order, ZXVertex* v) const {
+void ZXGraph::_bfs(size_t epoch, std::vector<ZXVertex*>& breadth_order, ZXVertex* v) const {
     std::list<ZXVertex*> queue;
 
-    visited_vertices.emplace(v);
+    v->_traversal_epoch = epoch;
     queue.emplace_back(v);
 
     while (!queue.empty()) {
         ZXVertex* s = queue.front();
 
-        topological_order.emplace_back(s);
+        breadth_order.emplace_back(s);
         queue.pop_front();
 
         for (auto [adjacent, _] : this->get_neighbors(s)) {
-            if (!visited_vertices.contains(adjacent)) {
-                visited_vertices.emplace(adjacent);
+            if (adjacent->_traversal_epoch != epoch) {
+                adjacent->_traversal_epoch = epoch;
                 queue.emplace_back(adjacent);
             }
         }
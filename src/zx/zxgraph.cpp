@@ -10,17 +10,35 @@
 #include <spdlog/spdlog.h>
 
 #include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstdint>
 #include <numeric>
+#include <optional>
 #include <queue>
 #include <ranges>
+#include <unordered_map>
 
 #include "./zx_def.hpp"
 #include "qsyn/qsyn_type.hpp"
 #include "tl/enumerate.hpp"
+#include "tl/to.hpp"
 #include "util/boolean_matrix.hpp"
 
 namespace qsyn::zx {
 
+namespace {
+
+// Transactions mark the vertices whose attributes they have journaled with
+// their epoch. The counter is shared by all graphs so that vertices moved
+// between graphs never carry the mark of another graph's transaction.
+std::atomic<size_t> journal_epoch_counter = 0;
+
+size_t new_journal_epoch() { return ++journal_epoch_counter; }
+
+}  // namespace
+
 /*****************************************************/
 /*   class ZXGraph Getter and setter functions       */
 /*****************************************************/
@@ -31,12 +49,13 @@ namespace qsyn::zx {
  * @param vertices the vertices
  * @param inputs the inputs. Note that the inputs must be a subset of the vertices.
  * @param outputs the outputs. Note that the outputs must be a subset of the vertices.
- * @param id
+ * @param vertex_pool the pool that the vertices are allocated from
  */
 ZXGraph::ZXGraph(ZXVertexList const& vertices,
                  ZXVertexList const& inputs,
-                 ZXVertexList const& outputs)
-    : _inputs{inputs}, _outputs{outputs}, _vertices{vertices} {
+                 ZXVertexList const& outputs,
+                 std::shared_ptr<ZXVertexPool> vertex_pool)
+    : _inputs{inputs}, _outputs{outputs}, _vertices{vertices}, _vertex_pool{std::move(vertex_pool)} {
     for (auto v : _vertices) {
         v->set_id(_next_v_id);
         _id_to_vertices.emplace(_next_v_id, v);
@@ -54,6 +73,9 @@ ZXGraph::ZXGraph(ZXVertexList const& vertices,
 
 ZXGraph::ZXGraph(ZXGraph const& other) : _filename{other._filename}, _procedures{other._procedures}, _next_v_id(other._next_v_id) {
     std::unordered_map<ZXVertex*, ZXVertex*> old_to_new_vertex_map;
+    old_to_new_vertex_map.reserve(other.num_vertices());
+    // allocate room for all vertices at once
+    _get_vertex_pool().reserve(other.num_vertices());
 
     for (auto& v : other.get_vertices()) {
         if (v->is_boundary()) {
@@ -174,6 +196,19 @@ size_t& ZXGraph::_next_vertex_id() {
     return _next_v_id;
 }
 
+/**
+ * @brief Get the pool the vertices of this graph are allocated from.
+ *        The pool is created on first use.
+ *
+ * @return ZXVertexPool&
+ */
+ZXVertexPool& ZXGraph::_get_vertex_pool() {
+    if (!_vertex_pool) {
+        _vertex_pool = std::make_shared<ZXVertexPool>();
+    }
+    return *_vertex_pool;
+}
+
 /*****************************************************/
 /*   class ZXGraph Testing functions                 */
 /*****************************************************/
@@ -353,11 +388,13 @@ ZXVertex* ZXGraph::add_input(size_t id, QubitIdType qubit, float row, float col)
         spdlog::warn("Input qubit {} already exists", qubit);
         return nullptr;
     }
-    auto v = new ZXVertex(id, qubit, VertexType::boundary, Phase(), row, col);
+    auto v = _get_vertex_pool().create(id, qubit, VertexType::boundary, Phase(), row, col);
     _inputs.emplace(v);
     _input_list.emplace(qubit, v);
     _vertices.emplace(v);
     _id_to_vertices.emplace(id, v);
+    _topology_version++;
+    if (_in_transaction) _journal.push_back({.kind = JournalEntry::Kind::add_vertex, .v0 = v});
     return v;
 }
 
@@ -378,11 +415,13 @@ ZXVertex* ZXGraph::add_output(size_t id, QubitIdType qubit, float row, float col
         spdlog::warn("Output qubit {} already exists", qubit);
         return nullptr;
     }
-    auto v = new ZXVertex(id, qubit, VertexType::boundary, Phase(), row, col);
+    auto v = _get_vertex_pool().create(id, qubit, VertexType::boundary, Phase(), row, col);
     _outputs.emplace(v);
     _output_list.emplace(qubit, v);
     _vertices.emplace(v);
     _id_to_vertices.emplace(id, v);
+    _topology_version++;
+    if (_in_transaction) _journal.push_back({.kind = JournalEntry::Kind::add_vertex, .v0 = v});
     return v;
 }
 
@@ -409,9 +448,12 @@ ZXGraph::add_vertex(
         spdlog::warn("Vertex with id {} already exists", id);
         return nullptr;
     }
-    auto v = new ZXVertex(id, 0, vt, phase, row, col);
+    auto v = _get_vertex_pool().create(id, 0, vt, phase, row, col);
     _vertices.emplace(v);
     _id_to_vertices.emplace(id, v);
+    _topology_version++;
+    if (_in_transaction) _journal.push_back({.kind = JournalEntry::Kind::add_vertex, .v0 = v});
+    _log_change(v);
     return v;
 }
 
@@ -441,16 +483,22 @@ void ZXGraph::add_edge(ZXVertex* vs, ZXVertex* vt, EdgeType et) {
             throw std::logic_error(
                 "Cannot add an edge between a boundary vertex and itself");
         }
-        vs->phase() += (et == EdgeType::hadamard ? Phase(1) : Phase(0));
+        _log_change(vs);
+        if (et == EdgeType::hadamard) set_phase(vs, vs->phase() + Phase(1));
         return;
     }
 
     if (vs->get_id() > vt->get_id()) std::swap(vs, vt);
 
+    _log_change(vs);
+    _log_change(vt);
+
     // if vs and vt are not neighbors, simply add the edge
     if (!this->is_neighbor(vs, vt)) {
         vs->_neighbors.emplace(vt, et);
         vt->_neighbors.emplace(vs, et);
+        _topology_version++;
+        _journal_edge(JournalEntry::Kind::add_edge, vs, vt, et);
         return;
     }
 
@@ -486,9 +534,11 @@ void ZXGraph::add_edge(ZXVertex* vs, ZXVertex* vt, EdgeType et) {
             this->remove_edge(vs, vt, to_cancel);
             vs->_neighbors.emplace(vt, to_merge);
             vt->_neighbors.emplace(vs, to_merge);
+            _topology_version++;
+            _journal_edge(JournalEntry::Kind::add_edge, vs, vt, to_merge);
         }
 
-        vs->phase() += Phase(1);
+        set_phase(vs, vs->phase() + Phase(1));
     }
 }
 
@@ -504,12 +554,205 @@ void ZXGraph::add_edge(size_t v0_id, size_t v1_id, EdgeType et) {
     add_edge(vertex(v0_id), vertex(v1_id), et);
 }
 
+namespace {
+
+// below this many vertices, checking each pair in the neighbor sets is cheaper
+// than building the bitset
+constexpr size_t complement_bitset_threshold = 8;
+
+/**
+ * @brief The Hadamard edges among a group of vertices, stored as one
+ *        word-packed row per vertex.
+ *
+ */
+class HadamardAdjacencyBitset {
+public:
+    /**
+     * @brief Build the bitset for `vertices`. Returns std::nullopt if the group
+     *        contains a vertex that is not a Z-spider, a duplicated vertex, or a
+     *        simple edge, as add_edge merges such edges in other ways.
+     *
+     */
+    static std::optional<HadamardAdjacencyBitset> build(ZXGraph const& graph, std::vector<ZXVertex*> const& vertices) {
+        HadamardAdjacencyBitset adjacency{vertices.size()};
+        adjacency._index.reserve(vertices.size());
+        for (auto const& [i, v] : tl::views::enumerate(vertices)) {
+            if (!v->is_z() || !adjacency._index.emplace(v, i).second) return std::nullopt;
+        }
+
+        for (auto const& [i, v] : tl::views::enumerate(vertices)) {
+            for (auto const& [nb, etype] : graph.get_neighbors(v)) {
+                auto const j = adjacency.index_of(nb);
+                if (!j.has_value()) continue;
+                if (etype != EdgeType::hadamard) return std::nullopt;
+                set_bit(adjacency.row(i), *j);
+            }
+        }
+        return adjacency;
+    }
+
+    size_t words_per_row() const { return _words_per_row; }
+
+    std::span<std::uint64_t> row(size_t i) { return {_words.data() + i * _words_per_row, _words_per_row}; }
+
+    std::optional<size_t> index_of(ZXVertex* v) const {
+        auto const it = _index.find(v);
+        return it == _index.end() ? std::nullopt : std::make_optional(it->second);
+    }
+
+    static bool test_bit(std::span<std::uint64_t const> words, size_t j) {
+        return (words[j / 64] >> (j % 64)) & 1;
+    }
+    static void set_bit(std::span<std::uint64_t> words, size_t j) {
+        words[j / 64] |= std::uint64_t{1} << (j % 64);
+    }
+    static void flip_bit(std::span<std::uint64_t> words, size_t j) {
+        words[j / 64] ^= std::uint64_t{1} << (j % 64);
+    }
+    // set the bits [first, last)
+    static void set_bits(std::span<std::uint64_t> words, size_t first, size_t last) {
+        for (size_t w = first / 64; w * 64 < last; ++w) {
+            auto const lo = std::max(first, w * 64) - w * 64;
+            auto const hi = std::min(last, (w + 1) * 64) - w * 64;
+            auto const upper = hi == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << hi) - 1;
+            words[w] |= upper & ~((std::uint64_t{1} << lo) - 1);
+        }
+    }
+
+    // call f(j) on each set bit j of `words`, in increasing order
+    template <typename F>
+    static void for_each_bit(std::span<std::uint64_t const> words, F const& f) {
+        for (size_t w = 0; w < words.size(); ++w) {
+            for (auto word = words[w]; word != 0; word &= word - 1) {
+                f(w * 64 + static_cast<size_t>(std::countr_zero(word)));
+            }
+        }
+    }
+
+private:
+    explicit HadamardAdjacencyBitset(size_t n) : _words_per_row{(n + 63) / 64}, _words(_words_per_row * n, 0) {}
+
+    size_t _words_per_row;
+    std::vector<std::uint64_t> _words;
+    std::unordered_map<ZXVertex*, size_t> _index;
+};
+
+}  // namespace
+
+/**
+ * @brief Complement the Hadamard edges among `group` through its adjacency
+ *        bitset. If `num_lhs` is less than the size of the group, only the
+ *        edges between the first `num_lhs` vertices and the rest are
+ *        complemented. Each row is XORed with the mask of the vertices whose
+ *        edges to it are toggled, and the neighbor set of the vertex is then
+ *        rebuilt from the row in one pass: its other neighbors keep their
+ *        order, and the new ones follow in group order, as they would after
+ *        calling add_edge pair by pair.
+ *
+ * @return false if the bitset cannot be built; the graph is then unchanged
+ */
+bool ZXGraph::_complement_hadamard_rows(std::vector<ZXVertex*> const& group, size_t num_lhs) {
+    using Bitset   = HadamardAdjacencyBitset;
+    auto adjacency = Bitset::build(*this, group);
+    if (!adjacency.has_value()) return false;
+
+    auto const bipartite = num_lhs < group.size();
+    auto toggles         = std::vector<std::uint64_t>(adjacency->words_per_row());
+
+    for (size_t i = 0; i < group.size(); ++i) {
+        std::ranges::fill(toggles, 0);
+        if (!bipartite) {
+            Bitset::set_bits(toggles, 0, group.size());
+            Bitset::flip_bit(toggles, i);
+        } else if (i < num_lhs) {
+            Bitset::set_bits(toggles, num_lhs, group.size());
+        } else {
+            Bitset::set_bits(toggles, 0, num_lhs);
+        }
+
+        auto const row = adjacency->row(i);
+        size_t num_connected = 0;
+        for (size_t w = 0; w < row.size(); ++w) {
+            row[w] ^= toggles[w];
+            num_connected += static_cast<size_t>(std::popcount(row[w] & toggles[w]));
+        }
+
+        auto* v = group[i];
+        _log_change(v);
+
+        Neighbors neighbors;
+        neighbors.reserve(v->_neighbors.size() + num_connected);
+        for (auto const& nbp : v->_neighbors) {
+            auto const j = adjacency->index_of(nbp.first);
+            if (!j.has_value() || !Bitset::test_bit(toggles, *j)) neighbors.emplace(nbp);
+        }
+        for (size_t w = 0; w < row.size(); ++w) toggles[w] &= row[w];
+        Bitset::for_each_bit(toggles, [&](size_t j) { neighbors.emplace(group[j], EdgeType::hadamard); });
+        v->_neighbors = std::move(neighbors);
+
+        // journal each toggled pair once, from the row of its first vertex
+        if (_in_transaction) {
+            auto const first_partner = bipartite ? num_lhs : i + 1;
+            if (!bipartite || i < num_lhs) {
+                for (size_t j = first_partner; j < group.size(); ++j) {
+                    _journal_edge(Bitset::test_bit(row, j) ? JournalEntry::Kind::add_edge : JournalEntry::Kind::remove_edge,
+                                  v, group[j], EdgeType::hadamard);
+                }
+            }
+        }
+    }
+
+    _topology_version++;
+    return true;
+}
+
+/**
+ * @brief Toggle the Hadamard edges between all pairs of `vertices`, in the
+ *        order (0, 1), (0, 2), ..., (1, 2), ...
+ *
+ * @param vertices
+ */
+void ZXGraph::complement_hadamard_edges(std::vector<ZXVertex*> const& vertices) {
+    if (vertices.size() >= complement_bitset_threshold &&
+        _complement_hadamard_rows(vertices, vertices.size())) return;
+
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        for (size_t j = i + 1; j < vertices.size(); ++j) {
+            add_edge(vertices[i], vertices[j], EdgeType::hadamard);
+        }
+    }
+}
+
+/**
+ * @brief Toggle the Hadamard edges between each vertex in `lhs` and each vertex
+ *        in `rhs`, with `lhs` in the outer loop
+ *
+ * @param lhs
+ * @param rhs
+ */
+void ZXGraph::complement_hadamard_edges(std::vector<ZXVertex*> const& lhs, std::vector<ZXVertex*> const& rhs) {
+    if (lhs.size() + rhs.size() >= complement_bitset_threshold && !lhs.empty() && !rhs.empty()) {
+        auto group = lhs;
+        group.insert(group.end(), rhs.begin(), rhs.end());
+        if (_complement_hadamard_rows(group, lhs.size())) return;
+    }
+
+    for (auto* l : lhs) {
+        for (auto* r : rhs) {
+            add_edge(l, r, EdgeType::hadamard);
+        }
+    }
+}
+
 /**
  * @brief Move vertices from the other graph
  *
  * @param vertices
  */
 void ZXGraph::_move_vertices_from(ZXGraph& other) {
+    if (other._vertex_pool && other._vertex_pool != _vertex_pool) {
+        _get_vertex_pool().merge(std::move(*other._vertex_pool));
+    }
     _vertices.insert(other._vertices.begin(), other._vertices.end());
     for (auto v : other._vertices) {
         v->set_id(_next_v_id);
@@ -523,6 +766,8 @@ void ZXGraph::_move_vertices_from(ZXGraph& other) {
     other._input_list.clear();
     other._output_list.clear();
     other._id_to_vertices.clear();
+    _topology_version++;
+    other._topology_version++;
 }
 
 /*****************************************************/
@@ -555,22 +800,34 @@ size_t ZXGraph::remove_vertex(ZXVertex* v) {
         ZXVertex* const nv = n.first;
         EdgeType const ne  = n.second;
         nv->_neighbors.erase({v, ne});
+        _journal_edge(JournalEntry::Kind::remove_edge, v, nv, ne);
+        _log_change(nv);
     }
     _vertices.erase(v);
     _id_to_vertices.erase(v->get_id());
+    _topology_version++;
+
+    auto const was_input  = _inputs.contains(v);
+    auto const was_output = _outputs.contains(v);
 
     // Check if also in _inputs or _outputs
-    if (_inputs.contains(v)) {
+    if (was_input) {
         _input_list.erase(v->get_qubit());
         _inputs.erase(v);
     }
-    if (_outputs.contains(v)) {
+    if (was_output) {
         _output_list.erase(v->get_qubit());
         _outputs.erase(v);
     }
 
+    if (_in_transaction) {
+        // keep the vertex alive so that a rollback can put it back
+        _journal.push_back({.kind = JournalEntry::Kind::remove_vertex, .v0 = v, .was_input = was_input, .was_output = was_output});
+        return 1;
+    }
+
     // deallocate ZXVertex
-    delete v;
+    _vertex_pool->destroy(v);
     return 1;
 }
 
@@ -634,6 +891,12 @@ size_t ZXGraph::remove_edge(ZXVertex* vs, ZXVertex* vt, EdgeType etype) {
     if (count == 1) {
         throw std::out_of_range("Graph connection error in " + std::to_string(vs->get_id()) + " and " + std::to_string(vt->get_id()));
     }
+    if (count != 0) {
+        _topology_version++;
+        _journal_edge(JournalEntry::Kind::remove_edge, vs, vt, etype);
+        _log_change(vs);
+        _log_change(vt);
+    }
 
     return count / 2;
 }
@@ -661,6 +924,169 @@ size_t ZXGraph::remove_edge(ZXVertex* vs, ZXVertex* vt) {
     return remove_edge(vs, vt, EdgeType::simple) + remove_edge(vs, vt, EdgeType::hadamard);
 }
 
+/**
+ * @brief Start logging the vertices whose surroundings are changed. The log
+ *        and the bookmarks start empty.
+ *
+ */
+void ZXGraph::start_change_log() {
+    stop_change_log();
+    _logging_changes = true;
+}
+
+void ZXGraph::stop_change_log() {
+    _logging_changes = false;
+    _change_log.clear();
+    _change_log_dedup_from = 0;
+    _change_log_bookmarks.clear();
+    for (auto const& v : _vertices) {
+        v->_change_log_index = SIZE_MAX;
+    }
+}
+
+/**
+ * @brief Get the current end of the change log, to be passed to
+ *        `get_changed_vertices` later.
+ *
+ * @return size_t
+ */
+size_t ZXGraph::change_log_position() {
+    _change_log_dedup_from = _change_log.size();
+    return _change_log.size();
+}
+
+/**
+ * @brief Get the vertices still in the graph that were logged at or after
+ *        `since`, without duplicates.
+ *
+ * @param since a position obtained from `change_log_position`
+ * @return std::vector<ZXVertex*>
+ */
+std::vector<ZXVertex*> ZXGraph::get_changed_vertices(size_t since) const {
+    // removed vertices are skipped; their storage may since have been reused
+    // by a new vertex, which then has been logged on its own
+    std::vector<ZXVertex*> changed;
+    for (size_t i = since; i < _change_log.size(); ++i) {
+        if (_vertices.contains(_change_log[i])) changed.emplace_back(_change_log[i]);
+    }
+    std::ranges::sort(changed);
+    auto const [first, last] = std::ranges::unique(changed);
+    changed.erase(first, last);
+    return changed;
+}
+
+std::optional<size_t> ZXGraph::get_change_log_bookmark(std::string const& name) const {
+    if (auto it = _change_log_bookmarks.find(name); it != _change_log_bookmarks.end()) {
+        return it->second;
+    }
+    return std::nullopt;
+}
+
+/**
+ * @brief Start journaling the mutations of the graph.
+ *
+ */
+void ZXGraph::begin_transaction() {
+    if (_in_transaction) {
+        throw std::logic_error("ZXGraph transactions cannot be nested");
+    }
+    _in_transaction    = true;
+    _journal_next_v_id = _next_v_id;
+    // a fresh epoch makes every vertex journal its attributes once more
+    _journal_epoch = new_journal_epoch();
+}
+
+/**
+ * @brief Keep the mutations since `begin_transaction` and release the
+ *        vertices removed in the meantime.
+ *
+ */
+void ZXGraph::commit_transaction() {
+    if (!_in_transaction) {
+        throw std::logic_error("No ZXGraph transaction to commit");
+    }
+    _discard_journal();
+    _in_transaction = false;
+}
+
+/**
+ * @brief Undo the mutations since `begin_transaction`, latest first.
+ *        Vertices touched by the rollback are logged in the change log.
+ *
+ */
+void ZXGraph::rollback_transaction() {
+    if (!_in_transaction) {
+        throw std::logic_error("No ZXGraph transaction to roll back");
+    }
+    // stop journaling so that the inverse operations are not journaled
+    _in_transaction = false;
+
+    for (auto const& entry : _journal | std::views::reverse) {
+        auto const v = entry.v0;
+        switch (entry.kind) {
+            case JournalEntry::Kind::add_vertex:
+                _vertices.erase(v);
+                _id_to_vertices.erase(v->get_id());
+                if (_inputs.contains(v)) {
+                    _input_list.erase(v->get_qubit());
+                    _inputs.erase(v);
+                }
+                if (_outputs.contains(v)) {
+                    _output_list.erase(v->get_qubit());
+                    _outputs.erase(v);
+                }
+                _vertex_pool->destroy(v);
+                break;
+            case JournalEntry::Kind::remove_vertex:
+                _vertices.emplace(v);
+                _id_to_vertices.emplace(v->get_id(), v);
+                if (entry.was_input) {
+                    _inputs.emplace(v);
+                    _input_list.emplace(v->get_qubit(), v);
+                }
+                if (entry.was_output) {
+                    _outputs.emplace(v);
+                    _output_list.emplace(v->get_qubit(), v);
+                }
+                _log_change(v);
+                break;
+            case JournalEntry::Kind::add_edge:
+                v->_neighbors.erase({entry.v1, entry.etype});
+                entry.v1->_neighbors.erase({v, entry.etype});
+                _log_change(v);
+                _log_change(entry.v1);
+                break;
+            case JournalEntry::Kind::remove_edge:
+                v->_neighbors.emplace(entry.v1, entry.etype);
+                entry.v1->_neighbors.emplace(v, entry.etype);
+                _log_change(v);
+                _log_change(entry.v1);
+                break;
+            case JournalEntry::Kind::set_attributes:
+                v->_attrs = *entry.attrs;
+                _log_change(v);
+                break;
+        }
+    }
+    _journal.clear();
+    _next_v_id = _journal_next_v_id;
+    _topology_version++;
+}
+
+/**
+ * @brief Clear the journal, releasing the vertices that were removed during
+ *        the transaction.
+ *
+ */
+void ZXGraph::_discard_journal() {
+    for (auto const& entry : _journal) {
+        if (entry.kind == JournalEntry::Kind::remove_vertex) {
+            _vertex_pool->destroy(entry.v0);
+        }
+    }
+    _journal.clear();
+}
+
 /*****************************************************/
 /*   class ZXGraph Operation on graph functions.     */
 /*****************************************************/
@@ -672,10 +1098,11 @@ size_t ZXGraph::remove_edge(ZXVertex* vs, ZXVertex* vt) {
 void ZXGraph::adjoint() {
     std::swap(_inputs, _outputs);
     std::swap(_input_list, _output_list);
+    _topology_version++;
     auto max_col = std::ranges::max(_vertices | std::views::transform([](ZXVertex* v) { return v->get_col(); }));
 
-    std::ranges::for_each(_vertices, [&max_col](ZXVertex* v) {
-        v->phase() *= -1;
+    std::ranges::for_each(_vertices, [this, &max_col](ZXVertex* v) {
+        set_phase(v, v->phase() * -1);
         v->set_col(max_col - v->get_col());
     });
 }
@@ -721,6 +1148,102 @@ dvlab::BooleanMatrix get_biadjacency_matrix(ZXGraph const& graph, ZXVertexList c
     return matrix;
 }
 
+/**
+ * @brief Get the biadjacency matrix between `row_vertices` and `col_vertices`.
+ *        Rows and columns of vertices that were in the previous lists are
+ *        permuted from the previous matrix; only those of the new vertices
+ *        are read from the graph.
+ *
+ * @return dvlab::BooleanMatrix const& : the matrix, valid until the next call
+ */
+dvlab::BooleanMatrix const& BiadjacencyCache::update(ZXGraph const& graph, ZXVertexList const& row_vertices, ZXVertexList const& col_vertices) {
+    std::unordered_map<size_t, size_t> prev_row_indices;
+    for (auto const& [i, id] : _row_ids | tl::views::enumerate) {
+        prev_row_indices.emplace(id, i);
+    }
+    std::unordered_map<size_t, size_t> row_indices;
+    for (auto const& [i, v] : row_vertices | tl::views::enumerate) {
+        row_indices.emplace(v->get_id(), i);
+    }
+    std::unordered_map<size_t, size_t> col_indices;
+    for (auto const& [j, v] : col_vertices | tl::views::enumerate) {
+        col_indices.emplace(v->get_id(), j);
+    }
+
+    // maps each previous column to its new index, if it is still a column
+    std::vector<std::optional<size_t>> col_map(_col_ids.size());
+    std::unordered_map<size_t, size_t> prev_col_indices;
+    for (auto const& [j, id] : _col_ids | tl::views::enumerate) {
+        prev_col_indices.emplace(id, j);
+        if (auto const itr = col_indices.find(id); itr != col_indices.end()) {
+            col_map[j] = itr->second;
+        }
+    }
+
+    dvlab::BooleanMatrix matrix(row_vertices.size(), col_vertices.size());
+
+    for (auto const& [i, v] : row_vertices | tl::views::enumerate) {
+        auto const prev_row = prev_row_indices.find(v->get_id());
+        if (prev_row == prev_row_indices.end()) {
+            for (auto const& [nb, _] : graph.get_neighbors(v)) {
+                if (auto const itr = col_indices.find(nb->get_id()); itr != col_indices.end()) {
+                    matrix[i][itr->second] = 1;
+                }
+            }
+            continue;
+        }
+        // only visits the ones of the previous row
+        auto const& words = _matrix[prev_row->second].get_words();
+        for (auto const& [w, word] : words | tl::views::enumerate) {
+            for (auto bits = word; bits != 0; bits &= bits - 1) {
+                auto const prev_col = w * dvlab::BooleanMatrix::Row::word_bits + std::countr_zero(bits);
+                if (col_map[prev_col].has_value()) {
+                    matrix[i][*col_map[prev_col]] = 1;
+                }
+            }
+        }
+    }
+
+    // new columns still have to be read for the rows carried over
+    for (auto const& [j, w] : col_vertices | tl::views::enumerate) {
+        if (prev_col_indices.contains(w->get_id())) continue;
+        for (auto const& [nb, _] : graph.get_neighbors(w)) {
+            if (!prev_row_indices.contains(nb->get_id())) continue;
+            if (auto const itr = row_indices.find(nb->get_id()); itr != row_indices.end()) {
+                matrix[itr->second][j] = 1;
+            }
+        }
+    }
+
+    _matrix  = std::move(matrix);
+    _row_ids = row_vertices | std::views::transform([](ZXVertex* v) { return v->get_id(); }) | tl::to<std::vector>();
+    _col_ids = col_vertices | std::views::transform([](ZXVertex* v) { return v->get_id(); }) | tl::to<std::vector>();
+    return _matrix;
+}
+
+/**
+ * @brief Record that the edges between `row_vertices` and `col_vertices` in
+ *        the graph are given by `matrix`, e.g., after writing it back.
+ *
+ */
+void BiadjacencyCache::assign(dvlab::BooleanMatrix const& matrix, ZXVertexList const& row_vertices, ZXVertexList const& col_vertices) {
+    assert(matrix.num_rows() == row_vertices.size());
+    _matrix  = matrix;
+    _row_ids = row_vertices | std::views::transform([](ZXVertex* v) { return v->get_id(); }) | tl::to<std::vector>();
+    _col_ids = col_vertices | std::views::transform([](ZXVertex* v) { return v->get_id(); }) | tl::to<std::vector>();
+}
+
+/**
+ * @brief Forget the previous matrix, so that the next update reads every
+ *        entry from the graph.
+ *
+ */
+void BiadjacencyCache::invalidate() {
+    _matrix.reset();
+    _row_ids.clear();
+    _col_ids.clear();
+}
+
 // free functions that compute graph properties'
 
 /**
@@ -10,22 +10,28 @@
 #include <spdlog/spdlog.h>
 
 #include <cstddef>
+#include <cstdint>
 #include <filesystem>
 #include <iterator>
+#include <memory>
+#include <optional>
 #include <span>
 #include <string>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "./zx_def.hpp"
 #include "qsyn/qsyn_type.hpp"
 #include "spdlog/common.h"
 #include "util/boolean_matrix.hpp"
+#include "util/slab_pool.hpp"
 
 namespace qsyn::zx {
 
 class ZXVertex;
 class ZXGraph;
+class CompactZXGraph;
 
 // See `zxVertex.cpp` for details
 std::optional<EdgeType> str_to_edge_type(std::string const& str);
@@ -108,8 +114,13 @@ private:
         float col;
     } _attrs;
     Neighbors _neighbors;
+    size_t _change_log_index = SIZE_MAX;  // latest entry in the change log of the graph
+    size_t _journal_epoch    = 0;         // the transaction in which the attributes were last journaled
+    size_t _traversal_epoch  = 0;         // the traversal that last visited this vertex
 };
 
+using ZXVertexPool = dvlab::utils::slab_pool<ZXVertex>;
+
 class ZXGraph {  // NOLINT(cppcoreguidelines-special-member-functions)
                  // : copy-swap idiom
 public:
@@ -117,11 +128,13 @@ public:
 
     ZXGraph(ZXVertexList const& vertices,
             ZXVertexList const& inputs,
-            ZXVertexList const& outputs);
+            ZXVertexList const& outputs,
+            std::shared_ptr<ZXVertexPool> vertex_pool);
 
     ~ZXGraph() {
+        _discard_journal();
         for (auto const& v : _vertices) {
-            delete v;
+            _vertex_pool->destroy(v);
         }
     }
 
@@ -135,6 +148,7 @@ public:
     }
 
     void release() {
+        _discard_journal();
         _next_v_id = 0;
         _filename  = "";
         _procedures.clear();
@@ -144,6 +158,14 @@ public:
         _input_list.clear();
         _output_list.clear();
         _id_to_vertices.clear();
+        _vertex_pool.reset();
+        _logging_changes = false;
+        _change_log.clear();
+        _change_log_dedup_from = 0;
+        _change_log_bookmarks.clear();
+        _in_transaction = false;
+        _topology_version++;
+        _topological_order.clear();
     }
 
     void swap(ZXGraph& other) noexcept {
@@ -156,6 +178,18 @@ public:
         std::swap(_input_list, other._input_list);
         std::swap(_output_list, other._output_list);
         std::swap(_id_to_vertices, other._id_to_vertices);
+        std::swap(_vertex_pool, other._vertex_pool);
+        std::swap(_logging_changes, other._logging_changes);
+        std::swap(_change_log, other._change_log);
+        std::swap(_change_log_dedup_from, other._change_log_dedup_from);
+        std::swap(_change_log_bookmarks, other._change_log_bookmarks);
+        std::swap(_in_transaction, other._in_transaction);
+        std::swap(_journal, other._journal);
+        std::swap(_journal_epoch, other._journal_epoch);
+        std::swap(_journal_next_v_id, other._journal_next_v_id);
+        std::swap(_topology_version, other._topology_version);
+        std::swap(_topological_order_version, other._topological_order_version);
+        std::swap(_topological_order, other._topological_order);
     }
 
     friend void swap(ZXGraph& a, ZXGraph& b) noexcept {
@@ -200,6 +234,10 @@ public:
     void add_procedure(std::string_view p) { _procedures.emplace_back(p); }
 
     std::string get_filename() const { return _filename; }
+
+    ZXVertexPool::statistics get_vertex_pool_statistics() const {
+        return _vertex_pool ? _vertex_pool->get_statistics() : ZXVertexPool::statistics{};
+    }
     std::vector<std::string> const& get_procedures() const {
         return _procedures;
     }
@@ -264,6 +302,13 @@ public:
     void add_edge(ZXVertex* vs, ZXVertex* vt, EdgeType et);
     void add_edge(size_t v0_id, size_t v1_id, EdgeType et);
 
+    // Same as calling add_edge(u, v, EdgeType::hadamard) on every pair of
+    // `vertices` (resp. every pair across `lhs` and `rhs`), in order. Large
+    // groups of Z-spiders are complemented by XORing the rows of their
+    // adjacency bitset, and each neighbor set is then rebuilt once.
+    void complement_hadamard_edges(std::vector<ZXVertex*> const& vertices);
+    void complement_hadamard_edges(std::vector<ZXVertex*> const& lhs, std::vector<ZXVertex*> const& rhs);
+
     size_t remove_isolated_vertices();
     size_t remove_vertex(ZXVertex* v);
     size_t remove_vertex(size_t id);
@@ -276,6 +321,48 @@ public:
     size_t remove_edge(size_t v0_id, size_t v1_id, EdgeType etype);
     size_t remove_edges(std::span<EdgePair const> epairs);
 
+    // Attribute changes that should be undone by `rollback_transaction`
+    // must go through these setters rather than `ZXVertex::phase()`.
+
+    void set_phase(ZXVertex* v, Phase const& phase) {
+        _journal_attributes(v);
+        v->phase() = phase;
+    }
+    void set_vertex_type(ZXVertex* v, VertexType vt) {
+        _journal_attributes(v);
+        v->type() = vt;
+    }
+
+    // Transactions. Between `begin_transaction` and `commit_transaction`,
+    // every vertex and edge added or removed and every attribute changed
+    // through the setters above is journaled, so that `rollback_transaction`
+    // can restore the graph in time proportional to the number of changes.
+    // Removed vertices stay allocated until the transaction ends, so pointers
+    // taken before the transaction are valid again after a rollback. The
+    // iteration order of vertices and neighbors may differ after a rollback.
+    // Transactions do not nest.
+
+    void begin_transaction();
+    void commit_transaction();
+    void rollback_transaction();
+    bool in_transaction() const { return _in_transaction; }
+    size_t transaction_size() const { return _journal.size(); }
+
+    // Change log. While enabled, every added vertex, the endpoints of every
+    // added or removed edge and the neighbors of every removed vertex are
+    // logged. Phase changes are not observed; they are assumed to come
+    // together with a change of edges around the vertex. Bookmarks let
+    // several clients remember how far they have read the log.
+
+    void start_change_log();
+    void stop_change_log();
+    bool is_logging_changes() const { return _logging_changes; }
+    size_t change_log_position();
+    std::vector<ZXVertex*> get_changed_vertices(size_t since) const;
+    std::optional<size_t> get_change_log_bookmark(std::string const& name) const;
+    void set_change_log_bookmark(std::string const& name, size_t position) { _change_log_bookmarks[name] = position; }
+    void clear_change_log_bookmarks() { _change_log_bookmarks.clear(); }
+
     // Operation on graph
     void adjoint();
     void assign_vertex_to_boundary(
@@ -325,6 +412,7 @@ public:
     bool write_zx(
         std::filesystem::path const& filename, bool complete = false) const;
     bool write_json(std::filesystem::path const& filename) const;
+    bool write_zxb(std::filesystem::path const& filename) const;  // in zx_binary_io.cpp
     bool write_tikz(std::string const& filename) const;
     bool write_tikz(std::ostream& os) const;
     bool write_pdf(std::string const& filename) const;
@@ -332,15 +420,18 @@ public:
     bool write_tex(std::ostream& os) const;
 
     // Traverse (in zxTraverse.cpp)
-    std::vector<ZXVertex*> create_topological_order() const;
+    // The topological order is cached until the vertices, edges or boundaries
+    // of the graph change. The cache is not thread-safe.
+    std::vector<ZXVertex*> const& get_topological_order() const;
+    std::vector<ZXVertex*> create_topological_order() const { return get_topological_order(); }
     std::vector<ZXVertex*> create_breadth_level() const;
     template <typename F>
     void topological_traverse(F lambda) {
-        std::ranges::for_each(create_topological_order(), lambda);
+        std::ranges::for_each(get_topological_order(), lambda);
     }
     template <typename F>
     void topological_traverse(F lambda) const {
-        std::ranges::for_each(create_topological_order(), lambda);
+        std::ranges::for_each(get_topological_order(), lambda);
     }
     template <typename F>
     void for_each_edge(F lambda) const {
@@ -372,6 +463,9 @@ public:
         std::vector<ZXCut> const& cuts);
 
 private:
+    // converts to and from ZXGraph, carrying the next vertex ID across
+    friend class CompactZXGraph;
+
     mutable size_t _next_v_id = 0;
     std::string _filename;
     std::vector<std::string> _procedures;
@@ -381,14 +475,67 @@ private:
     std::unordered_map<size_t, ZXVertex*> _input_list;
     std::unordered_map<size_t, ZXVertex*> _output_list;
     std::unordered_map<size_t, ZXVertex*> _id_to_vertices;
-
+    // vertex storage; the subgraphs created by `create_subgraphs` adopt their vertices from it
+    std::shared_ptr<ZXVertexPool> _vertex_pool;
+    bool _logging_changes = false;
+    // may hold removed vertices; get_changed_vertices() filters them out
+    std::vector<ZXVertex*> _change_log;
+    // a vertex logged at or after this index is not logged again, as every
+    // position handed out so far precedes that entry
+    size_t _change_log_dedup_from = 0;
+    std::unordered_map<std::string, size_t> _change_log_bookmarks;
+
+    struct JournalEntry {
+        enum class Kind : std::uint8_t {
+            add_vertex,
+            remove_vertex,
+            add_edge,
+            remove_edge,
+            set_attributes,
+        };
+        Kind kind;
+        ZXVertex* v0;
+        ZXVertex* v1      = nullptr;
+        EdgeType etype    = EdgeType::simple;
+        bool was_input    = false;  // remove_vertex only
+        bool was_output   = false;  // remove_vertex only
+        std::optional<ZXVertex::ZXVertexAttrs> attrs;  // set_attributes only
+    };
+    bool _in_transaction = false;
+    std::vector<JournalEntry> _journal;
+    size_t _journal_epoch     = 0;  // of the current transaction; unique across all graphs
+    size_t _journal_next_v_id = 0;
+
+    // bumped whenever the vertices, edges or boundaries change
+    size_t _topology_version = 0;
+    mutable size_t _topological_order_version = SIZE_MAX;
+    mutable std::vector<ZXVertex*> _topological_order;
+
+    ZXVertexPool& _get_vertex_pool();
+    void _journal_attributes(ZXVertex* v) {
+        if (!_in_transaction || v->_journal_epoch == _journal_epoch) return;
+        v->_journal_epoch = _journal_epoch;
+        _journal.push_back({.kind = JournalEntry::Kind::set_attributes, .v0 = v, .attrs = v->_attrs});
+    }
+    void _journal_edge(JournalEntry::Kind kind, ZXVertex* vs, ZXVertex* vt, EdgeType et) {
+        if (!_in_transaction) return;
+        _journal.push_back({.kind = kind, .v0 = vs, .v1 = vt, .etype = et});
+    }
+    void _discard_journal();
+    bool _complement_hadamard_rows(std::vector<ZXVertex*> const& group, size_t num_lhs);
+    void _log_change(ZXVertex* v) {
+        if (!_logging_changes) return;
+        if (v->_change_log_index != SIZE_MAX && v->_change_log_index >= _change_log_dedup_from) return;
+        v->_change_log_index = _change_log.size();
+        _change_log.emplace_back(v);
+    }
     void _dfs(
-        std::unordered_set<ZXVertex*>& visited_vertices,
+        size_t epoch,
         std::vector<ZXVertex*>& topological_order,
         ZXVertex* v) const;
     void _bfs(
-        std::unordered_set<ZXVertex*>& visited_vertices,
-        std::vector<ZXVertex*>& topological_order,
+        size_t epoch,
+        std::vector<ZXVertex*>& breadth_order,
         ZXVertex* v) const;
 
     size_t const& _next_vertex_id() const;
@@ -418,4 +565,31 @@ dvlab::BooleanMatrix get_biadjacency_matrix(
     ZXVertexList const& row_vertices,
     ZXVertexList const& col_vertices);
 
+/**
+ * @brief Keeps the biadjacency matrix between two vertex lists of a ZXGraph
+ *        across changes to the lists. On `update`, only the rows and columns
+ *        of vertices that are new to the lists are read from the graph; the
+ *        others are carried over from the previous matrix. The owner must
+ *        `invalidate` the cache whenever it changes edges between vertices
+ *        that remain in the lists, unless it records the change via `assign`.
+ *
+ */
+class BiadjacencyCache {
+public:
+    dvlab::BooleanMatrix const& update(
+        ZXGraph const& graph,
+        ZXVertexList const& row_vertices,
+        ZXVertexList const& col_vertices);
+    void assign(
+        dvlab::BooleanMatrix const& matrix,
+        ZXVertexList const& row_vertices,
+        ZXVertexList const& col_vertices);
+    void invalidate();
+
+private:
+    dvlab::BooleanMatrix _matrix;
+    std::vector<size_t> _row_ids;
+    std::vector<size_t> _col_ids;
+};
+
 }  // namespace qsyn::zx
@@ -30,6 +30,7 @@ namespace qsyn::zx {
 void ZXGraph::sort_io_by_qubit() {
     _inputs.sort([](ZXVertex* a, ZXVertex* b) { return a->get_qubit() < b->get_qubit(); });
     _outputs.sort([](ZXVertex* a, ZXVertex* b) { return a->get_qubit() < b->get_qubit(); });
+    _topology_version++;
 }
 
 /**
@@ -99,8 +100,8 @@ ZXGraph& ZXGraph::compose(ZXGraph const& target) {
     auto itr_ori = _outputs.begin();
     auto itr_cop = copied_graph.get_inputs().begin();
     for (; itr_ori != _outputs.end(); ++itr_ori, ++itr_cop) {
-        (*itr_ori)->type() = VertexType::z;
-        (*itr_cop)->type() = VertexType::z;
+        this->set_vertex_type(*itr_ori, VertexType::z);
+        copied_graph.set_vertex_type(*itr_cop, VertexType::z);
         this->add_edge((*itr_ori), (*itr_cop), EdgeType::simple);
     }
 
@@ -249,7 +250,7 @@ void toggle_vertex(ZXGraph& graph, size_t v_id) {
     for (auto& [nb, etype] : old_neighbors) {
         graph.add_edge(v, nb, toggle_edge(etype));
     }
-    v->type() = (v->type() == VertexType::z ? VertexType::x : VertexType::z);
+    graph.set_vertex_type(v, v->type() == VertexType::z ? VertexType::x : VertexType::z);
 }
 
 /**
@@ -328,7 +329,7 @@ void gadgetize_phase(ZXGraph& graph, size_t v_id, Phase const& keep_phase) {
         VertexType::z, v->phase() - keep_phase, -2, v->get_col());
     ZXVertex* buffer = graph.add_vertex(
         VertexType::z, Phase(0), -1, v->get_col());
-    v->phase() = keep_phase;
+    graph.set_phase(v, keep_phase);
 
     graph.add_edge(leaf, buffer, EdgeType::hadamard);
     graph.add_edge(buffer, v, EdgeType::hadamard);
@@ -468,7 +469,7 @@ void IdentityFusion::apply_unchecked(ZXGraph& graph) const {
         _right_neighbors.emplace_back(nb->get_id());
 
         if (nb == l) {
-            l->phase() += Phase(1);
+            graph.set_phase(l, l->phase() + Phase(1));
             continue;
         }
 
@@ -478,7 +479,7 @@ void IdentityFusion::apply_unchecked(ZXGraph& graph) const {
     graph.remove_vertex(v);
     graph.remove_vertex(r);
 
-    l->phase() += _right_phase;
+    graph.set_phase(l, l->phase() + _right_phase);
 }
 
 void IdentityFusion::undo_unchecked(ZXGraph& graph) const {
@@ -493,11 +494,11 @@ void IdentityFusion::undo_unchecked(ZXGraph& graph) const {
     graph.add_edge(l, v, EdgeType::hadamard);
     graph.add_edge(v, r, EdgeType::hadamard);
 
-    l->phase() -= r->phase();
+    graph.set_phase(l, l->phase() - r->phase());
 
     for (auto const& nb_id : _right_neighbors) {
         if (nb_id == _left_id) {
-            l->phase() += Phase(1);
+            graph.set_phase(l, l->phase() + Phase(1));
             graph.add_edge(l, r, EdgeType::hadamard);
         } else {
             auto nb    = graph[nb_id];
@@ -735,9 +736,13 @@ bool LComp::is_undoable(ZXGraph const& graph) const {
 }
 
 void LComp::_complement_neighbors(ZXGraph& graph) const {
-    for (auto const& [i, j] : dvlab::combinations<2>(_neighbors)) {
-        graph.add_edge(i, j, EdgeType::hadamard);
-    }
+    // toggle the pairs in ascending ID order, as dvlab::combinations would
+    auto neighbor_ids = _neighbors;
+    std::ranges::sort(neighbor_ids);
+    graph.complement_hadamard_edges(
+        neighbor_ids |
+        std::views::transform([&graph](size_t id) { return graph[id]; }) |
+        tl::to<std::vector>());
 }
 
 void LComp::apply_unchecked(ZXGraph& graph) const {
@@ -756,7 +761,7 @@ void LComp::apply_unchecked(ZXGraph& graph) const {
 
     for (auto const& [nb, etype] : graph.get_neighbors(v)) {
         _neighbors.emplace_back(nb->get_id());
-        nb->phase() -= _v_phase;
+        graph.set_phase(nb, nb->phase() - _v_phase);
     }
 
     // toggle all edges between neighbors
@@ -770,7 +775,7 @@ void LComp::undo_unchecked(ZXGraph& graph) const {
         _v_id, VertexType::z, _v_phase, 0, 0);
 
     for (auto const& nb_id : _neighbors) {
-        graph[nb_id]->phase() += _v_phase;
+        graph.set_phase(graph[nb_id], graph[nb_id]->phase() + _v_phase);
         graph.add_edge(v, graph[nb_id], EdgeType::hadamard);
     }
 
@@ -831,31 +836,32 @@ bool Pivot::is_undoable(ZXGraph const& graph) const {
 }
 
 void Pivot::_complement_neighbors(ZXGraph& graph) const {
-    auto const add_edges_between = [&](std::vector<size_t> const& v1s,
-                                       std::vector<size_t> const& v2s) {
-        for (auto const& i : v1s) {
-            for (auto const& j : v2s) {
-                graph.add_edge(i, j, EdgeType::hadamard);
-            }
-        }
+    auto const to_vertices = [&graph](std::vector<size_t> const& ids) {
+        return ids |
+               std::views::transform([&graph](size_t id) { return graph[id]; }) |
+               tl::to<std::vector>();
     };
 
-    add_edges_between(_v1_neighbors, _v2_neighbors);
-    add_edges_between(_v1_neighbors, _both_neighbors);
-    add_edges_between(_v2_neighbors, _both_neighbors);
+    auto const v1_neighbors   = to_vertices(_v1_neighbors);
+    auto const v2_neighbors   = to_vertices(_v2_neighbors);
+    auto const both_neighbors = to_vertices(_both_neighbors);
+
+    graph.complement_hadamard_edges(v1_neighbors, v2_neighbors);
+    graph.complement_hadamard_edges(v1_neighbors, both_neighbors);
+    graph.complement_hadamard_edges(v2_neighbors, both_neighbors);
 }
 
 void Pivot::_adjust_phases(ZXGraph& graph) const {
     for (auto const& v_id : _v1_neighbors) {
-        graph[v_id]->phase() += _v2_phase;
+        graph.set_phase(graph[v_id], graph[v_id]->phase() + _v2_phase);
     }
 
     for (auto const& v_id : _v2_neighbors) {
-        graph[v_id]->phase() += _v1_phase;
+        graph.set_phase(graph[v_id], graph[v_id]->phase() + _v1_phase);
     }
 
     for (auto const& v_id : _both_neighbors) {
-        graph[v_id]->phase() += _v1_phase + _v2_phase + Phase(1);
+        graph.set_phase(graph[v_id], graph[v_id]->phase() + _v1_phase + _v2_phase + Phase(1));
     }
 }
 
@@ -1031,7 +1037,7 @@ void NeighborUnfusion::apply_unchecked(ZXGraph& graph) const {
                                       Phase(0),
                                       -1);
     _buffer_v_id   = buffer->get_id();
-    v->phase()     = _phase_to_keep;
+    graph.set_phase(v, _phase_to_keep);
 
     graph.add_edge(*_buffer_v_id, *_unfused_v_id, EdgeType::hadamard);
     graph.add_edge(_v_id, *_buffer_v_id, EdgeType::hadamard);
@@ -1055,7 +1061,7 @@ void NeighborUnfusion::undo_unchecked(ZXGraph& graph) const {
         graph.add_edge(_v_id, nb_id, etype);
     }
 
-    graph[_v_id]->phase() += unfused->phase();
+    graph.set_phase(graph[_v_id], graph[_v_id]->phase() + unfused->phase());
 
     graph.remove_vertex(*_buffer_v_id);
     graph.remove_vertex(*_unfused_v_id);
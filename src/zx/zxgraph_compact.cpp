@@ -0,0 +1,526 @@
+/****************************************************************************
+  PackageName  [ zx ]
+  Synopsis     [ Define class CompactZXGraph member functions ]
+  Author       [ Design Verification Lab ]
+  Copyright    [ Copyright(c) 2023 DVLab, GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#include "./zxgraph_compact.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <gsl/narrow>
+#include <stdexcept>
+#include <string>
+
+#include "./zxgraph.hpp"
+
+namespace qsyn::zx {
+
+/*****************************************************/
+/*   class CompactZXGraph conversion functions       */
+/*****************************************************/
+
+/**
+ * @brief Construct a CompactZXGraph from a ZXGraph. Vertex IDs, attributes,
+ *        the order of inputs and outputs, and the connectivity are preserved.
+ *        The vertices are indexed, and each adjacency block laid out, in the
+ *        order the graph iterates them.
+ *
+ * @param graph
+ */
+CompactZXGraph::CompactZXGraph(ZXGraph const& graph) : _next_v_id{graph._next_v_id} {
+    reserve(graph.num_vertices(), 2 * graph.num_edges());
+
+    std::unordered_map<ZXVertex*, VertexIndex> ptr_to_index;
+    ptr_to_index.reserve(graph.num_vertices());
+
+    for (auto const& v : graph.get_vertices()) {
+        ptr_to_index.emplace(v, _push_vertex(v->get_id(), v->type(), v->get_qubit(), v->phase(), v->get_row(), v->get_col()));
+    }
+    for (auto const& v : graph.get_inputs()) {
+        _vertex_table->inputs.emplace_back(ptr_to_index.at(v));
+    }
+    for (auto const& v : graph.get_outputs()) {
+        _vertex_table->outputs.emplace_back(ptr_to_index.at(v));
+    }
+
+    // lay out each adjacency block exactly once so that no relocation happens
+    auto& table = *_adjacency_table;
+    for (auto const& v : graph.get_vertices()) {
+        auto const idx        = ptr_to_index.at(v);
+        table.offsets[idx]    = table.adjacency.size();
+        table.capacities[idx] = gsl::narrow<uint32_t>(graph.num_neighbors(v));
+        for (auto const& [nb, etype] : graph.get_neighbors(v)) {
+            table.adjacency.push_back({ptr_to_index.at(nb), etype});
+        }
+        table.used[idx]    = table.capacities[idx];
+        table.degrees[idx] = table.capacities[idx];
+    }
+    _num_edges = graph.num_edges();
+}
+
+/**
+ * @brief Convert the CompactZXGraph back to a pointer-based ZXGraph. The
+ *        vertices and edges are added in the same order as the ZXGraph copy
+ *        constructor adds them, so a round trip iterates like a copy of the
+ *        original graph, and the rewrites on it visit the same matches.
+ *
+ * @return ZXGraph
+ */
+ZXGraph CompactZXGraph::to_zxgraph() const {
+    ZXGraph graph;
+    auto const& vt = *_vertex_table;
+    std::vector<ZXVertex*> index_to_ptr(vt.types.size(), nullptr);
+    std::vector<bool> is_input(vt.types.size(), false);
+    for (auto const v : vt.inputs) is_input[v] = true;
+
+    for_each_vertex([&](VertexIndex v) {
+        if (vt.types[v] == VertexType::boundary) {
+            index_to_ptr[v] = is_input[v]
+                                  ? graph.add_input(vt.ids[v], vt.qubits[v], vt.rows[v], vt.cols[v])
+                                  : graph.add_output(vt.ids[v], vt.qubits[v], vt.rows[v], vt.cols[v]);
+            return;
+        }
+        index_to_ptr[v] = graph.add_vertex(vt.ids[v], vt.types[v], vt.phases[v], vt.rows[v], vt.cols[v]);
+        index_to_ptr[v]->set_qubit(vt.qubits[v]);
+    });
+    // each edge is added from its endpoint with the smaller ID, as ZXGraph::for_each_edge visits it
+    for_each_vertex([&](VertexIndex v) {
+        for_each_neighbor(v, [&](VertexIndex nb, EdgeType et) {
+            if (vt.ids[nb] > vt.ids[v]) graph.add_edge(index_to_ptr[v], index_to_ptr[nb], et);
+        });
+    });
+    graph._next_v_id = _next_v_id;
+
+    return graph;
+}
+
+/**
+ * @brief Reserve space for vertices and adjacency entries. Each edge takes
+ *        two adjacency entries.
+ *
+ * @param num_vertices
+ * @param num_adjacency_entries
+ */
+void CompactZXGraph::reserve(size_t num_vertices, size_t num_adjacency_entries) {
+    auto& vt = _writable_vertex_table();
+    vt.ids.reserve(num_vertices);
+    vt.types.reserve(num_vertices);
+    vt.phases.reserve(num_vertices);
+    vt.qubits.reserve(num_vertices);
+    vt.rows.reserve(num_vertices);
+    vt.cols.reserve(num_vertices);
+    vt.alive.reserve(num_vertices);
+    vt.id_to_index.reserve(num_vertices);
+
+    auto& table = _writable_adjacency_table();
+    table.offsets.reserve(num_vertices);
+    table.used.reserve(num_vertices);
+    table.capacities.reserve(num_vertices);
+    table.degrees.reserve(num_vertices);
+    table.adjacency.reserve(num_adjacency_entries);
+}
+
+/*****************************************************/
+/*   class CompactZXGraph query functions            */
+/*****************************************************/
+
+std::optional<CompactZXGraph::VertexIndex> CompactZXGraph::index_of(size_t id) const {
+    auto const& id_to_index = _vertex_table->id_to_index;
+    if (auto const it = id_to_index.find(id); it != id_to_index.end()) {
+        return it->second;
+    }
+    return std::nullopt;
+}
+
+/**
+ * @brief Get the type of the edge between `v0` and `v1`, if any. The scan
+ *        runs over the adjacency block of the endpoint with fewer neighbors.
+ *
+ * @param v0
+ * @param v1
+ * @return std::optional<EdgeType>
+ */
+std::optional<EdgeType> CompactZXGraph::get_edge_type(VertexIndex v0, VertexIndex v1) const {
+    if (!is_alive(v0) || !is_alive(v1)) return std::nullopt;
+    auto const& table = *_adjacency_table;
+    if (table.degrees[v0] > table.degrees[v1]) std::swap(v0, v1);
+
+    auto const begin = table.adjacency.begin() + table.offsets[v0];
+    auto const end   = begin + table.used[v0];
+    auto const it    = std::find_if(begin, end, [v1](AdjacencyEntry const& e) { return e.neighbor == v1; });
+    if (it == end) return std::nullopt;
+    return it->etype;
+}
+
+std::vector<std::pair<CompactZXGraph::VertexIndex, EdgeType>> CompactZXGraph::get_neighbors(VertexIndex v) const {
+    std::vector<std::pair<VertexIndex, EdgeType>> neighbors;
+    neighbors.reserve(num_neighbors(v));
+    for_each_neighbor(v, [&neighbors](VertexIndex nb, EdgeType et) {
+        neighbors.emplace_back(nb, et);
+    });
+    return neighbors;
+}
+
+/*****************************************************/
+/*   class CompactZXGraph Add functions              */
+/*****************************************************/
+
+CompactZXGraph::VertexIndex CompactZXGraph::add_input(QubitIdType qubit, float row, float col, std::optional<size_t> id) {
+    if (std::ranges::any_of(get_inputs(), [&](VertexIndex i) { return get_qubit(i) == qubit; })) {
+        spdlog::warn("Input qubit {} already exists", qubit);
+        return invalid_index;
+    }
+    auto const v = add_vertex(VertexType::boundary, Phase(), row, col, id);
+    if (v == invalid_index) return invalid_index;
+    auto& vt     = _writable_vertex_table();
+    vt.qubits[v] = qubit;
+    vt.inputs.emplace_back(v);
+    return v;
+}
+
+CompactZXGraph::VertexIndex CompactZXGraph::add_output(QubitIdType qubit, float row, float col, std::optional<size_t> id) {
+    if (std::ranges::any_of(get_outputs(), [&](VertexIndex o) { return get_qubit(o) == qubit; })) {
+        spdlog::warn("Output qubit {} already exists", qubit);
+        return invalid_index;
+    }
+    auto const v = add_vertex(VertexType::boundary, Phase(), row, col, id);
+    if (v == invalid_index) return invalid_index;
+    auto& vt     = _writable_vertex_table();
+    vt.qubits[v] = qubit;
+    vt.outputs.emplace_back(v);
+    return v;
+}
+
+CompactZXGraph::VertexIndex CompactZXGraph::add_vertex(VertexType vt, Phase phase, float row, float col, std::optional<size_t> id) {
+    auto const& id_to_index = _vertex_table->id_to_index;
+    if (id.has_value() && id_to_index.contains(*id)) {
+        spdlog::warn("Vertex with id {} already exists", *id);
+        return invalid_index;
+    }
+    if (!id.has_value()) {
+        while (id_to_index.contains(_next_v_id)) ++_next_v_id;
+        id = _next_v_id++;
+    }
+    return _push_vertex(*id, vt, 0, phase, row, col);
+}
+
+/**
+ * @brief Add an edge between `vs` and `vt`. Parallel edges and self-loops are
+ *        merged or cancelled out in the same way as `ZXGraph::add_edge`.
+ *
+ * @param vs
+ * @param vt
+ * @param et
+ */
+void CompactZXGraph::add_edge(VertexIndex vs, VertexIndex vt, EdgeType et) {
+    if (vs == vt) {
+        if (get_type(vs) != VertexType::z && get_type(vs) != VertexType::x) {
+            throw std::logic_error(
+                "Cannot add an edge between a boundary vertex and itself");
+        }
+        if (et == EdgeType::hadamard) {
+            _writable_vertex_table().phases[vs] += Phase(1);
+        }
+        return;
+    }
+
+    auto const existing_etype = get_edge_type(vs, vt);
+    if (!existing_etype.has_value()) {
+        _append_neighbor(vs, vt, et);
+        _append_neighbor(vt, vs, et);
+        ++_num_edges;
+        return;
+    }
+
+    auto const is_zx = [this](VertexIndex v) {
+        return get_type(v) == VertexType::z || get_type(v) == VertexType::x;
+    };
+    if (!is_zx(vs) || !is_zx(vt)) {
+        throw std::logic_error(
+            fmt::format(
+                "Cannot add >1 between {}({}) and {}({})",
+                get_type(vs), get_id(vs),
+                get_type(vt), get_id(vt)));
+    }
+
+    auto const same_type = get_type(vs) == get_type(vt);
+    auto const to_merge  = same_type ? EdgeType::simple : EdgeType::hadamard;
+    auto const to_cancel = same_type ? EdgeType::hadamard : EdgeType::simple;
+
+    if (*existing_etype == to_merge && et == to_merge) {
+        // new edge can be merged with existing edge
+    } else if (*existing_etype == to_cancel && et == to_cancel) {
+        remove_edge(vs, vt, to_cancel);
+    } else {
+        if (*existing_etype == to_cancel) {
+            remove_edge(vs, vt, to_cancel);
+            _append_neighbor(vs, vt, to_merge);
+            _append_neighbor(vt, vs, to_merge);
+            ++_num_edges;
+        }
+        _writable_vertex_table().phases[std::min(vs, vt, [this](VertexIndex a, VertexIndex b) { return get_id(a) < get_id(b); })] += Phase(1);
+    }
+}
+
+/*****************************************************/
+/*   class CompactZXGraph Remove functions           */
+/*****************************************************/
+
+/**
+ * @brief Remove vertex `v` and its incident edges. The vertex slot is
+ *        tombstoned; its index stays reserved until the next `compact()`.
+ *
+ * @param v
+ * @return size_t the number of vertices removed
+ */
+size_t CompactZXGraph::remove_vertex(VertexIndex v) {
+    if (!is_alive(v)) return 0;
+
+    // detach before iterating so that the loop reads the table it writes to
+    auto& table = _writable_adjacency_table();
+    for_each_neighbor(v, [this, v](VertexIndex nb, EdgeType et) {
+        _erase_neighbor(nb, v, et);
+        --_num_edges;
+    });
+    table.used[v]       = 0;
+    table.capacities[v] = 0;
+    table.degrees[v]    = 0;
+
+    auto& vt    = _writable_vertex_table();
+    vt.alive[v] = 0;
+    --_num_alive;
+    vt.id_to_index.erase(vt.ids[v]);
+    std::erase(vt.inputs, v);
+    std::erase(vt.outputs, v);
+
+    _maybe_compact_adjacency();
+    return 1;
+}
+
+size_t CompactZXGraph::remove_edge(VertexIndex vs, VertexIndex vt) {
+    return remove_edge(vs, vt, EdgeType::simple) + remove_edge(vs, vt, EdgeType::hadamard);
+}
+
+size_t CompactZXGraph::remove_edge(VertexIndex vs, VertexIndex vt, EdgeType etype) {
+    if (!is_alive(vs) || !is_alive(vt)) return 0;
+    if (!is_neighbor(vs, vt, etype)) return 0;
+    auto const count = static_cast<size_t>(_erase_neighbor(vs, vt, etype)) + static_cast<size_t>(_erase_neighbor(vt, vs, etype));
+    if (count == 1) {
+        throw std::out_of_range("Graph connection error in " + std::to_string(get_id(vs)) + " and " + std::to_string(get_id(vt)));
+    }
+    _num_edges -= count / 2;
+    return count / 2;
+}
+
+size_t CompactZXGraph::remove_isolated_vertices() {
+    size_t count = 0;
+    for_each_vertex([&](VertexIndex v) {
+        if (num_neighbors(v) == 0) count += remove_vertex(v);
+    });
+    return count;
+}
+
+/**
+ * @brief Drop all tombstoned vertices and adjacency entries, renumbering the
+ *        surviving vertices densely in their current order.
+ *
+ * @return std::vector<VertexIndex> the map from old indices to new indices;
+ *         removed vertices map to `invalid_index`
+ */
+std::vector<CompactZXGraph::VertexIndex> CompactZXGraph::compact() {
+    std::vector<VertexIndex> old_to_new(num_vertex_slots(), invalid_index);
+    VertexIndex next = 0;
+    for_each_vertex([&](VertexIndex v) { old_to_new[v] = next++; });
+
+    CompactZXGraph compacted;
+    compacted.reserve(_num_alive, 2 * _num_edges);
+    for_each_vertex([&](VertexIndex v) {
+        compacted._push_vertex(get_id(v), get_type(v), get_qubit(v), get_phase(v), get_row(v), get_col(v));
+    });
+    auto& table = *compacted._adjacency_table;
+    for_each_vertex([&](VertexIndex v) {
+        auto const nv        = old_to_new[v];
+        table.offsets[nv]    = table.adjacency.size();
+        table.capacities[nv] = gsl::narrow<uint32_t>(num_neighbors(v));
+        table.used[nv]       = table.capacities[nv];
+        table.degrees[nv]    = table.capacities[nv];
+        for_each_neighbor(v, [&](VertexIndex nb, EdgeType et) {
+            table.adjacency.push_back({old_to_new[nb], et});
+        });
+    });
+    for (auto const i : get_inputs()) compacted._vertex_table->inputs.emplace_back(old_to_new[i]);
+    for (auto const o : get_outputs()) compacted._vertex_table->outputs.emplace_back(old_to_new[o]);
+    compacted._num_edges = _num_edges;
+    compacted._next_v_id = _next_v_id;
+
+    *this = std::move(compacted);
+    return old_to_new;
+}
+
+/*****************************************************/
+/*   class CompactZXGraph private functions          */
+/*****************************************************/
+
+/**
+ * @brief Get the vertex table for writing. If it is shared with a copy of
+ *        this graph, this graph first takes a private copy of it.
+ *
+ * @return VertexTable&
+ */
+CompactZXGraph::VertexTable& CompactZXGraph::_writable_vertex_table() {
+    if (_vertex_table.use_count() > 1) {
+        _vertex_table = std::make_shared<VertexTable>(*_vertex_table);
+    }
+    return *_vertex_table;
+}
+
+/**
+ * @brief Get the adjacency table for writing. If it is shared with a copy of
+ *        this graph, this graph first takes a private copy of it.
+ *
+ * @return AdjacencyTable&
+ */
+CompactZXGraph::AdjacencyTable& CompactZXGraph::_writable_adjacency_table() {
+    if (_adjacency_table.use_count() > 1) {
+        _adjacency_table = std::make_shared<AdjacencyTable>(*_adjacency_table);
+    }
+    return *_adjacency_table;
+}
+
+CompactZXGraph::VertexIndex CompactZXGraph::_push_vertex(size_t id, VertexType vt, QubitIdType qubit, Phase phase, float row, float col) {
+    auto& vertices = _writable_vertex_table();
+    if (vertices.types.size() >= invalid_index) {
+        throw std::length_error("CompactZXGraph cannot hold more than 2^32 - 1 vertex slots");
+    }
+    auto const v = gsl::narrow<VertexIndex>(vertices.types.size());
+    vertices.ids.emplace_back(id);
+    vertices.types.emplace_back(vt);
+    vertices.phases.emplace_back(phase);
+    vertices.qubits.emplace_back(qubit);
+    vertices.rows.emplace_back(row);
+    vertices.cols.emplace_back(col);
+    vertices.alive.emplace_back(1);
+    vertices.id_to_index.emplace(id, v);
+
+    auto& table = _writable_adjacency_table();
+    table.offsets.emplace_back(table.adjacency.size());
+    table.used.emplace_back(0);
+    table.capacities.emplace_back(0);
+    table.degrees.emplace_back(0);
+    ++_num_alive;
+    return v;
+}
+
+/**
+ * @brief Append `(nb, et)` to the adjacency block of `v`. A full block is
+ *        first compacted in place if it holds tombstones; otherwise it grows
+ *        geometrically, relocating to the end of the flat array if needed.
+ *
+ * @param v
+ * @param nb
+ * @param et
+ */
+void CompactZXGraph::_append_neighbor(VertexIndex v, VertexIndex nb, EdgeType et) {
+    auto& table = _writable_adjacency_table();
+    if (table.used[v] == table.capacities[v] && table.degrees[v] < table.used[v]) {
+        _compact_block(v);
+    }
+    if (table.used[v] == table.capacities[v]) {
+        auto const new_capacity = std::max<uint32_t>(4, 2 * table.capacities[v]);
+        if (table.offsets[v] + table.capacities[v] == table.adjacency.size()) {
+            // the block is the last one in the array, so it can grow in place
+            table.adjacency.resize(table.offsets[v] + new_capacity, {invalid_index, EdgeType::simple});
+        } else {
+            auto const new_offset = table.adjacency.size();
+            table.adjacency.resize(new_offset + new_capacity, {invalid_index, EdgeType::simple});
+            std::copy_n(table.adjacency.begin() + table.offsets[v], table.used[v], table.adjacency.begin() + new_offset);
+            std::fill_n(table.adjacency.begin() + table.offsets[v], table.capacities[v], AdjacencyEntry{invalid_index, EdgeType::simple});
+            table.offsets[v] = new_offset;
+        }
+        table.capacities[v] = new_capacity;
+    }
+    table.adjacency[table.offsets[v] + table.used[v]] = {nb, et};
+    ++table.used[v];
+    ++table.degrees[v];
+
+    _maybe_compact_adjacency();
+}
+
+/**
+ * @brief Tombstone the entry `(nb, et)` in the adjacency block of `v`.
+ *        Trailing tombstones are reclaimed immediately.
+ *
+ * @return true if the entry was found
+ */
+bool CompactZXGraph::_erase_neighbor(VertexIndex v, VertexIndex nb, EdgeType et) {
+    auto& table      = _writable_adjacency_table();
+    auto const begin = table.adjacency.begin() + table.offsets[v];
+    auto const end   = begin + table.used[v];
+    auto const it    = std::find_if(begin, end, [&](AdjacencyEntry const& e) {
+        return e.neighbor == nb && e.etype == et;
+    });
+    if (it == end) return false;
+
+    it->neighbor = invalid_index;
+    --table.degrees[v];
+    while (table.used[v] > 0 && table.adjacency[table.offsets[v] + table.used[v] - 1].neighbor == invalid_index) {
+        --table.used[v];
+    }
+    return true;
+}
+
+/**
+ * @brief Squeeze the tombstones out of the adjacency block of `v`, keeping
+ *        the relative order of the live entries.
+ *
+ * @param v
+ */
+void CompactZXGraph::_compact_block(VertexIndex v) {
+    auto& table        = _writable_adjacency_table();
+    auto const begin   = table.adjacency.begin() + table.offsets[v];
+    auto const new_end = std::remove_if(begin, begin + table.used[v], [](AdjacencyEntry const& e) {
+        return e.neighbor == invalid_index;
+    });
+    std::fill(new_end, begin + table.used[v], AdjacencyEntry{invalid_index, EdgeType::simple});
+    table.used[v] = gsl::narrow<uint32_t>(std::distance(begin, new_end));
+}
+
+/**
+ * @brief Rebuild the flat adjacency array with every block packed tightly.
+ *        Vertex indices are left untouched.
+ *
+ */
+void CompactZXGraph::_compact_adjacency() {
+    auto& table = _writable_adjacency_table();
+    std::vector<AdjacencyEntry> packed;
+    packed.reserve(2 * _num_edges);
+    for (VertexIndex v = 0; v < table.offsets.size(); ++v) {
+        auto const new_offset = packed.size();
+        for_each_neighbor(v, [&packed](VertexIndex nb, EdgeType et) {
+            packed.push_back({nb, et});
+        });
+        table.offsets[v]    = new_offset;
+        table.used[v]       = table.degrees[v];
+        table.capacities[v] = table.degrees[v];
+    }
+    table.adjacency = std::move(packed);
+}
+
+/**
+ * @brief Compact the adjacency array once the dead slots outnumber the live
+ *        entries. Small arrays are left alone to avoid churning.
+ *
+ */
+void CompactZXGraph::_maybe_compact_adjacency() {
+    constexpr size_t min_slots_to_compact = 1024;
+    auto const live_entries               = 2 * _num_edges;
+    auto const slots                      = num_adjacency_slots();
+    if (slots >= min_slots_to_compact && slots - live_entries > live_entries) {
+        _compact_adjacency();
+    }
+}
+
+}  // namespace qsyn::zx
@@ -0,0 +1,223 @@
+/****************************************************************************
+  PackageName  [ zx ]
+  Synopsis     [ Define class CompactZXGraph structures ]
+  Author       [ Design Verification Lab ]
+  Copyright    [ Copyright(c) 2023 DVLab, GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "./zx_def.hpp"
+#include "./zxgraph.hpp"
+#include "qsyn/qsyn_type.hpp"
+
+namespace qsyn::zx {
+
+/**
+ * @brief An index-based storage engine for ZX-diagrams.
+ *
+ *        Vertices are addressed by dense 32-bit indices. Vertex attributes are
+ *        stored as struct-of-arrays, and the adjacency of every vertex lives
+ *        in a contiguous block of one flat array. Removed vertices and edges
+ *        leave tombstones behind; the adjacency array is compacted in place
+ *        once the tombstones outnumber the live entries, and `compact()`
+ *        additionally renumbers the vertices to close the gaps.
+ *
+ *        Vertex IDs are kept alongside the indices so that conversion to and
+ *        from ZXGraph is lossless. The routines written against ZXGraph run on
+ *        a CompactZXGraph through `with_zxgraph`.
+ *
+ *        Copies are copy-on-write: the vertex table and the adjacency table
+ *        are shared between a graph and its copies until one side mutates
+ *        them. Changing an attribute only duplicates the vertex table, and
+ *        changing an edge only duplicates the adjacency table. Snapshots for
+ *        speculative rewrites therefore cost O(1) until they diverge.
+ */
+class CompactZXGraph {
+public:
+    using VertexIndex = uint32_t;
+
+    static constexpr VertexIndex invalid_index = std::numeric_limits<VertexIndex>::max();
+
+    struct AdjacencyEntry {
+        VertexIndex neighbor;  // invalid_index marks a tombstone
+        EdgeType etype;
+    };
+
+    CompactZXGraph() = default;
+    explicit CompactZXGraph(ZXGraph const& graph);
+
+    ZXGraph to_zxgraph() const;
+
+    void reserve(size_t num_vertices, size_t num_adjacency_entries);
+
+    // Getter and Setter
+
+    size_t num_vertices() const { return _num_alive; }
+    size_t num_edges() const { return _num_edges; }
+    size_t num_inputs() const { return _vertex_table->inputs.size(); }
+    size_t num_outputs() const { return _vertex_table->outputs.size(); }
+    size_t num_vertex_slots() const { return _vertex_table->types.size(); }
+    size_t num_adjacency_slots() const { return _adjacency_table->adjacency.size(); }
+    size_t num_neighbors(VertexIndex v) const { return _adjacency_table->degrees[v]; }
+
+    bool is_alive(VertexIndex v) const { return v < _vertex_table->types.size() && _vertex_table->alive[v]; }
+    std::optional<VertexIndex> index_of(size_t id) const;
+
+    size_t get_id(VertexIndex v) const { return _vertex_table->ids[v]; }
+    VertexType get_type(VertexIndex v) const { return _vertex_table->types[v]; }
+    Phase const& get_phase(VertexIndex v) const { return _vertex_table->phases[v]; }
+    QubitIdType get_qubit(VertexIndex v) const { return _vertex_table->qubits[v]; }
+    float get_row(VertexIndex v) const { return _vertex_table->rows[v]; }
+    float get_col(VertexIndex v) const { return _vertex_table->cols[v]; }
+
+    void set_type(VertexIndex v, VertexType vt) { _writable_vertex_table().types[v] = vt; }
+    void set_phase(VertexIndex v, Phase const& p) { _writable_vertex_table().phases[v] = p; }
+    void set_qubit(VertexIndex v, QubitIdType q) { _writable_vertex_table().qubits[v] = q; }
+    void set_row(VertexIndex v, float r) { _writable_vertex_table().rows[v] = r; }
+    void set_col(VertexIndex v, float c) { _writable_vertex_table().cols[v] = c; }
+
+    std::vector<VertexIndex> const& get_inputs() const { return _vertex_table->inputs; }
+    std::vector<VertexIndex> const& get_outputs() const { return _vertex_table->outputs; }
+
+    bool is_neighbor(VertexIndex v0, VertexIndex v1) const { return get_edge_type(v0, v1).has_value(); }
+    bool is_neighbor(VertexIndex v0, VertexIndex v1, EdgeType et) const { return get_edge_type(v0, v1) == et; }
+    std::optional<EdgeType> get_edge_type(VertexIndex v0, VertexIndex v1) const;
+
+    std::vector<std::pair<VertexIndex, EdgeType>> get_neighbors(VertexIndex v) const;
+
+    // Vertex addition and removal
+
+    VertexIndex add_input(QubitIdType qubit, float row, float col, std::optional<size_t> id = std::nullopt);
+    VertexIndex add_output(QubitIdType qubit, float row, float col, std::optional<size_t> id = std::nullopt);
+    VertexIndex add_vertex(VertexType vt, Phase phase = Phase(), float row = 0.f, float col = 0.f, std::optional<size_t> id = std::nullopt);
+
+    void add_edge(VertexIndex vs, VertexIndex vt, EdgeType et);
+
+    size_t remove_vertex(VertexIndex v);
+    size_t remove_edge(VertexIndex vs, VertexIndex vt);
+    size_t remove_edge(VertexIndex vs, VertexIndex vt, EdgeType etype);
+    size_t remove_isolated_vertices();
+
+    std::vector<VertexIndex> compact();
+
+    // Copy-on-write sharing
+
+    bool shares_vertex_table_with(CompactZXGraph const& other) const { return _vertex_table == other._vertex_table; }
+    bool shares_adjacency_table_with(CompactZXGraph const& other) const { return _adjacency_table == other._adjacency_table; }
+
+    // Traverse
+
+    template <typename F>
+    void for_each_vertex(F lambda) const {
+        auto const& alive = _vertex_table->alive;
+        for (VertexIndex v = 0; v < alive.size(); ++v) {
+            if (alive[v]) lambda(v);
+        }
+    }
+
+    template <typename F>
+    void for_each_neighbor(VertexIndex v, F lambda) const {
+        auto const& table = *_adjacency_table;
+        auto const begin  = table.adjacency.begin() + table.offsets[v];
+        auto const end    = begin + table.used[v];
+        for (auto it = begin; it != end; ++it) {
+            if (it->neighbor != invalid_index) lambda(it->neighbor, it->etype);
+        }
+    }
+
+    template <typename F>
+    void for_each_edge(F lambda) const {
+        for_each_vertex([&](VertexIndex v) {
+            for_each_neighbor(v, [&](VertexIndex nb, EdgeType et) {
+                if (nb > v) lambda(v, nb, et);
+            });
+        });
+    }
+
+private:
+    // struct-of-arrays vertex attributes
+    struct VertexTable {
+        std::vector<size_t> ids;
+        std::vector<VertexType> types;
+        std::vector<Phase> phases;
+        std::vector<QubitIdType> qubits;
+        std::vector<float> rows;
+        std::vector<float> cols;
+        std::vector<uint8_t> alive;
+
+        std::vector<VertexIndex> inputs;
+        std::vector<VertexIndex> outputs;
+        std::unordered_map<size_t, VertexIndex> id_to_index;
+    };
+
+    // adjacency blocks: vertex v owns adjacency[offsets[v], offsets[v] + capacities[v])
+    // of which the first used[v] entries are occupied (live or tombstoned)
+    struct AdjacencyTable {
+        std::vector<AdjacencyEntry> adjacency;
+        std::vector<size_t> offsets;
+        std::vector<uint32_t> used;
+        std::vector<uint32_t> capacities;
+        std::vector<uint32_t> degrees;
+    };
+
+    // shared with copies of this graph; duplicated by the first write after a copy
+    std::shared_ptr<VertexTable> _vertex_table       = std::make_shared<VertexTable>();
+    std::shared_ptr<AdjacencyTable> _adjacency_table = std::make_shared<AdjacencyTable>();
+
+    size_t _num_alive = 0;
+    size_t _num_edges = 0;
+    size_t _next_v_id = 0;
+
+    VertexTable& _writable_vertex_table();
+    AdjacencyTable& _writable_adjacency_table();
+
+    VertexIndex _push_vertex(size_t id, VertexType vt, QubitIdType qubit, Phase phase, float row, float col);
+    void _append_neighbor(VertexIndex v, VertexIndex nb, EdgeType et);
+    bool _erase_neighbor(VertexIndex v, VertexIndex nb, EdgeType et);
+    void _compact_block(VertexIndex v);
+    void _compact_adjacency();
+    void _maybe_compact_adjacency();
+};
+
+/**
+ * @brief Run a ZXGraph routine, such as `simplify::full_reduce` or an
+ *        extraction, on a compact graph. The graph is converted to a ZXGraph
+ *        for the routine and back afterwards, so the routine runs unchanged.
+ *
+ * @param graph
+ * @param routine called with a `ZXGraph&`
+ * @return the result of the routine, if any
+ */
+template <typename F>
+auto with_zxgraph(CompactZXGraph& graph, F&& routine) {
+    auto zxgraph = graph.to_zxgraph();
+    if constexpr (std::is_void_v<std::invoke_result_t<F, ZXGraph&>>) {
+        std::invoke(std::forward<F>(routine), zxgraph);
+        graph = CompactZXGraph{zxgraph};
+    } else {
+        auto result = std::invoke(std::forward<F>(routine), zxgraph);
+        graph       = CompactZXGraph{zxgraph};
+        return result;
+    }
+}
+
+// the same for routines that only read the graph, such as `to_tensor`
+template <typename F>
+auto with_zxgraph(CompactZXGraph const& graph, F&& routine) {
+    auto const zxgraph = graph.to_zxgraph();
+    return std::invoke(std::forward<F>(routine), zxgraph);
+}
+
+}  // namespace qsyn::zx
@@ -0,0 +1,117 @@
+#include "./pipelines.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <memory>
+
+#include "convert/qcir_to_tableau.hpp"
+#include "convert/qcir_to_zxgraph.hpp"
+#include "convert/tableau_to_qcir.hpp"
+#include "device/device.hpp"
+#include "duostra/duostra.hpp"
+#include "extractor/extract.hpp"
+#include "qcir/optimizer/optimizer.hpp"
+#include "qcir/qcir.hpp"
+#include "tableau/stabilizer_tableau.hpp"
+#include "tableau/tableau_optimization.hpp"
+#include "zx/simplifier/simplify.hpp"
+#include "zx/zxgraph.hpp"
+
+namespace qsyn::bench {
+
+namespace {
+
+// the same defaults as `extract config` and `duostra config`
+extractor::ExtractorConfig const extractor_config = extractor::default_extractor_config;
+
+duostra::DuostraConfig const duostra_config{
+    .scheduler_type                  = duostra::SchedulerType::search,
+    .router_type                     = duostra::RouterType::duostra,
+    .placer_type                     = duostra::PlacerType::dfs,
+    .tie_breaking_strategy           = duostra::MinMaxOptionType::min,
+    .num_candidates                  = SIZE_MAX,
+    .apsp_coeff                      = 1,
+    .available_time_strategy         = duostra::MinMaxOptionType::max,
+    .cost_selection_strategy         = duostra::MinMaxOptionType::min,
+    .search_depth                    = 4,
+    .never_cache                     = true,
+    .execute_single_qubit_gates_asap = false,
+};
+
+std::optional<qcir::QCir> basic_optimize(qcir::QCir const& qcir) {
+    qcir::Optimizer optimizer;
+    return optimizer.basic_optimization(qcir, {.doSwap = true, .maxIter = 1000, .printStatistics = false});
+}
+
+// qcir → zx → full_reduce → extract → optimize
+std::optional<qcir::QCir> zx_pipeline(qcir::QCir const& input) {
+    auto graph = to_zxgraph(input);
+    if (!graph) return std::nullopt;
+    zx::simplify::full_reduce(*graph);
+
+    extractor::Extractor extractor{&*graph, extractor_config, nullptr, false};
+    auto const extracted = std::unique_ptr<qcir::QCir>{extractor.extract()};
+    if (extracted == nullptr) return std::nullopt;
+
+    return basic_optimize(*extracted);
+}
+
+// qcir → tableau → full optimization → qcir
+std::optional<qcir::QCir> tableau_pipeline(qcir::QCir const& input) {
+    auto tableau = experimental::to_tableau(input);
+    if (!tableau) return std::nullopt;
+    experimental::full_optimize(*tableau);
+    return experimental::to_qcir(*tableau, experimental::HOptSynthesisStrategy{}, experimental::NaivePauliRotationsSynthesisStrategy{});
+}
+
+// qcir → duostra mapping onto the device
+std::optional<qcir::QCir> duostra_pipeline(qcir::QCir const& input, std::filesystem::path const& device_file) {
+    device::Device device;
+    if (!device.read_device(device_file.string())) {
+        spdlog::error("cannot read the device \"{}\"!!", device_file.string());
+        return std::nullopt;
+    }
+
+    auto logical = input;
+    duostra::Duostra duostra{&logical, std::move(device), duostra_config, {.verify_result = false, .silent = true, .use_tqdm = false}};
+    if (!duostra.map() || duostra.get_physical_circuit() == nullptr) return std::nullopt;
+    return std::move(*duostra.get_physical_circuit());
+}
+
+}  // namespace
+
+CircuitMetrics measure(qcir::QCir const& qcir) {
+    auto const stats = qcir::get_gate_statistics(qcir);
+    auto const count = [&stats](std::string const& key) -> size_t {
+        return stats.contains(key) ? stats.at(key) : 0;
+    };
+    return {
+        .num_qubits = qcir.get_num_qubits(),
+        .num_gates  = qcir.get_num_gates(),
+        .t_count    = count("t-family"),
+        .two_qubit  = count("2-qubit"),
+        .depth      = qcir.calculate_depth(),
+        .swaps      = count("swap"),
+    };
+}
+
+std::vector<std::string> const& pipeline_names() {
+    static std::vector<std::string> const names{"zx", "tableau", "duostra", "optimize"};
+    return names;
+}
+
+bool is_pipeline(std::string const& name) {
+    return std::ranges::find(pipeline_names(), name) != pipeline_names().end();
+}
+
+std::optional<qcir::QCir> run_pipeline(std::string const& name, qcir::QCir const& input, PipelineOptions const& options) {
+    if (name == "zx") return zx_pipeline(input);
+    if (name == "tableau") return tableau_pipeline(input);
+    if (name == "duostra") return duostra_pipeline(input, options.device);
+    if (name == "optimize") return basic_optimize(input);
+    spdlog::error("unknown pipeline \"{}\"!!", name);
+    return std::nullopt;
+}
+
+}  // namespace qsyn::bench
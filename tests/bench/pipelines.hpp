@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace qsyn::qcir {
+class QCir;
+}
+
+namespace qsyn::bench {
+
+struct CircuitMetrics {
+    size_t num_qubits = 0;
+    size_t num_gates  = 0;
+    size_t t_count    = 0;
+    size_t two_qubit  = 0;
+    size_t depth      = 0;
+    size_t swaps      = 0;
+};
+
+CircuitMetrics measure(qcir::QCir const& qcir);
+
+struct PipelineOptions {
+    std::filesystem::path device;  // the device to map to in the duostra pipeline
+};
+
+std::vector<std::string> const& pipeline_names();
+bool is_pipeline(std::string const& name);
+
+/**
+ * @brief Run the pipeline `name` on `input`.
+ *
+ * @return the resulting circuit, or std::nullopt if a stage failed
+ */
+std::optional<qcir::QCir> run_pipeline(std::string const& name, qcir::QCir const& input, PipelineOptions const& options);
+
+}  // namespace qsyn::bench
@@ -0,0 +1,341 @@
+// qsyn-bench: runs end-to-end pipelines over the circuits in benchmark/ and
+// compares the results against a stored baseline.
+//
+// Each (pipeline, file) pair runs in a forked child, so that the CPU time and
+// the peak RSS reported by wait4 belong to that run alone, and so that a
+// crash or a timeout only fails that run.
+
+#include <spdlog/spdlog.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "./pipelines.hpp"
+#include "qcir/qcir.hpp"
+#include "qcir/qcir_io.hpp"
+
+bool stop_requested() { return false; }
+
+namespace {
+
+using namespace qsyn;
+namespace fs = std::filesystem;
+
+struct Options {
+    std::vector<std::string> pipelines;
+    std::vector<fs::path> inputs;
+    bench::PipelineOptions pipeline_options{.device = "benchmark/topology/guadalupe_16.layout"};
+    std::optional<fs::path> csv_file;
+    std::optional<fs::path> json_file;
+    std::optional<fs::path> baseline_file;
+    double time_tolerance = 0.25;  // allowed relative slowdown against the baseline
+    double min_time       = 0.1;   // runs faster than this in the baseline are too noisy to compare
+    unsigned timeout      = 600;   // seconds per run
+};
+
+// the quality metrics, in the order they are reported
+std::vector<std::string> const quality_keys{"num_gates", "t_count", "two_qubit", "depth", "swaps"};
+
+void print_usage(char const* argv0) {
+    fmt::println("Usage: {} [options] <file or directory>...", argv0);
+    fmt::println("");
+    fmt::println("Runs the pipelines on every .qasm and .qc file under the given paths.");
+    fmt::println("");
+    fmt::println("  -p, --pipeline <name>     pipeline to run; may be repeated (default: zx)");
+    fmt::println("                            zx:       read -> zx -> full_reduce -> extract -> optimize");
+    fmt::println("                            tableau:  read -> tableau -> full optimization -> qcir");
+    fmt::println("                            duostra:  read -> duostra mapping");
+    fmt::println("                            optimize: read -> basic optimization");
+    fmt::println("  --device <file>           device for the duostra pipeline (default: benchmark/topology/guadalupe_16.layout)");
+    fmt::println("  --csv <file>              write the results as CSV");
+    fmt::println("  --json <file>             write the results as JSON; this is the baseline format");
+    fmt::println("  --baseline <file>         compare against a JSON baseline and exit with 1 on regressions");
+    fmt::println("  --time-tolerance <ratio>  allowed wall-time slowdown against the baseline (default: 0.25)");
+    fmt::println("  --timeout <seconds>       time limit per run (default: 600)");
+}
+
+std::optional<Options> parse_options(int argc, char** argv) {
+    Options options;
+    std::vector<std::string> const args(argv + 1, argv + argc);
+    for (size_t i = 0; i < args.size(); ++i) {
+        auto const& arg       = args[i];
+        auto const next_value = [&]() -> std::optional<std::string> {
+            if (i + 1 >= args.size()) {
+                spdlog::error("missing value for {}!!", arg);
+                return std::nullopt;
+            }
+            return args[++i];
+        };
+
+        if (arg == "-h" || arg == "--help") {
+            print_usage(argv[0]);
+            std::exit(0);
+        }
+        if (arg == "-p" || arg == "--pipeline" || arg == "--device" || arg == "--csv" || arg == "--json" ||
+            arg == "--baseline" || arg == "--time-tolerance" || arg == "--timeout") {
+            auto const value = next_value();
+            if (!value) return std::nullopt;
+            try {
+                if (arg == "-p" || arg == "--pipeline") {
+                    if (!bench::is_pipeline(*value)) {
+                        spdlog::error("unknown pipeline \"{}\"!!", *value);
+                        return std::nullopt;
+                    }
+                    options.pipelines.push_back(*value);
+                } else if (arg == "--device") {
+                    options.pipeline_options.device = *value;
+                } else if (arg == "--csv") {
+                    options.csv_file = *value;
+                } else if (arg == "--json") {
+                    options.json_file = *value;
+                } else if (arg == "--baseline") {
+                    options.baseline_file = *value;
+                } else if (arg == "--time-tolerance") {
+                    options.time_tolerance = std::stod(*value);
+                } else {
+                    options.timeout = static_cast<unsigned>(std::stoul(*value));
+                }
+            } catch (std::exception const&) {
+                spdlog::error("invalid value \"{}\" for {}!!", *value, arg);
+                return std::nullopt;
+            }
+            continue;
+        }
+        if (arg.starts_with("-")) {
+            spdlog::error("unknown option {}!!", arg);
+            return std::nullopt;
+        }
+        options.inputs.emplace_back(arg);
+    }
+
+    if (options.inputs.empty()) {
+        print_usage(argv[0]);
+        return std::nullopt;
+    }
+    if (options.pipelines.empty()) options.pipelines.emplace_back("zx");
+    return options;
+}
+
+// the circuit files under the inputs, in a fixed order
+std::vector<fs::path> collect_files(std::vector<fs::path> const& inputs) {
+    auto const is_circuit = [](fs::path const& p) { return p.extension() == ".qasm" || p.extension() == ".qc"; };
+    std::vector<fs::path> files;
+    for (auto const& input : inputs) {
+        if (fs::is_regular_file(input)) {
+            files.push_back(input);
+        } else if (fs::is_directory(input)) {
+            std::vector<fs::path> dir_files;
+            for (auto const& entry : fs::recursive_directory_iterator(input)) {
+                if (entry.is_regular_file() && is_circuit(entry.path())) dir_files.push_back(entry.path());
+            }
+            std::ranges::sort(dir_files);
+            files.insert(files.end(), dir_files.begin(), dir_files.end());
+        } else {
+            spdlog::warn("{} is not a file or directory; skipping", input.string());
+        }
+    }
+    return files;
+}
+
+/**
+ * @brief Run the pipeline in the child process and write the metrics of the
+ *        result to `fd` as JSON.
+ *
+ * @return the exit code of the child
+ */
+int run_in_child(std::string const& pipeline, fs::path const& file, bench::PipelineOptions const& options, int fd) {
+    auto const input = qcir::from_file(file);
+    if (!input) return 1;
+
+    auto const result = bench::run_pipeline(pipeline, *input, options);
+    if (!result) return 1;
+
+    auto const metrics = bench::measure(*result);
+    auto const output  = nlohmann::json{
+        {"num_qubits", metrics.num_qubits},
+        {"num_gates", metrics.num_gates},
+        {"t_count", metrics.t_count},
+        {"two_qubit", metrics.two_qubit},
+        {"depth", metrics.depth},
+        {"swaps", metrics.swaps},
+    }.dump();
+    return write(fd, output.data(), output.size()) == static_cast<ssize_t>(output.size()) ? 0 : 1;
+}
+
+nlohmann::json run(std::string const& pipeline, fs::path const& file, Options const& options) {
+    auto record = nlohmann::json{{"pipeline", pipeline}, {"file", file.string()}};
+
+    int fds[2];
+    if (pipe(fds) != 0) {
+        record["status"] = "error";
+        return record;
+    }
+
+    auto const start = std::chrono::steady_clock::now();
+    auto const pid   = fork();
+    if (pid == -1) {
+        close(fds[0]);
+        close(fds[1]);
+        record["status"] = "error";
+        return record;
+    }
+    if (pid == 0) {
+        close(fds[0]);
+        alarm(options.timeout);
+        _exit(run_in_child(pipeline, file, options.pipeline_options, fds[1]));
+    }
+    close(fds[1]);
+
+    std::string output;
+    char buffer[4096];
+    for (ssize_t n = 0; (n = read(fds[0], buffer, sizeof buffer)) > 0;) output.append(buffer, n);
+    close(fds[0]);
+
+    int status = 0;
+    rusage usage{};
+    wait4(pid, &status, 0, &usage);
+    auto const wall_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    auto const seconds = [](timeval const& tv) { return static_cast<double>(tv.tv_sec) + static_cast<double>(tv.tv_usec) / 1e6; };
+    record["wall_s"] = wall_time;
+    record["cpu_s"]  = seconds(usage.ru_utime) + seconds(usage.ru_stime);
+#ifdef __APPLE__
+    // macOS reports memory usage in bytes
+    record["peak_rss_kib"] = usage.ru_maxrss / 1024;  // NOLINT(cppcoreguidelines-pro-type-union-access) : conform to POSIX
+#else
+    // Linux reports memory usage in kibibytes
+    record["peak_rss_kib"] = usage.ru_maxrss;  // NOLINT(cppcoreguidelines-pro-type-union-access) : conform to POSIX
+#endif
+
+    if (WIFSIGNALED(status)) {
+        record["status"] = WTERMSIG(status) == SIGALRM ? "timeout" : "crashed";
+    } else if (WEXITSTATUS(status) != 0 || output.empty()) {
+        record["status"] = "failed";
+    } else {
+        record["status"] = "ok";
+        record.update(nlohmann::json::parse(output));
+    }
+    return record;
+}
+
+void write_csv(fs::path const& path, std::vector<nlohmann::json> const& records) {
+    std::ofstream csv{path};
+    csv << "pipeline,file,status,wall_s,cpu_s,peak_rss_kib,num_qubits";
+    for (auto const& key : quality_keys) csv << ',' << key;
+    csv << '\n';
+    for (auto const& record : records) {
+        csv << record["pipeline"].get<std::string>() << ',' << record["file"].get<std::string>() << ','
+            << record["status"].get<std::string>() << ',' << record.value("wall_s", 0.0) << ','
+            << record.value("cpu_s", 0.0) << ',' << record.value("peak_rss_kib", 0L) << ','
+            << record.value("num_qubits", size_t{0});
+        for (auto const& key : quality_keys) csv << ',' << record.value(key, size_t{0});
+        csv << '\n';
+    }
+}
+
+/**
+ * @brief Compare the records against the baseline. A run regresses if it no
+ *        longer succeeds, if any quality metric got worse, or if it got slower
+ *        than the tolerance allows.
+ *
+ * @return the number of regressions
+ */
+size_t compare_with_baseline(std::vector<nlohmann::json> const& records, nlohmann::json const& baseline, Options const& options) {
+    std::map<std::pair<std::string, std::string>, nlohmann::json> expected;
+    for (auto const& record : baseline) {
+        expected.emplace(std::pair{record["pipeline"].get<std::string>(), record["file"].get<std::string>()}, record);
+    }
+
+    size_t num_regressions = 0;
+    auto const report      = [&](nlohmann::json const& record, std::string const& what) {
+        spdlog::error("{} on {}: {}", record["pipeline"].get<std::string>(), record["file"].get<std::string>(), what);
+        ++num_regressions;
+    };
+
+    for (auto const& record : records) {
+        auto const it = expected.find({record["pipeline"].get<std::string>(), record["file"].get<std::string>()});
+        if (it == expected.end()) continue;
+        auto const& base = it->second;
+
+        // a baseline that did not finish has no metrics to compare against
+        if (base["status"] != "ok") {
+            if (record["status"] == "ok") {
+                fmt::println("{} on {}: fixed (baseline: {})", record["pipeline"].get<std::string>(), record["file"].get<std::string>(), base["status"].get<std::string>());
+            }
+            continue;
+        }
+        if (record["status"] != "ok") {
+            report(record, fmt::format("status {} (baseline: ok)", record["status"].get<std::string>()));
+            continue;
+        }
+
+        for (auto const& key : quality_keys) {
+            if (record.value(key, size_t{0}) > base.value(key, size_t{0})) {
+                report(record, fmt::format("{} {} (baseline: {})", key, record.value(key, size_t{0}), base.value(key, size_t{0})));
+            }
+        }
+        auto const base_time = base.value("wall_s", 0.0);
+        if (base_time >= options.min_time && record.value("wall_s", 0.0) > base_time * (1 + options.time_tolerance)) {
+            report(record, fmt::format("wall time {:.3f}s (baseline: {:.3f}s)", record.value("wall_s", 0.0), base_time));
+        }
+    }
+    return num_regressions;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    auto const options = parse_options(argc, argv);
+    if (!options) return 2;
+
+    // the pipelines are chatty at the info level
+    spdlog::set_level(spdlog::level::warn);
+
+    auto const files = collect_files(options->inputs);
+    std::vector<nlohmann::json> records;
+    for (auto const& pipeline : options->pipelines) {
+        for (auto const& file : files) {
+            auto record = run(pipeline, file, *options);
+            fmt::println("{:<10} {:<50} {:<8} {:>9.3f}s {:>9} KiB  T {:>6}  2Q {:>6}  depth {:>6}  swaps {:>5}",
+                         pipeline, file.string(), record["status"].get<std::string>(),
+                         record.value("wall_s", 0.0), record.value("peak_rss_kib", 0L),
+                         record.value("t_count", size_t{0}), record.value("two_qubit", size_t{0}),
+                         record.value("depth", size_t{0}), record.value("swaps", size_t{0}));
+            std::fflush(stdout);
+            records.push_back(std::move(record));
+        }
+    }
+
+    if (options->csv_file) write_csv(*options->csv_file, records);
+    if (options->json_file) std::ofstream{*options->json_file} << nlohmann::json(records).dump(2) << '\n';
+
+    if (options->baseline_file) {
+        std::ifstream baseline_file{*options->baseline_file};
+        if (!baseline_file.is_open()) {
+            spdlog::error("cannot open the baseline \"{}\"!!", options->baseline_file->string());
+            return 2;
+        }
+        auto const num_regressions = compare_with_baseline(records, nlohmann::json::parse(baseline_file), *options);
+        if (num_regressions > 0) {
+            spdlog::error("{} regression(s) against {}", num_regressions, options->baseline_file->string());
+            return 1;
+        }
+        fmt::println("no regressions against {}", options->baseline_file->string());
+    }
+
+    return 0;
+}
@@ -0,0 +1,113 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <optional>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "util/boolean_matrix.hpp"
+
+namespace {
+
+// a biadjacency matrix of a wide extraction frontier
+dvlab::BooleanMatrix random_matrix(size_t size) {
+    std::mt19937 rng{42};
+    std::bernoulli_distribution coin{0.5};
+    auto matrix = dvlab::BooleanMatrix(size);
+    for (size_t i = 0; i < size; ++i) {
+        for (size_t j = 0; j < size; ++j) {
+            matrix[i][j] = coin(rng);
+        }
+    }
+    return matrix;
+}
+
+// the CZ reduction loop of the extractor: repeatedly clears the common
+// neighbors of the two most overlapping rows of a symmetric matrix
+size_t clear_overlaps(dvlab::BooleanMatrix matrix, bool incremental) {
+    auto const naive_max_overlap_pair = [&matrix]() -> std::optional<std::pair<size_t, size_t>> {
+        size_t best = 0;
+        std::optional<std::pair<size_t, size_t>> ret;
+        for (size_t i = 0; i < matrix.num_rows(); ++i) {
+            for (size_t j = i + 1; j < matrix.num_rows(); ++j) {
+                if (auto const overlap = (matrix[i] * matrix[j]).sum(); overlap > best) {
+                    best = overlap;
+                    ret  = std::make_pair(i, j);
+                }
+            }
+        }
+        return ret;
+    };
+
+    auto overlaps   = dvlab::RowOverlaps(incremental ? matrix : dvlab::BooleanMatrix{});
+    size_t n_rounds = 0;
+    while (true) {
+        auto const best_pair = incremental ? overlaps.max_overlap_pair() : naive_max_overlap_pair();
+        if (!best_pair.has_value()) break;
+        auto const [i, j] = *best_pair;
+        auto changed      = std::vector<size_t>{i, j};
+        for (size_t k = 0; k < matrix.num_cols(); ++k) {
+            if (!(matrix[i][k] && matrix[j][k])) continue;
+            matrix[i][k] = matrix[j][k] = matrix[k][i] = matrix[k][j] = 0;
+            changed.emplace_back(k);
+        }
+        if (changed.size() <= 4) break;
+        if (incremental) overlaps.update_rows(matrix, changed);
+        ++n_rounds;
+    }
+    return n_rounds;
+}
+
+void run_benchmarks(size_t size) {
+    auto const matrix = random_matrix(size);
+
+    BENCHMARK("gaussian_elimination_skip") {
+        auto copy = matrix;
+        return copy.gaussian_elimination_skip(6, true, true);
+    };
+
+    BENCHMARK("gaussian_elimination_m4ri") {
+        auto copy = matrix;
+        return copy.gaussian_elimination_m4ri(6, true, true);
+    };
+
+    BENCHMARK("matrix_rank") {
+        return matrix.matrix_rank();
+    };
+
+    // the inner loop of greedy reduction
+    BENCHMARK("sum of pairwise row additions") {
+        size_t total = 0;
+        for (size_t i = 0; i < matrix.num_rows(); ++i) {
+            for (size_t j = i + 1; j < matrix.num_rows(); ++j) {
+                total += (matrix[i] + matrix[j]).sum();
+            }
+        }
+        return total;
+    };
+
+    auto symmetric = matrix;
+    for (size_t i = 0; i < size; ++i) {
+        symmetric[i][i] = 0;
+        for (size_t j = 0; j < i; ++j) symmetric[i][j] = std::as_const(symmetric)[j][i];
+    }
+
+    BENCHMARK("CZ reduction, rescanning all row pairs") {
+        return clear_overlaps(symmetric, false);
+    };
+
+    BENCHMARK("CZ reduction, RowOverlaps") {
+        return clear_overlaps(symmetric, true);
+    };
+}
+
+}  // namespace
+
+TEST_CASE("BooleanMatrix 128x128", "[benchmark][boolean_matrix]") {
+    run_benchmarks(128);
+}
+
+TEST_CASE("BooleanMatrix 512x512", "[benchmark][boolean_matrix]") {
+    run_benchmarks(512);
+}
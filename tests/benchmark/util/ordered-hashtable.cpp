@@ -0,0 +1,71 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "util/flat_ordered_hashset.hpp"
+#include "util/ordered_hashset.hpp"
+
+namespace {
+
+constexpr size_t num_keys = 100'000;
+
+std::vector<size_t> shuffled_keys() {
+    std::vector<size_t> keys(num_keys);
+    std::iota(keys.begin(), keys.end(), 0);
+    std::ranges::shuffle(keys, std::mt19937{42});
+    return keys;
+}
+
+template <typename Set>
+Set filled_set(std::vector<size_t> const& keys) {
+    Set set;
+    for (auto k : keys) set.emplace(k);
+    return set;
+}
+
+template <typename Set>
+void run_benchmarks() {
+    auto const keys = shuffled_keys();
+
+    BENCHMARK("insert") {
+        return filled_set<Set>(keys).size();
+    };
+
+    BENCHMARK_ADVANCED("erase half")(Catch::Benchmark::Chronometer meter) {
+        std::vector<Set> sets(meter.runs(), filled_set<Set>(keys));
+        meter.measure([&](int i) {
+            for (size_t j = 0; j < keys.size(); j += 2) sets[i].erase(keys[j]);
+            return sets[i].size();
+        });
+    };
+
+    auto const set = filled_set<Set>(keys);
+
+    BENCHMARK("lookup hit and miss") {
+        size_t found = 0;
+        for (auto k : keys) found += set.contains(k) + set.contains(k + num_keys);
+        return found;
+    };
+
+    auto sparse = filled_set<Set>(keys);
+    for (size_t j = 0; j < keys.size(); j += 3) sparse.erase(keys[j]);
+
+    BENCHMARK("iterate after erasure") {
+        size_t sum = 0;
+        for (auto k : sparse) sum += k;
+        return sum;
+    };
+}
+
+}  // namespace
+
+TEST_CASE("ordered_hashset", "[benchmark][ordered_hashtable]") {
+    run_benchmarks<dvlab::utils::ordered_hashset<size_t>>();
+}
+
+TEST_CASE("flat_ordered_hashset", "[benchmark][ordered_hashtable]") {
+    run_benchmarks<dvlab::utils::flat_ordered_hashset<size_t>>();
+}
@@ -0,0 +1,101 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "convert/qcir_to_zxgraph.hpp"
+#include "qcir/qcir_io.hpp"
+#include "zx/simplifier/simplify.hpp"
+#include "zx/zx_def.hpp"
+#include "zx/zxgraph.hpp"
+#include "zx/zxgraph_compact.hpp"
+
+using namespace qsyn::zx;
+
+namespace {
+
+ZXGraph benchmark_graph(std::filesystem::path const& relative_path) {
+    auto const qcir = qsyn::qcir::from_qasm(std::filesystem::path{QSYN_SOURCE_DIR} / "benchmark" / relative_path);
+    REQUIRE(qcir.has_value());
+    auto graph = qsyn::to_zxgraph(*qcir);
+    REQUIRE(graph.has_value());
+    return std::move(*graph);
+}
+
+// the same workloads on both backends: copying the graph, reading every
+// adjacency, rewriting every phase, and a full_reduce, which runs on a
+// CompactZXGraph through the ZXGraph adapter
+void run_backend_benchmarks(std::filesystem::path const& relative_path) {
+    auto const graph         = benchmark_graph(relative_path);
+    auto const compact_graph = CompactZXGraph{graph};
+
+    BENCHMARK("ZXGraph: copy") {
+        auto g = graph;
+        return g.num_vertices();
+    };
+    BENCHMARK("CompactZXGraph: copy") {
+        auto g = compact_graph;
+        return g.num_vertices();
+    };
+
+    BENCHMARK("ZXGraph: visit every neighbor") {
+        size_t num_hadamard = 0;
+        for (auto* v : graph.get_vertices()) {
+            for (auto const& [nb, etype] : graph.get_neighbors(v)) {
+                num_hadamard += etype == EdgeType::hadamard ? 1 : 0;
+            }
+        }
+        return num_hadamard;
+    };
+    BENCHMARK("CompactZXGraph: visit every neighbor") {
+        size_t num_hadamard = 0;
+        compact_graph.for_each_vertex([&](CompactZXGraph::VertexIndex v) {
+            compact_graph.for_each_neighbor(v, [&](CompactZXGraph::VertexIndex, EdgeType etype) {
+                num_hadamard += etype == EdgeType::hadamard ? 1 : 0;
+            });
+        });
+        return num_hadamard;
+    };
+
+    BENCHMARK_ADVANCED("ZXGraph: negate every phase")(Catch::Benchmark::Chronometer meter) {
+        auto g = graph;
+        meter.measure([&] {
+            for (auto* v : g.get_vertices()) g.set_phase(v, -v->phase());
+            return g.num_vertices();
+        });
+    };
+    BENCHMARK_ADVANCED("CompactZXGraph: negate every phase")(Catch::Benchmark::Chronometer meter) {
+        auto g = compact_graph;
+        meter.measure([&] {
+            g.for_each_vertex([&g](CompactZXGraph::VertexIndex v) { g.set_phase(v, -g.get_phase(v)); });
+            return g.num_vertices();
+        });
+    };
+
+    BENCHMARK_ADVANCED("ZXGraph: full_reduce")(Catch::Benchmark::Chronometer meter) {
+        auto graphs = std::vector<ZXGraph>(static_cast<size_t>(meter.runs()), graph);
+        meter.measure([&](int i) {
+            simplify::full_reduce(graphs[static_cast<size_t>(i)]);
+            return graphs[static_cast<size_t>(i)].num_vertices();
+        });
+    };
+    BENCHMARK_ADVANCED("CompactZXGraph: full_reduce through the adapter")(Catch::Benchmark::Chronometer meter) {
+        auto graphs = std::vector<CompactZXGraph>(static_cast<size_t>(meter.runs()), compact_graph);
+        meter.measure([&](int i) {
+            with_zxgraph(graphs[static_cast<size_t>(i)], simplify::full_reduce);
+            return graphs[static_cast<size_t>(i)].num_vertices();
+        });
+    };
+}
+
+}  // namespace
+
+TEST_CASE("Graph backends on qft_65", "[benchmark][zx][compact]") {
+    run_backend_benchmarks("qft/qft_65.qasm");
+}
+
+TEST_CASE("Graph backends on qft_127", "[benchmark][zx][compact]") {
+    run_backend_benchmarks("qft/qft_127.qasm");
+}
@@ -0,0 +1,94 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "convert/qcir_to_zxgraph.hpp"
+#include "qcir/qcir_io.hpp"
+#include "zx/simplifier/simplify.hpp"
+#include "zx/zx_def.hpp"
+#include "zx/zxgraph.hpp"
+
+using namespace qsyn::zx;
+
+namespace {
+
+// a neighborhood as left behind by repeated local complementations: Z-spiders
+// with half of the possible Hadamard edges among them
+ZXGraph dense_z_graph(size_t num_vertices) {
+    ZXGraph graph;
+    std::mt19937 rng{42};
+    std::bernoulli_distribution coin{0.5};
+
+    for (size_t i = 0; i < num_vertices; ++i) graph.add_vertex(VertexType::z);
+    for (size_t i = 0; i < num_vertices; ++i) {
+        for (size_t j = i + 1; j < num_vertices; ++j) {
+            if (coin(rng)) graph.add_edge(i, j, EdgeType::hadamard);
+        }
+    }
+    return graph;
+}
+
+ZXGraph qft_graph(std::string const& filename) {
+    auto const qcir = qsyn::qcir::from_qasm(std::filesystem::path{QSYN_SOURCE_DIR} / "benchmark/qft" / filename);
+    REQUIRE(qcir.has_value());
+    auto graph = qsyn::to_zxgraph(*qcir);
+    REQUIRE(graph.has_value());
+    return std::move(*graph);
+}
+
+// full_reduce spends its rewrites on local complementations and pivots,
+// which complement the neighborhoods of the removed spiders
+void run_full_reduce_benchmark(std::string const& filename) {
+    auto const graph = qft_graph(filename);
+
+    BENCHMARK_ADVANCED("full_reduce")(Catch::Benchmark::Chronometer meter) {
+        auto graphs = std::vector<ZXGraph>(static_cast<size_t>(meter.runs()), graph);
+        meter.measure([&](int i) {
+            simplify::full_reduce(graphs[static_cast<size_t>(i)]);
+            return graphs[static_cast<size_t>(i)].num_vertices();
+        });
+    };
+}
+
+void run_benchmarks(size_t num_vertices) {
+    auto graph    = dense_z_graph(num_vertices);
+    auto vertices = std::vector<ZXVertex*>(graph.get_vertices().begin(), graph.get_vertices().end());
+
+    // each run complements the group once; an even number of runs leaves the
+    // graph as it was
+    BENCHMARK("add_edge on each pair") {
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            for (size_t j = i + 1; j < vertices.size(); ++j) {
+                graph.add_edge(vertices[i], vertices[j], EdgeType::hadamard);
+            }
+        }
+        return graph.num_edges();
+    };
+
+    BENCHMARK("complement_hadamard_edges") {
+        graph.complement_hadamard_edges(vertices);
+        return graph.num_edges();
+    };
+}
+
+}  // namespace
+
+TEST_CASE("Complementing 32 Z-spiders", "[benchmark][zx]") {
+    run_benchmarks(32);
+}
+
+TEST_CASE("Complementing 256 Z-spiders", "[benchmark][zx]") {
+    run_benchmarks(256);
+}
+
+TEST_CASE("Full reduce on qft_27", "[benchmark][zx]") {
+    run_full_reduce_benchmark("qft_27.qasm");
+}
+
+TEST_CASE("Full reduce on qft_65", "[benchmark][zx]") {
+    run_full_reduce_benchmark("qft_65.qasm");
+}
@@ -0,0 +1,60 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include "zx/simplifier/simplify.hpp"
+#include "zx/zx_def.hpp"
+#include "zx/zxgraph.hpp"
+
+using namespace qsyn::zx;
+using dvlab::Phase;
+
+namespace {
+
+// the shape of a freshly converted circuit: a chain of low-degree spiders per
+// qubit, with CZ-like Hadamard edges between the chains
+ZXGraph circuit_like_graph(size_t num_qubits, size_t depth) {
+    ZXGraph graph;
+    std::mt19937 rng{42};
+    std::uniform_int_distribution<size_t> qubit{0, num_qubits - 1};
+    std::uniform_int_distribution<int> eighth{0, 7};
+
+    std::vector<ZXVertex*> last;
+    for (size_t q = 0; q < num_qubits; ++q) {
+        last.emplace_back(graph.add_input(static_cast<qsyn::QubitIdType>(q)));
+    }
+    for (size_t d = 0; d < depth; ++d) {
+        auto const q1 = qubit(rng);
+        auto const q2 = qubit(rng);
+        for (auto const q : {q1, q2}) {
+            auto v = graph.add_vertex(VertexType::z, Phase(eighth(rng), 4));
+            graph.add_edge(last[q], v, EdgeType::simple);
+            last[q] = v;
+        }
+        if (q1 != q2) graph.add_edge(last[q1], last[q2], EdgeType::hadamard);
+    }
+    for (size_t q = 0; q < num_qubits; ++q) {
+        graph.add_edge(last[q], graph.add_output(static_cast<qsyn::QubitIdType>(q)), EdgeType::simple);
+    }
+    return graph;
+}
+
+}  // namespace
+
+TEST_CASE("Fusing a circuit-like graph", "[benchmark][zx]") {
+    auto const graph = circuit_like_graph(64, 20'000);
+
+    BENCHMARK("copy") {
+        auto g = graph;
+        return g.num_vertices();
+    };
+
+    BENCHMARK("spider fusion and identity removal") {
+        auto g = graph;
+        simplify::spider_fusion_simp(g);
+        simplify::identity_removal_simp(g);
+        return g.num_vertices();
+    };
+}
@@ -1,5 +1,8 @@
 #include "common/zx.hpp"
 
+#include <cstdint>
+#include <random>
+
 #include "common/global.hpp"
 #include "zx/zxgraph.hpp"
 
@@ -146,3 +149,42 @@ generate_random_pivot_graph(size_t num_v1_nbrs,
 
     return g;
 }
+
+ZXGraph generate_random_circuit_graph(size_t num_qubits, size_t depth, unsigned seed) {
+    std::mt19937 gen{seed};
+    std::uniform_int_distribution<size_t> qubit_dist(0, num_qubits - 1);
+    std::uniform_int_distribution<int> phase_dist(0, 7);
+
+    ZXGraph g;
+    std::vector<ZXVertex*> last;
+    for (size_t q = 0; q < num_qubits; ++q) {
+        last.emplace_back(g.add_input(q));
+    }
+    for (size_t d = 0; d < depth; ++d) {
+        auto const q1 = qubit_dist(gen);
+        auto const q2 = qubit_dist(gen);
+        auto const v1 = g.add_vertex(VertexType::z, Phase(phase_dist(gen), 4));
+        g.add_edge(last[q1], v1, EdgeType::simple);
+        last[q1] = v1;
+        if (q1 == q2) continue;
+        auto const v2 = g.add_vertex(VertexType::z);
+        g.add_edge(last[q2], v2, EdgeType::simple);
+        g.add_edge(v1, v2, EdgeType::hadamard);
+        last[q2] = v2;
+    }
+    for (size_t q = 0; q < num_qubits; ++q) {
+        g.add_edge(last[q], g.add_output(q), EdgeType::simple);
+    }
+    return g;
+}
+
+std::vector<std::pair<size_t, size_t>> get_iteration_order(ZXGraph const& graph) {
+    auto order = std::vector<std::pair<size_t, size_t>>{};
+    for (auto* v : graph.get_vertices()) {
+        order.emplace_back(v->get_id(), SIZE_MAX);
+        for (auto const& [nb, etype] : graph.get_neighbors(v)) {
+            order.emplace_back(nb->get_id(), static_cast<size_t>(etype));
+        }
+    }
+    return order;
+}
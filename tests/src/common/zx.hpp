@@ -1,6 +1,8 @@
 #pragma once
 
 #include <cstddef>
+#include <utility>
+#include <vector>
 
 #include "zx/zxgraph.hpp"
 
@@ -29,3 +31,16 @@ generate_random_pivot_graph(size_t num_v1_nbrs,
                             dvlab::Phase phase1,
                             dvlab::Phase phase2,
                             bool boundary_neighbors = false);
+
+// one wire per qubit, with random spiders on the wires and Hadamard edges
+// between the spiders on different wires
+qsyn::zx::ZXGraph
+generate_random_circuit_graph(size_t num_qubits,
+                              size_t depth,
+                              unsigned seed);
+
+// the vertex IDs in iteration order, each followed by its (neighbor ID, edge
+// type) pairs in iteration order. Rewrites visit the same matches on two
+// graphs only if these agree
+std::vector<std::pair<size_t, size_t>>
+get_iteration_order(qsyn::zx::ZXGraph const& graph);
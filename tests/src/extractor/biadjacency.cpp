@@ -0,0 +1,87 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include "extractor/extract.hpp"
+#include "qcir/qcir.hpp"
+#include "zx/simplifier/simplify.hpp"
+#include "zx/zxgraph.hpp"
+
+using namespace qsyn::zx;
+using dvlab::Phase;
+using qsyn::extractor::Extractor;
+
+namespace {
+
+// a random circuit of CNOTs, Hadamards, and Z-rotations by multiples of pi/4,
+// so that the reduced graph needs Gaussian eliminations to be extracted
+ZXGraph generate_random_cnot_t_graph(size_t num_qubits, size_t num_gates, unsigned seed) {
+    std::mt19937 gen{seed};
+    std::uniform_int_distribution<size_t> qubit_dist(0, num_qubits - 1);
+    std::uniform_int_distribution<int> gate_dist(0, 2);
+    std::uniform_int_distribution<int> phase_dist(1, 7);
+
+    ZXGraph g;
+    std::vector<ZXVertex*> last;
+    std::vector<EdgeType> pending;  // the edge type to the next spider on each wire
+    for (size_t q = 0; q < num_qubits; ++q) {
+        last.emplace_back(g.add_input(q));
+        pending.emplace_back(EdgeType::simple);
+    }
+    auto const append = [&](size_t q, VertexType vt, Phase phase) {
+        auto const v = g.add_vertex(vt, phase);
+        g.add_edge(last[q], v, pending[q]);
+        last[q]    = v;
+        pending[q] = EdgeType::simple;
+        return v;
+    };
+    for (size_t i = 0; i < num_gates; ++i) {
+        auto const q1 = qubit_dist(gen);
+        auto const q2 = qubit_dist(gen);
+        switch (gate_dist(gen)) {
+            case 0:
+                pending[q1] = pending[q1] == EdgeType::simple ? EdgeType::hadamard : EdgeType::simple;
+                break;
+            case 1:
+                append(q1, VertexType::z, Phase(phase_dist(gen), 4));
+                break;
+            default:
+                if (q1 == q2) break;
+                g.add_edge(append(q1, VertexType::z, Phase(0)), append(q2, VertexType::x, Phase(0)), EdgeType::simple);
+                break;
+        }
+    }
+    for (size_t q = 0; q < num_qubits; ++q) {
+        g.add_edge(last[q], g.add_output(q), pending[q]);
+    }
+    return g;
+}
+
+}  // namespace
+
+TEST_CASE("Cached bi-adjacency matrix matches a full recompute during extraction", "[extractor]") {
+    auto const seed          = GENERATE(1u, 2u, 3u);
+    auto const dynamic_order = GENERATE(false, true);
+
+    auto g = generate_random_cnot_t_graph(6, 150, seed);
+    simplify::full_reduce(g);
+
+    auto config          = qsyn::extractor::default_extractor_config;
+    config.dynamic_order = dynamic_order;
+
+    qsyn::qcir::QCir qcir{g.num_outputs()};
+    Extractor extractor{&g, config, &qcir};
+
+    // the matrix is updated from the one of the previous iteration, so compare
+    // it against a full recompute after every iteration
+    while (!extractor.frontier_is_empty()) {
+        REQUIRE(extractor.extraction_loop(1));
+        extractor.clean_frontier();
+        extractor.update_neighbors();
+        extractor.update_matrix();
+        REQUIRE(extractor.get_biadjacency().get_matrix() ==
+                get_biadjacency_matrix(g, extractor.get_frontier(), extractor.get_neighbors()).get_matrix());
+    }
+}
@@ -0,0 +1,72 @@
+#include "qcir/qcir.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <random>
+#include <vector>
+
+#include "qcir/basic_gate_type.hpp"
+
+using namespace qsyn::qcir;
+using qsyn::QubitIdList;
+
+namespace {
+
+std::vector<QCirGate> random_gates(std::mt19937& rng, size_t num_qubits, size_t num_gates) {
+    auto pick_qubit = std::uniform_int_distribution<size_t>{0, num_qubits - 1};
+    std::vector<QCirGate> gates;
+    for (size_t i = 0; i < num_gates; ++i) {
+        auto const q0 = pick_qubit(rng);
+        auto const q1 = (q0 + 1 + pick_qubit(rng) % (num_qubits - 1)) % num_qubits;
+        if (rng() % 2 == 0) {
+            gates.emplace_back(HGate(), QubitIdList{q0});
+        } else {
+            gates.emplace_back(CXGate(), QubitIdList{q0, q1});
+        }
+    }
+    return gates;
+}
+
+// the same gates under the same IDs, wired the same way
+bool same_structure(QCir const& lhs, QCir const& rhs) {
+    if (lhs.get_num_gates() != rhs.get_num_gates()) return false;
+    for (auto const* gate : lhs.get_gates()) {
+        auto const* other = rhs.get_gate(gate->get_id());
+        if (other == nullptr ||
+            gate->get_operation() != other->get_operation() ||
+            gate->get_qubits() != other->get_qubits() ||
+            lhs.get_predecessors(gate->get_id()) != rhs.get_predecessors(gate->get_id()) ||
+            lhs.get_successors(gate->get_id()) != rhs.get_successors(gate->get_id())) {
+            return false;
+        }
+    }
+    for (size_t q = 0; q < lhs.get_num_qubits(); ++q) {
+        auto const id = [](QCirGate const* gate) { return gate == nullptr ? std::nullopt : std::optional{gate->get_id()}; };
+        if (id(lhs.get_qubits()[q].get_first_gate()) != id(rhs.get_qubits()[q].get_first_gate()) ||
+            id(lhs.get_qubits()[q].get_last_gate()) != id(rhs.get_qubits()[q].get_last_gate())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+TEST_CASE("Prepending a block matches prepending its gates one by one", "[qcir]") {
+    auto rng = std::mt19937{7};
+    for (size_t trial = 0; trial < 50; ++trial) {
+        auto const num_qubits = 2 + trial % 6;
+        auto one_by_one       = QCir{num_qubits};
+        auto block            = QCir{num_qubits};
+        for (auto const& gate : random_gates(rng, num_qubits, trial % 5)) {
+            one_by_one.append(gate);
+            block.append(gate);
+        }
+
+        for (size_t round = 0; round < 3; ++round) {
+            auto const gates = random_gates(rng, num_qubits, 3 * trial % 20);
+            for (auto const& gate : gates) one_by_one.prepend(gate);
+            block.prepend_all(gates);
+            REQUIRE(same_structure(one_by_one, block));
+        }
+    }
+}
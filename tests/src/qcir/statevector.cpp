@@ -0,0 +1,109 @@
+#include "qcir/statevector.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <cmath>
+#include <complex>
+#include <random>
+#include <stdexcept>
+
+#include "qcir/basic_gate_type.hpp"
+#include "qcir/qcir.hpp"
+#include "util/phase.hpp"
+
+using namespace qsyn::qcir;
+using Catch::Matchers::WithinAbs;
+using dvlab::Phase;
+
+namespace {
+
+void require_amplitude(Statevector const& state, size_t basis, std::complex<double> expected) {
+    REQUIRE_THAT(state.get_amplitude(basis).real(), WithinAbs(expected.real(), 1e-12));
+    REQUIRE_THAT(state.get_amplitude(basis).imag(), WithinAbs(expected.imag(), 1e-12));
+}
+
+}  // namespace
+
+TEST_CASE("Preparing a Bell state", "[statevector]") {
+    auto qcir = QCir{2};
+    qcir.append(HGate(), {0});
+    qcir.append(CXGate(), {0, 1});
+
+    auto const state = simulate(qcir);
+    REQUIRE(state.has_value());
+    require_amplitude(*state, 0b00, M_SQRT1_2);
+    require_amplitude(*state, 0b01, 0.);
+    require_amplitude(*state, 0b10, 0.);
+    require_amplitude(*state, 0b11, M_SQRT1_2);
+}
+
+TEST_CASE("Qubit 0 is the least significant bit", "[statevector]") {
+    auto qcir = QCir{3};
+    qcir.append(XGate(), {0});
+    qcir.append(XGate(), {1});
+    qcir.append(CCXGate(), {0, 1, 2});  // |011> -> |111>
+    qcir.append(XGate(), {1});          // |111> -> |101>
+    qcir.append(SwapGate(), {1, 2});    // |101> -> |011>
+
+    auto const state = simulate(qcir);
+    REQUIRE(state.has_value());
+    require_amplitude(*state, 0b011, 1.);
+    require_amplitude(*state, 0b101, 0.);
+}
+
+TEST_CASE("Phases and rotations", "[statevector]") {
+    auto qcir = QCir{2};
+    qcir.append(HGate(), {0});
+    qcir.append(TGate(), {0});
+    qcir.append(RXGate(Phase(1, 2)), {1});
+
+    auto const state = simulate(qcir);
+    REQUIRE(state.has_value());
+    auto const t = std::polar(1., M_PI / 4);
+    require_amplitude(*state, 0b00, M_SQRT1_2 * M_SQRT1_2);
+    require_amplitude(*state, 0b01, M_SQRT1_2 * M_SQRT1_2 * t);
+    require_amplitude(*state, 0b10, std::complex<double>{0., -0.5});
+    require_amplitude(*state, 0b11, std::complex<double>{0., -0.5} * t);
+}
+
+TEST_CASE("Threaded sweeps agree with the sequential one", "[statevector]") {
+    auto qcir = QCir{16};
+    for (size_t layer = 0; layer < 4; ++layer) {
+        for (size_t q = 0; q < 16; ++q) qcir.append(HGate(), {q});
+        for (size_t q = 0; q < 16; ++q) qcir.append(PZGate(Phase(static_cast<int>(q + layer), 8)), {q});
+        for (size_t q = 0; q + 1 < 16; q += 2) qcir.append(CXGate(), {q + layer % 2, (q + layer % 2 + 1) % 16});
+    }
+
+    auto const sequential = simulate(qcir, 1);
+    auto const threaded   = simulate(qcir, 4);
+    REQUIRE(sequential.has_value());
+    REQUIRE(threaded.has_value());
+    REQUIRE(sequential->get_amplitudes() == threaded->get_amplitudes());
+
+    auto norm = 0.;
+    for (size_t basis = 0; basis < sequential->size(); ++basis) norm += sequential->get_probability(basis);
+    REQUIRE_THAT(norm, WithinAbs(1., 1e-9));
+}
+
+TEST_CASE("Sampling draws only reachable basis states", "[statevector]") {
+    auto qcir = QCir{2};
+    qcir.append(HGate(), {0});
+    qcir.append(CXGate(), {0, 1});
+
+    auto const state = simulate(qcir);
+    REQUIRE(state.has_value());
+    auto rng           = std::mt19937_64{42};
+    auto const samples = state->sample(1000, rng);
+    size_t total       = 0;
+    for (auto const& [basis, count] : samples) {
+        REQUIRE((basis == 0b00 || basis == 0b11));
+        total += count;
+    }
+    REQUIRE(total == 1000);
+}
+
+TEST_CASE("Too many qubits are rejected before allocating", "[statevector]") {
+    REQUIRE_THROWS_AS(Statevector{Statevector::max_num_qubits + 1}, std::length_error);
+    REQUIRE_THROWS_AS(Statevector{64}, std::length_error);
+    REQUIRE_FALSE(simulate(QCir{Statevector::max_num_qubits + 1}).has_value());
+}
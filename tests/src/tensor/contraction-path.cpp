@@ -0,0 +1,107 @@
+#include "tensor/contraction_path.hpp"
+
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+using namespace qsyn::tensor;
+
+namespace {
+
+// replays the path, checking that every step contracts two live operands and
+// that a single operand is left; returns the peak rank along the path
+size_t replay(std::vector<IndexList> operands, ContractionPath const& path) {
+    auto live = std::vector<bool>(operands.size(), true);
+    auto peak = size_t{0};
+    for (auto const& indices : operands) peak = std::max(peak, indices.size());
+
+    for (auto const& [a, b] : path.steps) {
+        REQUIRE(a < operands.size());
+        REQUIRE(b < operands.size());
+        REQUIRE(a != b);
+        REQUIRE(live[a]);
+        REQUIRE(live[b]);
+        live[a] = live[b] = false;
+        operands.emplace_back(contract_index_lists(operands[a], operands[b]));
+        live.emplace_back(true);
+        peak = std::max(peak, operands.back().size());
+    }
+    REQUIRE(std::ranges::count(live, true) == 1);
+    return peak;
+}
+
+// a spider with legs 0, 2 and a Hadamard to a spider with legs 1, 3, joined
+// through a third spider that also carries a dangling spider
+std::vector<IndexList> const two_qubit_network = {{0, 2, 10}, {1, 3, 11}, {10, 11, 12}, {12}};
+
+// a 2-by-n grid, each node with an open leg
+std::vector<IndexList> grid_network(size_t n) {
+    auto operands = std::vector<IndexList>{};
+    for (size_t row = 0; row < 2; ++row) {
+        for (size_t i = 0; i < n; ++i) {
+            auto indices = IndexList{};
+            if (i > 0) indices.emplace_back(1000 + row * 100 + i - 1);
+            if (i + 1 < n) indices.emplace_back(1000 + row * 100 + i);
+            indices.emplace_back(2000 + i);
+            indices.emplace_back(row * n + i);
+            operands.emplace_back(indices);
+        }
+    }
+    return operands;
+}
+
+}  // namespace
+
+TEST_CASE("Contracting index lists", "[contraction-path]") {
+    REQUIRE(contract_index_lists({0, 1, 2}, {2, 3, 1}) == IndexList{0, 3});
+    REQUIRE(contract_index_lists({0, 1}, {2, 3}) == IndexList{0, 1, 2, 3});
+    REQUIRE(contract_index_lists({0, 1}, {1, 0}).empty());
+}
+
+TEST_CASE("Contraction orders from strings", "[contraction-path]") {
+    REQUIRE(str_to_contraction_order("topological") == ContractionOrder::topological);
+    REQUIRE(str_to_contraction_order("Greedy") == ContractionOrder::greedy);
+    REQUIRE(str_to_contraction_order("min-fill") == ContractionOrder::min_fill);
+    REQUIRE(!str_to_contraction_order("random").has_value());
+}
+
+TEST_CASE("Sequential contraction follows the given order", "[contraction-path]") {
+    auto const path = plan_sequential_contraction(two_qubit_network, {0, 2, 1, 3});
+    REQUIRE(path.steps == std::vector<std::pair<size_t, size_t>>{{0, 2}, {4, 1}, {5, 3}});
+    REQUIRE(path.peak_rank == 5);
+    REQUIRE(replay(two_qubit_network, path) == path.peak_rank);
+}
+
+TEST_CASE("Planned paths are valid and predict their peak", "[contraction-path]") {
+    for (auto const& operands : {two_qubit_network, grid_network(6), grid_network(12)}) {
+        auto const greedy = plan_greedy_contraction(operands);
+        REQUIRE(replay(operands, greedy) == greedy.peak_rank);
+
+        auto const min_fill = plan_min_fill_contraction(operands);
+        REQUIRE(replay(operands, min_fill) == min_fill.peak_rank);
+    }
+}
+
+TEST_CASE("Greedy and min-fill paths keep intermediates small", "[contraction-path]") {
+    REQUIRE(plan_greedy_contraction(two_qubit_network).peak_rank == 4);
+    REQUIRE(plan_min_fill_contraction(two_qubit_network).peak_rank == 4);
+
+    // the sequential path carries the whole cut of the grid along; the others
+    // only reach the open legs of the final tensor
+    auto const grid = grid_network(12);
+    REQUIRE(plan_sequential_contraction(grid, {}).peak_rank > 24);
+    REQUIRE(plan_greedy_contraction(grid).peak_rank == 24);
+    REQUIRE(plan_min_fill_contraction(grid).peak_rank == 24);
+}
+
+TEST_CASE("Disconnected operands are joined lowest rank first", "[contraction-path]") {
+    auto const operands = std::vector<IndexList>{{0, 1, 2}, {3}, {4, 5}};
+    for (auto const& path : {plan_sequential_contraction(operands, {}),
+                             plan_greedy_contraction(operands),
+                             plan_min_fill_contraction(operands)}) {
+        REQUIRE(path.steps == std::vector<std::pair<size_t, size_t>>{{1, 2}, {3, 0}});
+        REQUIRE(path.peak_rank == 6);
+    }
+}
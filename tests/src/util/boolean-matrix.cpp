@@ -0,0 +1,211 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <cstddef>
+#include <optional>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "util/boolean_matrix.hpp"
+
+using dvlab::BooleanMatrix;
+
+namespace {
+
+using Bytes = std::vector<std::vector<unsigned char>>;
+
+Bytes random_bytes(size_t rows, size_t cols, std::mt19937& rng) {
+    auto coin = std::bernoulli_distribution{0.3};
+    auto ret  = Bytes(rows, std::vector<unsigned char>(cols, 0));
+    for (auto& row : ret) {
+        for (auto& x : row) x = coin(rng) ? 1 : 0;
+    }
+    return ret;
+}
+
+BooleanMatrix to_matrix(Bytes const& bytes) {
+    auto ret = BooleanMatrix();
+    for (auto const& row : bytes) ret.push_row(row);
+    return ret;
+}
+
+bool same_entries(BooleanMatrix const& matrix, Bytes const& bytes) {
+    if (matrix.num_rows() != bytes.size()) return false;
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        if (matrix[i].get_row() != bytes[i]) return false;
+    }
+    return true;
+}
+
+// rank by byte-wise elimination
+size_t naive_rank(Bytes bytes) {
+    size_t rank = 0;
+    for (size_t col = 0; col < (bytes.empty() ? 0 : bytes[0].size()); ++col) {
+        auto pivot = rank;
+        while (pivot < bytes.size() && bytes[pivot][col] == 0) ++pivot;
+        if (pivot == bytes.size()) continue;
+        std::swap(bytes[rank], bytes[pivot]);
+        for (size_t r = 0; r < bytes.size(); ++r) {
+            if (r == rank || bytes[r][col] == 0) continue;
+            for (size_t c = 0; c < bytes[r].size(); ++c) bytes[r][c] ^= bytes[rank][c];
+        }
+        ++rank;
+    }
+    return rank;
+}
+
+}  // namespace
+
+TEST_CASE("Row entries across word boundaries", "[boolean_matrix]") {
+    auto const size = GENERATE(size_t{1}, size_t{63}, size_t{64}, size_t{65}, size_t{200});
+    auto rng        = std::mt19937{static_cast<unsigned>(size)};
+    auto const ref  = random_bytes(1, size, rng)[0];
+
+    auto row = BooleanMatrix::Row(ref);
+    REQUIRE(row.size() == size);
+    REQUIRE(row.get_row() == ref);
+    REQUIRE(row.sum() == static_cast<size_t>(std::ranges::count(ref, 1)));
+    REQUIRE(row.is_zeros() == (row.sum() == 0));
+    REQUIRE(row.is_one_hot() == (row.sum() == 1));
+
+    // a full row built entry by entry equals one built in one go
+    auto ones = BooleanMatrix::Row(0);
+    for (size_t i = 0; i < size; ++i) ones.emplace_back(1);
+    REQUIRE(ones == BooleanMatrix::Row(size, 1));
+    REQUIRE(ones.sum() == size);
+    REQUIRE((row + ones).sum() == size - row.sum());
+    REQUIRE((row * ones) == row);
+    REQUIRE((0 * row).is_zeros());
+
+    for (size_t begin = 0; begin < size; begin += 7) {
+        for (size_t end = begin; end <= size; end += 13) {
+            auto const expected = std::vector<unsigned char>(ref.begin() + static_cast<std::ptrdiff_t>(begin), ref.begin() + static_cast<std::ptrdiff_t>(end));
+            REQUIRE(row.sub_row(begin, end).get_row() == expected);
+        }
+    }
+
+    row[size - 1] = 1;
+    row[size - 1] += 1;
+    REQUIRE(row.back() == 0);
+    row.back() = row[0];
+    REQUIRE(row.back() == ref[0]);
+}
+
+TEST_CASE("Gaussian elimination on packed rows", "[boolean_matrix]") {
+    auto const shape      = GENERATE(std::pair<size_t, size_t>{5, 5}, std::pair<size_t, size_t>{20, 70}, std::pair<size_t, size_t>{130, 130});
+    auto const block_size = GENERATE(size_t{1}, size_t{3}, size_t{64});
+    auto rng              = std::mt19937{42};
+    auto const bytes      = random_bytes(shape.first, shape.second, rng);
+
+    auto matrix     = to_matrix(bytes);
+    auto const rank = matrix.gaussian_elimination_skip(block_size, true, true);
+    REQUIRE(rank == naive_rank(bytes));
+    REQUIRE(to_matrix(bytes).matrix_rank() == rank);
+
+    // replaying the recorded row operations reproduces the reduced matrix
+    auto replayed = bytes;
+    for (auto const& [ctrl, targ] : matrix.get_row_operations()) {
+        for (size_t c = 0; c < shape.second; ++c) replayed[targ][c] ^= replayed[ctrl][c];
+    }
+    REQUIRE(same_entries(matrix, replayed));
+
+    // the leading 1 of each nonzero row is the only 1 in its column
+    for (size_t r = 0; r < rank; ++r) {
+        auto const& row   = matrix[r];
+        auto const pivot  = static_cast<size_t>(std::distance(row.begin(), std::ranges::find(row, 1)));
+        auto const n_ones = std::ranges::count_if(matrix, [pivot](BooleanMatrix::Row const& other) { return other[pivot] == 1; });
+        REQUIRE(n_ones == 1);
+    }
+    for (size_t r = rank; r < matrix.num_rows(); ++r) {
+        REQUIRE(matrix[r].is_zeros());
+    }
+}
+
+TEST_CASE("Stacking and transposing packed matrices", "[boolean_matrix]") {
+    auto rng     = std::mt19937{7};
+    auto const a = random_bytes(10, 70, rng);
+    auto const b = random_bytes(10, 3, rng);
+
+    auto const stacked = dvlab::hstack(to_matrix(a), to_matrix(b));
+    REQUIRE(stacked.num_cols() == 73);
+    for (size_t i = 0; i < 10; ++i) {
+        for (size_t j = 0; j < 73; ++j) {
+            REQUIRE(stacked[i][j] == (j < 70 ? a[i][j] : b[i][j - 70]));
+        }
+    }
+
+    auto const transposed = dvlab::transpose(stacked);
+    REQUIRE(transposed.num_rows() == 73);
+    REQUIRE(transposed.num_cols() == 10);
+    REQUIRE(dvlab::transpose(transposed).get_matrix() == stacked.get_matrix());
+}
+
+TEST_CASE("M4RI elimination matches block elimination", "[boolean_matrix]") {
+    auto const shape      = GENERATE(std::pair<size_t, size_t>{1, 1}, std::pair<size_t, size_t>{7, 5}, std::pair<size_t, size_t>{40, 90}, std::pair<size_t, size_t>{150, 150});
+    auto const block_size = GENERATE(size_t{1}, size_t{4}, size_t{8}, size_t{100});
+    auto const reduced    = GENERATE(true, false);
+    auto rng              = std::mt19937{static_cast<unsigned>(shape.first + block_size)};
+    auto const bytes      = random_bytes(shape.first, shape.second, rng);
+
+    auto matrix     = to_matrix(bytes);
+    auto const rank = matrix.gaussian_elimination_m4ri(block_size, reduced, true);
+    REQUIRE(rank == naive_rank(bytes));
+
+    auto replayed = bytes;
+    for (auto const& [ctrl, targ] : matrix.get_row_operations()) {
+        for (size_t c = 0; c < shape.second; ++c) replayed[targ][c] ^= replayed[ctrl][c];
+    }
+    REQUIRE(same_entries(matrix, replayed));
+
+    for (size_t r = rank; r < matrix.num_rows(); ++r) {
+        REQUIRE(matrix[r].is_zeros());
+    }
+
+    // the reduced row echelon form is unique
+    if (reduced) {
+        auto expected = to_matrix(bytes);
+        expected.gaussian_elimination_skip(block_size, true, false);
+        REQUIRE(matrix.get_matrix() == expected.get_matrix());
+    }
+}
+
+TEST_CASE("Row overlaps track the most overlapping rows", "[boolean_matrix]") {
+    auto const num_rows = GENERATE(size_t{1}, size_t{6}, size_t{70});
+    auto rng            = std::mt19937{static_cast<unsigned>(num_rows)};
+    auto matrix         = to_matrix(random_bytes(num_rows, 100, rng));
+
+    // the first pair with the largest number of common ones, as found by a full scan
+    auto const naive_max_overlap_pair = [&]() -> std::optional<std::pair<size_t, size_t>> {
+        size_t best = 0;
+        std::optional<std::pair<size_t, size_t>> ret;
+        for (size_t i = 0; i < matrix.num_rows(); ++i) {
+            for (size_t j = i + 1; j < matrix.num_rows(); ++j) {
+                auto const overlap = (matrix[i] * matrix[j]).sum();
+                REQUIRE(matrix[i].overlap(matrix[j]) == overlap);
+                REQUIRE(matrix[i].distance(matrix[j]) == (matrix[i] + matrix[j]).sum());
+                if (overlap > best) {
+                    best = overlap;
+                    ret  = std::make_pair(i, j);
+                }
+            }
+        }
+        return ret;
+    };
+
+    auto overlaps = dvlab::RowOverlaps(matrix);
+    REQUIRE(overlaps.max_overlap_pair() == naive_max_overlap_pair());
+
+    auto pick_row = std::uniform_int_distribution<size_t>{0, num_rows - 1};
+    auto pick_col = std::uniform_int_distribution<size_t>{0, 99};
+    for (size_t step = 0; step < 50; ++step) {
+        auto changed = std::vector<size_t>{};
+        for (size_t k = 0; k < 3; ++k) {
+            auto const r = pick_row(rng);
+            // mostly clear entries, as when CZs are extracted
+            for (size_t c = 0; c < 20; ++c) matrix[r][pick_col(rng)] = (c % 4 == 0) ? 1 : 0;
+            changed.emplace_back(r);
+        }
+        overlaps.update_rows(matrix, changed);
+        REQUIRE(overlaps.max_overlap_pair() == naive_max_overlap_pair());
+    }
+}
@@ -0,0 +1,75 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "util/flat_ordered_hashmap.hpp"
+#include "util/flat_ordered_hashset.hpp"
+#include "util/ordered_hashmap.hpp"
+#include "util/ordered_hashset.hpp"
+
+TEST_CASE("flat_ordered_hashset matches ordered_hashset", "[flat_ordered_hashtable]") {
+    auto const seed = GENERATE(1u, 2u, 3u);
+    auto rng        = std::mt19937{seed};
+    auto dist       = std::uniform_int_distribution<int>{0, 200};
+
+    dvlab::utils::ordered_hashset<int> expected;
+    dvlab::utils::flat_ordered_hashset<int> actual;
+
+    for (int i = 0; i < 5000; ++i) {
+        auto const x = dist(rng);
+        if (rng() % 3 == 0) {
+            REQUIRE(actual.erase(x) == expected.erase(x));
+        } else {
+            REQUIRE(actual.insert(x).second == expected.insert(x).second);
+        }
+        REQUIRE(actual.size() == expected.size());
+        REQUIRE(actual.contains(x) == expected.contains(x));
+    }
+
+    // iteration follows insertion order in both containers
+    REQUIRE(std::vector<int>(actual.begin(), actual.end()) == std::vector<int>(expected.begin(), expected.end()));
+
+    auto const reversed = std::vector<int>(std::make_reverse_iterator(actual.end()), std::make_reverse_iterator(actual.begin()));
+    REQUIRE(reversed == std::vector<int>(std::make_reverse_iterator(expected.end()), std::make_reverse_iterator(expected.begin())));
+
+    actual.sort(std::greater<>{});
+    expected.sort(std::greater<>{});
+    REQUIRE(std::vector<int>(actual.begin(), actual.end()) == std::vector<int>(expected.begin(), expected.end()));
+    for (auto x : expected) REQUIRE(actual.contains(x));
+}
+
+TEST_CASE("flat_ordered_hashmap basic operations", "[flat_ordered_hashtable]") {
+    dvlab::utils::flat_ordered_hashmap<std::string, int> map;
+    map.reserve(100);
+
+    for (int i = 0; i < 100; ++i) {
+        map.emplace(std::to_string(i), i);
+    }
+    REQUIRE(map.size() == 100);
+    REQUIRE(map.at("42") == 42);
+    REQUIRE_THROWS_AS(map.at("100"), std::out_of_range);
+
+    map["42"] = -42;
+    REQUIRE(map.at("42") == -42);
+    REQUIRE(map["new"] == 0);
+    REQUIRE(map.size() == 101);
+
+    REQUIRE_FALSE(map.try_emplace("0", 1).second);
+    REQUIRE(map.insert_or_assign("0", 1).first->second == 1);
+
+    for (int i = 0; i < 100; i += 2) {
+        REQUIRE(map.erase(std::to_string(i)) == 1);
+    }
+    REQUIRE(map.erase(map.find("1")) == 1);
+    REQUIRE(map.size() == 50);
+    REQUIRE(map.begin()->first == "3");
+    REQUIRE(std::prev(map.end())->first == "new");
+
+    auto const copied = map;
+    REQUIRE(copied == map);
+    map.clear();
+    REQUIRE(map.empty());
+    REQUIRE(copied != map);
+}
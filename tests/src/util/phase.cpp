@@ -0,0 +1,100 @@
+#include "util/phase.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <limits>
+#include <random>
+#include <stdexcept>
+
+#include "common/global.hpp"
+
+using dvlab::Phase;
+using dvlab::Rational;
+
+namespace {
+
+// whether p is q·π, normalizing q to (-1, 1] with the general rational arithmetic
+bool agrees(Phase const& p, Rational q) {
+    while (q <= -1) q += 2;
+    while (q > 1) q -= 2;
+    return p.get_rational() == q;
+}
+
+}  // namespace
+
+static_assert(Phase(3, 4) + Phase(1, 4) == Phase(1));
+static_assert(Phase(-1, 2) - Phase(1, 2) == Phase(1));
+static_assert(Phase(1, 8) * 12 == Phase(-1, 2));
+static_assert(Phase(3, 2) / 4 == Phase(-1, 8));
+
+TEST_CASE("Dyadic phases are kept in canonical form", "[phase]") {
+    REQUIRE(Phase(6, 8).is_dyadic());
+    REQUIRE(Phase(6, 8).numerator() == 3);
+    REQUIRE(Phase(6, 8).denominator() == 4);
+    REQUIRE(Phase(5, -4) == Phase(3, 4));
+    REQUIRE(Phase(-1) == Phase(1));
+    REQUIRE(Phase(4, 2) == Phase(0));
+    REQUIRE(Phase(0).denominator() == 1);
+
+    REQUIRE(!Phase(1, 3).is_dyadic());
+    // a non-dyadic computation that ends up dyadic switches back to the fast path
+    REQUIRE((Phase(1, 3) + Phase(1, 6)).is_dyadic());
+    REQUIRE(Phase(1, 3) + Phase(1, 6) == Phase(1, 2));
+    REQUIRE(Phase(1, 3) * 3 == Phase(1));
+    REQUIRE(Phase(1, 2) * Rational(2, 3) == Phase(1, 3));
+
+    REQUIRE(-Phase(1) == Phase(1));
+    REQUIRE(-Phase(1, 4) == Phase(7, 4));
+    REQUIRE((Phase(1, 4) / Phase(1, 2) == Rational(1, 2)));
+}
+
+TEST_CASE("Phase arithmetic agrees with rational arithmetic", "[phase]") {
+    auto const random_phase = []() {
+        auto const num = std::uniform_int_distribution<>(-300, 300)(rand_gen());
+        // mostly dyadic denominators, as in practice
+        auto const den = coin_flip(0.8) ? 1 << std::uniform_int_distribution<>(0, 12)(rand_gen())
+                                        : std::uniform_int_distribution<>(1, 60)(rand_gen());
+        return Phase(num, den);
+    };
+
+    for (size_t i = 0; i < 10000; ++i) {
+        auto const lhs = random_phase();
+        auto const rhs = random_phase();
+        auto const n   = std::uniform_int_distribution<>(-20, 20)(rand_gen());
+
+        REQUIRE(agrees(lhs + rhs, lhs.get_rational() + rhs.get_rational()));
+        REQUIRE(agrees(lhs - rhs, lhs.get_rational() - rhs.get_rational()));
+        REQUIRE(agrees(lhs * n, lhs.get_rational() * n));
+        if (n != 0) {
+            REQUIRE(agrees(lhs / n, lhs.get_rational() / n));
+        }
+        REQUIRE((lhs == rhs) == (lhs.get_rational() == rhs.get_rational()));
+    }
+}
+
+TEST_CASE("Deep dyadic phases do not overflow", "[phase]") {
+    auto const tiny = Phase(1, 1 << 30);
+
+    auto sum = Phase(0);
+    for (size_t i = 0; i < 1000; ++i) sum += tiny * 1'000'003;
+    REQUIRE(sum == Phase(1, 1 << 30) * static_cast<Phase::IntegralType>((1'000'003ll * 1000) % (1ll << 31)));
+
+    REQUIRE(Phase::phase_to_d(Phase(1, 1 << 20)) == std::numbers::pi / (1 << 20));
+}
+
+TEST_CASE("Phases at the 2^30 boundary stay exact or throw", "[phase]") {
+    auto const tiny = Phase(1, 1 << 30);
+    REQUIRE(tiny.is_dyadic());
+    REQUIRE(tiny.denominator() == 1 << 30);
+    REQUIRE(tiny + tiny == Phase(1, 1 << 29));
+    REQUIRE(Phase(2, 1 << 30) / 2 == tiny);
+    REQUIRE(Phase(-1, 1 << 30) / -1 == tiny);
+
+    // π/2^31 and 3π/2^30 fit neither the dyadic form nor an int fraction
+    REQUIRE_THROWS_AS(tiny / 2, std::overflow_error);
+    REQUIRE_THROWS_AS(tiny / 3, std::overflow_error);
+    REQUIRE_THROWS_AS(Phase(1, std::numeric_limits<Phase::IntegralType>::min()), std::overflow_error);
+    REQUIRE_THROWS_AS(Phase(1, 3) + tiny, std::overflow_error);
+
+    // the reduced result may fit even if the intermediate product does not
+    REQUIRE(Phase(1, 3) * Rational(1 << 30, 3) == Phase(1 << 30, 9));
+}
@@ -0,0 +1,105 @@
+#include "util/slab_pool.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "zx/zxgraph.hpp"
+
+TEST_CASE("slab_pool", "[slab_pool]") {
+    using Pool = dvlab::utils::slab_pool<std::string, 4>;
+    auto pool  = Pool{};
+
+    std::vector<std::string*> objs;
+    for (int i = 0; i < 10; ++i) {
+        objs.push_back(pool.create(std::to_string(i)));
+    }
+    REQUIRE(pool.size() == 10);
+    REQUIRE(pool.get_statistics().num_slabs == 3);
+    REQUIRE(*objs[7] == "7");
+
+    // freed slots are reused before a new slab is allocated
+    pool.destroy(objs[3]);
+    pool.destroy(objs[5]);
+    REQUIRE(pool.get_statistics().num_freed == 2);
+    auto reused = pool.create("reused");
+    REQUIRE((reused == objs[3] || reused == objs[5]));
+    REQUIRE(pool.get_statistics().num_freed == 1);
+
+    pool.reserve(20);
+    auto const stats = pool.get_statistics();
+    REQUIRE(stats.num_slabs == 4);
+    REQUIRE(stats.capacity - stats.num_live >= 20);
+
+    auto other = Pool{};
+    auto moved = other.create("moved");
+    pool.merge(std::move(other));
+    REQUIRE(other.get_statistics().capacity == 0);
+    REQUIRE(pool.size() == 10);
+    REQUIRE(*moved == "moved");
+
+    pool.destroy(moved);
+    pool.destroy(reused);
+    for (auto i : {0, 1, 2, 4, 6, 7, 8, 9}) pool.destroy(objs[i]);
+    REQUIRE(pool.empty());
+}
+
+TEST_CASE("slab_pool adoption", "[slab_pool]") {
+    using Pool = dvlab::utils::slab_pool<std::string, 4>;
+    auto owner = std::make_shared<Pool>();
+
+    std::vector<std::string*> objs;
+    for (int i = 0; i < 6; ++i) {
+        objs.push_back(owner->create(std::to_string(i)));
+    }
+
+    auto first  = std::make_shared<Pool>();
+    auto second = std::make_shared<Pool>();
+    first->adopt(owner, 3);
+    second->adopt(owner, 3);
+    REQUIRE(owner->empty());
+    REQUIRE(first->size() == 3);
+
+    // the owner stays alive as long as an adopting pool refers to it
+    std::weak_ptr<Pool> const owner_ref = owner;
+    owner.reset();
+    REQUIRE(!owner_ref.expired());
+
+    // adopted slots are reused by the adopting pool
+    first->destroy(objs[0]);
+    REQUIRE(first->create("reused") == objs[0]);
+    second->destroy(objs[4]);
+
+    first->merge(std::move(*second));
+    REQUIRE(first->size() == 5);
+    second.reset();
+    // no other pool refers to the owner any more, so it is merged in
+    REQUIRE(owner_ref.expired());
+    REQUIRE(first->get_statistics().capacity == 8);
+
+    for (auto i : {0, 1, 2, 3, 5}) first->destroy(objs[i]);
+    REQUIRE(first->empty());
+}
+
+TEST_CASE("ZXGraph vertex pool", "[zx][slab_pool]") {
+    using namespace qsyn::zx;
+    ZXGraph g;
+    for (size_t i = 0; i < 300; ++i) g.add_vertex(VertexType::z);
+    REQUIRE(g.get_vertex_pool_statistics().num_live == 300);
+
+    g.remove_vertex(size_t{7});
+    REQUIRE(g.get_vertex_pool_statistics().num_freed >= 1);
+    auto const v = g.add_vertex(VertexType::x);
+    REQUIRE(v != nullptr);
+    REQUIRE(g.get_vertex_pool_statistics().num_live == 300);
+
+    auto const copied = g;
+    REQUIRE(copied == g);
+    REQUIRE(copied.get_vertex_pool_statistics().num_slabs == 1);
+
+    auto composed = g;
+    composed.tensor_product(copied);
+    REQUIRE(composed.num_vertices() == 600);
+    REQUIRE(composed.get_vertex_pool_statistics().num_live == 600);
+}
@@ -0,0 +1,63 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <random>
+#include <vector>
+
+#include "util/ordered_hashset.hpp"
+#include "util/small_ordered_hashset.hpp"
+
+TEST_CASE("small_ordered_hashset matches ordered_hashset", "[small_ordered_hashset]") {
+    auto const seed     = GENERATE(1u, 2u, 3u);
+    auto const max_elem = GENERATE(3, 8, 50);
+    auto rng            = std::mt19937{seed};
+    auto dist           = std::uniform_int_distribution<int>{0, max_elem};
+
+    dvlab::utils::ordered_hashset<int> expected;
+    dvlab::utils::small_ordered_hashset<int, 4> actual;
+
+    for (int i = 0; i < 5000; ++i) {
+        auto const x = dist(rng);
+        if (rng() % 3 == 0) {
+            REQUIRE(actual.erase(x) == expected.erase(x));
+        } else {
+            REQUIRE(actual.insert(x).second == expected.insert(x).second);
+            REQUIRE(*actual.find(x) == x);
+        }
+        REQUIRE(actual.size() == expected.size());
+        REQUIRE(actual.contains(x) == expected.contains(x));
+        // spills past 4 elements and moves back inline at 2
+        if (actual.size() > 4) REQUIRE(actual.is_spilled());
+        if (actual.size() <= 2) REQUIRE_FALSE(actual.is_spilled());
+        // iteration follows insertion order in both containers
+        REQUIRE(std::vector<int>(actual.begin(), actual.end()) == std::vector<int>(expected.begin(), expected.end()));
+    }
+
+    auto const reversed = std::vector<int>(std::make_reverse_iterator(actual.end()), std::make_reverse_iterator(actual.begin()));
+    REQUIRE(reversed == std::vector<int>(std::make_reverse_iterator(expected.end()), std::make_reverse_iterator(expected.begin())));
+}
+
+TEST_CASE("small_ordered_hashset spills and shrinks back", "[small_ordered_hashset]") {
+    dvlab::utils::small_ordered_hashset<int, 4> set{1, 2, 3, 4};
+    REQUIRE_FALSE(set.is_spilled());
+    REQUIRE(set.find(5) == set.end());
+
+    REQUIRE(set.emplace(5).second);
+    REQUIRE(set.is_spilled());
+    REQUIRE(std::vector<int>(set.begin(), set.end()) == std::vector<int>{1, 2, 3, 4, 5});
+
+    auto copy = set;
+    REQUIRE(set.erase(2) == 1);
+    REQUIRE(set.erase(4) == 1);
+    REQUIRE(set.is_spilled());
+    REQUIRE(set.erase(1) == 1);
+    REQUIRE_FALSE(set.is_spilled());
+    REQUIRE(std::vector<int>(set.begin(), set.end()) == std::vector<int>{3, 5});
+
+    // copies are deep
+    REQUIRE(copy.size() == 5);
+    REQUIRE(copy.contains(2));
+
+    auto moved = std::move(copy);
+    REQUIRE(moved.size() == 5);
+    REQUIRE(copy.empty());  // NOLINT(bugprone-use-after-move, clang-analyzer-cplusplus.Move) : testing the moved-from state
+}
@@ -0,0 +1,59 @@
+#include <algorithm>
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include "util/thread_pool.hpp"
+
+using dvlab::utils::thread_pool;
+
+TEST_CASE("Thread pool runs every task once", "[util][thread_pool]") {
+    auto const n_threads = GENERATE(1u, 2u, 5u);
+    thread_pool pool{n_threads};
+    REQUIRE(pool.num_threads() == n_threads);
+
+    for (size_t n : {0, 1, 3, 100, 1000}) {
+        std::vector<std::atomic<size_t>> counts(n);
+        pool.parallel_for(n, [&](size_t i) { ++counts[i]; });
+        REQUIRE(std::ranges::all_of(counts, [](auto const& c) { return c == 1; }));
+    }
+
+    // the pool can be reused many times
+    std::atomic<size_t> sum = 0;
+    for (size_t round = 0; round < 200; ++round) {
+        pool.parallel_for(10, [&](size_t i) { sum += i; });
+    }
+    REQUIRE(sum == 200 * 45);
+}
+
+TEST_CASE("Thread pool rethrows exceptions from tasks", "[util][thread_pool]") {
+    auto const n_threads = GENERATE(1u, 4u);
+    thread_pool pool{n_threads};
+
+    std::atomic<size_t> finished = 0;
+    REQUIRE_THROWS_AS(
+        pool.parallel_for(50, [&](size_t i) {
+            if (i == 7) throw std::runtime_error("task failed");
+            ++finished;
+        }),
+        std::runtime_error);
+    if (n_threads > 1) REQUIRE(finished == 49);
+
+    // the pool is still usable afterwards
+    std::atomic<size_t> count = 0;
+    pool.parallel_for(20, [&](size_t) { ++count; });
+    REQUIRE(count == 20);
+}
+
+TEST_CASE("Thread pool runs nested loops inline", "[util][thread_pool]") {
+    thread_pool pool{3};
+
+    std::vector<std::atomic<size_t>> counts(8 * 8);
+    pool.parallel_for(8, [&](size_t i) {
+        pool.parallel_for(8, [&](size_t j) { ++counts[i * 8 + j]; });
+    });
+    REQUIRE(std::ranges::all_of(counts, [](auto const& c) { return c == 1; }));
+}
@@ -0,0 +1,111 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <tl/enumerate.hpp>
+#include <vector>
+
+#include "common/global.hpp"
+#include "zx/zxgraph.hpp"
+
+using namespace qsyn::zx;
+
+namespace {
+
+ZXVertex* random_element(ZXVertexList const& vertices) {
+    auto const idx = std::uniform_int_distribution<size_t>(0, vertices.size() - 1)(rand_gen());
+    return *std::next(vertices.begin(), static_cast<std::ptrdiff_t>(idx));
+}
+
+ZXVertexList shuffled(ZXVertexList const& vertices) {
+    auto const seq = get_shuffle_seq(std::vector<ZXVertex*>(vertices.begin(), vertices.end()));
+    return {seq.begin(), seq.end()};
+}
+
+}  // namespace
+
+TEST_CASE("Biadjacency cache follows vertex list changes", "[zx][biadjacency]") {
+    size_t const num_vertices = GENERATE(4, 16, 80);
+
+    ZXGraph g;
+    ZXVertexList rows, cols;
+    for (size_t i = 0; i < num_vertices; ++i) {
+        rows.emplace(g.add_vertex(VertexType::z));
+        cols.emplace(g.add_vertex(VertexType::z));
+    }
+    for (auto const& r : rows) {
+        for (auto const& c : cols) {
+            if (coin_flip(0.3)) g.add_edge(r, c, EdgeType::hadamard);
+        }
+    }
+
+    BiadjacencyCache cache;
+
+    for (size_t step = 0; step < 20; ++step) {
+        REQUIRE(cache.update(g, rows, cols).get_matrix() == get_biadjacency_matrix(g, rows, cols).get_matrix());
+
+        if (rows.size() > 1) {
+            auto const removed = random_element(rows);
+            rows.erase(removed);
+            g.remove_vertex(removed);
+        }
+        if (cols.size() > 1) {
+            auto const moved = random_element(cols);
+            cols.erase(moved);
+            rows.emplace(moved);
+        }
+        for (size_t i = 0; i < 2; ++i) {
+            auto const added = g.add_vertex(VertexType::z);
+            for (auto const& r : rows) {
+                if (coin_flip(0.3)) g.add_edge(r, added, EdgeType::hadamard);
+            }
+            cols.emplace(added);
+        }
+        rows = shuffled(rows);
+        cols = shuffled(cols);
+    }
+}
+
+TEST_CASE("Biadjacency cache takes assigned matrices", "[zx][biadjacency]") {
+    size_t const num_vertices = GENERATE(4, 16, 80);
+
+    ZXGraph g;
+    ZXVertexList rows, cols;
+    for (size_t i = 0; i < num_vertices; ++i) {
+        rows.emplace(g.add_vertex(VertexType::z));
+        cols.emplace(g.add_vertex(VertexType::z));
+    }
+
+    BiadjacencyCache cache;
+    auto matrix = cache.update(g, rows, cols);
+
+    for (size_t step = 0; step < 10; ++step) {
+        // writes a modified matrix back to the graph, as the extractor does
+        for (auto const& [i, r] : rows | tl::views::enumerate) {
+            for (auto const& [j, c] : cols | tl::views::enumerate) {
+                if (!coin_flip(0.2)) continue;
+                matrix[i][j] ^= 1;
+                if (matrix[i][j] == 1) {
+                    g.add_edge(r, c, EdgeType::hadamard);
+                } else {
+                    g.remove_edge(r, c);
+                }
+            }
+        }
+        cache.assign(matrix, rows, cols);
+
+        rows   = shuffled(rows);
+        cols   = shuffled(cols);
+        matrix = cache.update(g, rows, cols);
+        REQUIRE(matrix.get_matrix() == get_biadjacency_matrix(g, rows, cols).get_matrix());
+    }
+
+    // edges changed behind the cache's back are only seen after invalidation
+    auto const r = *rows.begin();
+    auto const c = *cols.begin();
+    if (g.is_neighbor(r, c)) {
+        g.remove_edge(r, c);
+    } else {
+        g.add_edge(r, c, EdgeType::hadamard);
+    }
+    cache.invalidate();
+    REQUIRE(cache.update(g, rows, cols).get_matrix() == get_biadjacency_matrix(g, rows, cols).get_matrix());
+}
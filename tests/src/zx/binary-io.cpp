@@ -0,0 +1,71 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "util/tmp_files.hpp"
+#include "zx/zx_io.hpp"
+#include "zx/zxgraph.hpp"
+
+using namespace qsyn::zx;
+
+TEST_CASE("Binary ZX files round-trip the benchmark graphs", "[zx][io]") {
+    auto const filename = GENERATE(
+        "cnot.zx", "cnots.zx", "identity-1.zx", "lcomp_1.zx",
+        "qft_6dec.zx", "qft_6fr.zx", "stcopy.zx", "stcopy_boundary.zx",
+        "swap.zx", "tof2_opt.zx", "tof3.zx", "tof3_op.zx",
+        "tof3_zh.zx", "tof_3.dr.zx");
+    CAPTURE(filename);
+
+    auto const graph = from_zx(std::filesystem::path{QSYN_SOURCE_DIR} / "benchmark/zx" / filename);
+    REQUIRE(graph.has_value());
+
+    dvlab::utils::TmpDir const tmp_dir;
+    auto const zxb_path = tmp_dir.path() / "graph.zxb";
+    REQUIRE(graph->write_zxb(zxb_path));
+
+    auto const read_back = from_zxb(zxb_path, true);
+    REQUIRE(read_back.has_value());
+    REQUIRE(*read_back == *graph);
+
+    auto const renumbered = from_zxb(zxb_path);
+    REQUIRE(renumbered.has_value());
+    REQUIRE(renumbered->num_vertices() == graph->num_vertices());
+    REQUIRE(renumbered->num_edges() == graph->num_edges());
+    REQUIRE(renumbered->num_inputs() == graph->num_inputs());
+    REQUIRE(renumbered->num_outputs() == graph->num_outputs());
+}
+
+TEST_CASE("Malformed binary ZX files are rejected", "[zx][io]") {
+    ZXGraph graph;
+    auto* i0 = graph.add_input(0);
+    auto* o0 = graph.add_output(0);
+    auto* v  = graph.add_vertex(VertexType::z, dvlab::Phase(1, 4));
+    graph.add_edge(i0, v, EdgeType::simple);
+    graph.add_edge(v, o0, EdgeType::hadamard);
+
+    dvlab::utils::TmpDir const tmp_dir;
+    auto const zxb_path = tmp_dir.path() / "graph.zxb";
+    REQUIRE(graph.write_zxb(zxb_path));
+    REQUIRE(from_zxb(zxb_path, true) == graph);
+
+    auto const size = std::filesystem::file_size(zxb_path);
+
+    SECTION("truncated file") {
+        std::filesystem::resize_file(zxb_path, size - 8);
+        REQUIRE_FALSE(from_zxb(zxb_path).has_value());
+    }
+
+    SECTION("wrong magic") {
+        std::fstream file{zxb_path, std::ios::in | std::ios::out | std::ios::binary};
+        file.write("NOTAZXB", 7);
+        file.close();
+        REQUIRE_FALSE(from_zxb(zxb_path).has_value());
+    }
+
+    SECTION("text file") {
+        std::ofstream{zxb_path} << "I0 (0, 0)\n";
+        REQUIRE_FALSE(from_zxb(zxb_path).has_value());
+    }
+}
@@ -0,0 +1,112 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "common/zx.hpp"
+#include "zx/simplifier/rules/zx_rules_template.hpp"
+#include "zx/simplifier/simplify.hpp"
+#include "zx/zxgraph.hpp"
+
+using namespace qsyn::zx;
+using dvlab::Phase;
+
+namespace {
+
+std::vector<size_t> ids_of(std::vector<ZXVertex*> const& vertices) {
+    std::vector<size_t> ids;
+    for (auto const& v : vertices) ids.emplace_back(v->get_id());
+    std::ranges::sort(ids);
+    return ids;
+}
+
+}  // namespace
+
+TEST_CASE("Change log records touched vertices", "[zx][change_log]") {
+    ZXGraph g;
+    for (size_t i = 0; i < 5; ++i) {
+        g.add_vertex(VertexType::z);
+    }
+    g.add_edge(0, 1, EdgeType::hadamard);
+    g.add_edge(1, 2, EdgeType::hadamard);
+
+    g.start_change_log();
+    REQUIRE(g.is_logging_changes());
+
+    auto const start = g.change_log_position();
+    g.add_edge(3, 4, EdgeType::hadamard);
+    REQUIRE(ids_of(g.get_changed_vertices(start)) == std::vector<size_t>{3, 4});
+
+    auto const middle = g.change_log_position();
+    g.remove_vertex(size_t{1});
+    g.add_edge(3, 4, EdgeType::hadamard);  // cancels out
+    REQUIRE(ids_of(g.get_changed_vertices(middle)) == std::vector<size_t>{0, 2, 3, 4});
+    // earlier positions see all changes since, without duplicates
+    REQUIRE(ids_of(g.get_changed_vertices(start)) == std::vector<size_t>{0, 2, 3, 4});
+
+    auto const end = g.change_log_position();
+    REQUIRE(g.get_changed_vertices(end).empty());
+    auto const v = g.add_vertex(VertexType::x);
+    g.remove_vertex(size_t{3});  // isolated; nothing else is touched
+    REQUIRE(g.get_changed_vertices(end) == std::vector<ZXVertex*>{v});
+
+    g.set_change_log_bookmark("rule", end);
+    REQUIRE(g.get_change_log_bookmark("rule") == end);
+    REQUIRE(g.get_change_log_bookmark("other") == std::nullopt);
+
+    g.stop_change_log();
+    REQUIRE(!g.is_logging_changes());
+    REQUIRE(g.get_change_log_bookmark("rule") == std::nullopt);
+    g.add_edge(0, 2, EdgeType::hadamard);
+    REQUIRE(g.get_changed_vertices(0).empty());
+}
+
+TEST_CASE("Matches do not depend on the order of candidates", "[zx][change_log]") {
+    size_t const num_neighbors = GENERATE(3, 5, 7);
+    auto const g               = generate_random_lcomp_graph(num_neighbors, Phase(1, 2));
+
+    auto const& vertices = g.get_vertices();
+    ZXVertexList reversed{std::make_reverse_iterator(vertices.end()), std::make_reverse_iterator(vertices.begin())};
+
+    LocalComplementRule const rule;
+    auto const expected = rule.find_matches(g);
+    auto const actual   = rule.find_matches(g, reversed);
+
+    REQUIRE(expected.size() == actual.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        REQUIRE(expected[i].get_v_id() == actual[i].get_v_id());
+    }
+}
+
+TEST_CASE("Incremental simplification reaches the same graph", "[zx][change_log]") {
+    size_t const num_neighbors = GENERATE(3, 5, 7);
+    auto const boundary        = GENERATE(false, true);
+
+    auto g = generate_random_lcomp_graph(num_neighbors, Phase(1, 2), boundary);
+    for (size_t i = 1; i <= num_neighbors; ++i) {
+        // chains of phase-free spiders so that the rules keep finding matches
+        auto const v = g.add_vertex(VertexType::z);
+        auto const w = g.add_vertex(VertexType::z, Phase(1));
+        g.add_edge(g[i], v, EdgeType::hadamard);
+        g.add_edge(v, w, EdgeType::hadamard);
+    }
+
+    auto expected = g;
+    for (bool changed = true; changed;) {
+        changed = false;
+        auto const apply_all = [&](auto const& rule) {
+            while (true) {
+                auto const matches = rule.find_matches(expected);
+                if (matches.empty()) break;
+                rule.apply(expected, matches);
+                changed = true;
+            }
+        };
+        apply_all(IdentityRemovalRule{});
+        apply_all(SpiderFusionRule{});
+        apply_all(PivotRule{});
+        apply_all(LocalComplementRule{});
+    }
+
+    simplify::interior_clifford_simp(g);
+    REQUIRE(!g.is_logging_changes());
+    REQUIRE(g == expected);
+}
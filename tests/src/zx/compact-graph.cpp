@@ -0,0 +1,150 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <utility>
+
+#include "common/global.hpp"
+#include "common/zx.hpp"
+#include "zx/simplifier/simplify.hpp"
+#include "zx/zxgraph.hpp"
+#include "zx/zxgraph_compact.hpp"
+
+using namespace qsyn::zx;
+using dvlab::Phase;
+
+TEST_CASE("Compact graph round trip", "[zx][compact]") {
+    size_t const num_neighbors = GENERATE(3, 5, 7);
+    auto const boundary        = GENERATE(false, true);
+
+    auto const g = generate_random_lcomp_graph(num_neighbors, get_random_phase(), boundary);
+
+    CompactZXGraph const cg{g};
+
+    REQUIRE(cg.num_vertices() == g.num_vertices());
+    REQUIRE(cg.num_edges() == g.num_edges());
+    REQUIRE(cg.num_inputs() == g.num_inputs());
+    REQUIRE(cg.to_zxgraph() == g);
+}
+
+TEST_CASE("Compact graph edges follow ZXGraph rules", "[zx][compact]") {
+    ZXGraph g;
+    CompactZXGraph cg;
+
+    for (size_t i = 0; i < 4; ++i) {
+        g.add_vertex(i % 2 ? VertexType::x : VertexType::z, Phase(1, 4));
+        cg.add_vertex(i % 2 ? VertexType::x : VertexType::z, Phase(1, 4));
+    }
+
+    auto const add_both = [&](size_t i, size_t j, EdgeType et) {
+        g.add_edge(i, j, et);
+        cg.add_edge(*cg.index_of(i), *cg.index_of(j), et);
+    };
+
+    add_both(0, 1, EdgeType::simple);
+    add_both(0, 1, EdgeType::hadamard);  // merged
+    add_both(1, 2, EdgeType::simple);
+    add_both(1, 2, EdgeType::simple);  // cancelled
+    add_both(0, 2, EdgeType::simple);
+    add_both(0, 2, EdgeType::hadamard);  // pi phase
+    add_both(3, 3, EdgeType::hadamard);  // self loop
+
+    REQUIRE(cg.num_edges() == g.num_edges());
+    REQUIRE(cg.to_zxgraph() == g);
+}
+
+TEST_CASE("Compact graph removal and compaction", "[zx][compact]") {
+    auto const g = generate_random_lcomp_graph(7, Phase(1, 2));
+
+    CompactZXGraph cg{g};
+    auto expected = g;
+
+    REQUIRE(cg.remove_vertex(*cg.index_of(0)) == 1);
+    expected.remove_vertex(size_t{0});
+    REQUIRE(cg.num_vertex_slots() == g.num_vertices());
+    REQUIRE(cg.to_zxgraph() == expected);
+
+    auto const remap = cg.compact();
+    REQUIRE(remap[0] == CompactZXGraph::invalid_index);
+    REQUIRE(cg.num_vertex_slots() == expected.num_vertices());
+    REQUIRE(cg.num_adjacency_slots() == 2 * expected.num_edges());
+    REQUIRE(cg.to_zxgraph() == expected);
+
+    for (size_t i = 1; i <= 7; ++i) {
+        for (size_t j = i + 1; j <= 7; ++j) {
+            cg.remove_edge(*cg.index_of(i), *cg.index_of(j));
+            expected.remove_edge(expected[i], expected[j]);
+        }
+    }
+    REQUIRE(cg.num_edges() == 0);
+    REQUIRE(cg.to_zxgraph() == expected);
+    REQUIRE(cg.remove_isolated_vertices() == 7);
+    REQUIRE(cg.num_vertices() == 0);
+}
+
+TEST_CASE("Compact graph round trip iterates like a copy", "[zx][compact]") {
+    auto const seed = GENERATE(1u, 2u, 3u);
+
+    auto g = generate_random_circuit_graph(5, 80, seed);
+    // leave gaps in the IDs, so that the next vertex ID has to be carried over
+    simplify::spider_fusion_simp(g);
+
+    auto const copied_graph = g;
+    auto const round_trip   = CompactZXGraph{g}.to_zxgraph();
+    REQUIRE(round_trip == copied_graph);
+    REQUIRE(get_iteration_order(round_trip) == get_iteration_order(copied_graph));
+}
+
+TEST_CASE("ZXGraph routines run on a compact graph", "[zx][compact]") {
+    auto const seed = GENERATE(4u, 5u);
+
+    auto const g  = generate_random_circuit_graph(6, 150, seed);
+    auto expected = g;
+    simplify::full_reduce(expected);
+
+    // the routine runs on a graph that iterates like `expected` did before
+    // the reduction, and the result comes back as a copy of what it left
+    auto cg = CompactZXGraph{g};
+    with_zxgraph(cg, simplify::full_reduce);
+    REQUIRE(cg.num_vertices() == expected.num_vertices());
+    REQUIRE(cg.to_zxgraph() == expected);
+    REQUIRE(get_iteration_order(cg.to_zxgraph()) == get_iteration_order(ZXGraph{expected}));
+
+    auto const t_count = with_zxgraph(std::as_const(cg), [](ZXGraph const& graph) { return qsyn::zx::t_count(graph); });
+    REQUIRE(t_count == qsyn::zx::t_count(expected));
+}
+
+TEST_CASE("Compact graph copies share storage until written", "[zx][compact]") {
+    auto const g = generate_random_lcomp_graph(5, Phase(1, 4));
+
+    CompactZXGraph const original{g};
+    auto snapshot = original;
+
+    REQUIRE(snapshot.shares_vertex_table_with(original));
+    REQUIRE(snapshot.shares_adjacency_table_with(original));
+
+    // changing an attribute only detaches the vertex table
+    snapshot.set_phase(*snapshot.index_of(0), Phase(1, 2));
+    REQUIRE_FALSE(snapshot.shares_vertex_table_with(original));
+    REQUIRE(snapshot.shares_adjacency_table_with(original));
+    REQUIRE(original.get_phase(*original.index_of(0)) == Phase(1, 4));
+
+    // changing an edge detaches the adjacency table
+    auto speculative = original;
+    REQUIRE(speculative.remove_edge(*speculative.index_of(0), *speculative.index_of(1)) == 1);
+    REQUIRE_FALSE(speculative.shares_adjacency_table_with(original));
+    REQUIRE(speculative.shares_vertex_table_with(original));
+    REQUIRE(original.is_neighbor(*original.index_of(0), *original.index_of(1)));
+
+    // a no-op removal does not detach anything
+    auto untouched = original;
+    REQUIRE(untouched.remove_edge(*untouched.index_of(0), *untouched.index_of(0)) == 0);
+    REQUIRE(untouched.shares_adjacency_table_with(original));
+
+    REQUIRE(original.to_zxgraph() == g);
+
+    auto expected = g;
+    expected.remove_vertex(size_t{0});
+    auto removed = original;
+    removed.remove_vertex(*removed.index_of(0));
+    REQUIRE(removed.to_zxgraph() == expected);
+    REQUIRE(original.to_zxgraph() == g);
+}
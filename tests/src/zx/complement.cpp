@@ -0,0 +1,129 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <numeric>
+#include <tl/zip.hpp>
+
+#include "common/zx.hpp"
+#include "zx/zx_def.hpp"
+#include "zx/zxgraph.hpp"
+
+using namespace qsyn::zx;
+using dvlab::Phase;
+
+namespace {
+
+std::vector<ZXVertex*> vertices_by_id(ZXGraph const& graph, std::vector<size_t> const& ids) {
+    std::vector<ZXVertex*> vertices;
+    for (auto id : ids) vertices.push_back(graph[id]);
+    return vertices;
+}
+
+// operator== ignores the order of the neighbors, which the rewrite rules
+// downstream do observe
+bool same_neighbor_order(ZXGraph const& lhs, ZXGraph const& rhs) {
+    for (auto* v : lhs.get_vertices()) {
+        auto const& lhs_nbrs = lhs.get_neighbors(v);
+        auto const& rhs_nbrs = rhs.get_neighbors(rhs[v->get_id()]);
+        if (lhs_nbrs.size() != rhs_nbrs.size()) return false;
+        for (auto const& [l, r] : tl::views::zip(lhs_nbrs, rhs_nbrs)) {
+            if (l.first->get_id() != r.first->get_id() || l.second != r.second) return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+TEST_CASE("Complementing a group matches adding the edges one by one", "[zx][graph]") {
+    size_t const num_neighbors = GENERATE(3, 8, 20, 70);
+
+    auto const g_before = generate_random_lcomp_graph(num_neighbors, Phase(1, 2));
+
+    std::vector<size_t> ids(num_neighbors);
+    std::iota(ids.begin(), ids.end(), 1);
+
+    auto expected = g_before;
+    for (size_t i = 0; i < ids.size(); ++i) {
+        for (size_t j = i + 1; j < ids.size(); ++j) {
+            expected.add_edge(ids[i], ids[j], EdgeType::hadamard);
+        }
+    }
+
+    auto g = g_before;
+    g.complement_hadamard_edges(vertices_by_id(g, ids));
+
+    REQUIRE(g == expected);
+    REQUIRE(same_neighbor_order(g, expected));
+
+    // complementing twice restores the graph
+    g.complement_hadamard_edges(vertices_by_id(g, ids));
+    REQUIRE(g == g_before);
+}
+
+TEST_CASE("Complementing across two groups matches adding the edges one by one", "[zx][graph]") {
+    size_t const num_neighbors = GENERATE(4, 12, 40);
+
+    auto const g_before = generate_random_lcomp_graph(num_neighbors, Phase(1, 2));
+
+    std::vector<size_t> lhs_ids, rhs_ids;
+    for (size_t i = 1; i <= num_neighbors; ++i) {
+        (i % 3 == 0 ? lhs_ids : rhs_ids).push_back(i);
+    }
+
+    auto expected = g_before;
+    for (auto i : lhs_ids) {
+        for (auto j : rhs_ids) {
+            expected.add_edge(i, j, EdgeType::hadamard);
+        }
+    }
+
+    auto g = g_before;
+    g.complement_hadamard_edges(vertices_by_id(g, lhs_ids), vertices_by_id(g, rhs_ids));
+
+    REQUIRE(g == expected);
+    REQUIRE(same_neighbor_order(g, expected));
+}
+
+TEST_CASE("Complementing groups that add_edge treats specially", "[zx][graph]") {
+    auto g_before = generate_random_lcomp_graph(10, Phase(1, 2));
+
+    SECTION("simple edges within the group") {
+        g_before.remove_edge(1, 2, EdgeType::hadamard);
+        g_before.add_edge(1, 2, EdgeType::simple);
+    }
+
+    SECTION("X-spiders in the group") {
+        g_before.set_vertex_type(g_before[3], VertexType::x);
+    }
+
+    std::vector<size_t> ids(10);
+    std::iota(ids.begin(), ids.end(), 1);
+
+    auto expected = g_before;
+    for (size_t i = 0; i < ids.size(); ++i) {
+        for (size_t j = i + 1; j < ids.size(); ++j) {
+            expected.add_edge(ids[i], ids[j], EdgeType::hadamard);
+        }
+    }
+
+    auto g = g_before;
+    g.complement_hadamard_edges(vertices_by_id(g, ids));
+
+    REQUIRE(g == expected);
+    REQUIRE(same_neighbor_order(g, expected));
+}
+
+TEST_CASE("Rolling back a complemented group restores it", "[zx][graph]") {
+    auto const g_before = generate_random_lcomp_graph(70, Phase(1, 2));
+
+    std::vector<size_t> ids(70);
+    std::iota(ids.begin(), ids.end(), 1);
+
+    auto g = g_before;
+    g.begin_transaction();
+    g.complement_hadamard_edges(vertices_by_id(g, ids));
+    REQUIRE(g != g_before);
+    g.rollback_transaction();
+
+    REQUIRE(g == g_before);
+}
@@ -0,0 +1,26 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "common/zx.hpp"
+#include "zx/simplifier/simplify.hpp"
+#include "zx/zxgraph.hpp"
+
+using namespace qsyn::zx;
+
+TEST_CASE("Dynamic reduce matches reducing a copy for the T-optimal", "[zx][simplify]") {
+    auto const seed = GENERATE(1u, 2u, 3u, 4u, 5u, 6u);
+
+    auto g = generate_random_circuit_graph(6, 150, seed);
+
+    // the original strategy: the T-optimal comes from a fully reduced copy
+    auto expected = g;
+    simplify::hadamard_rule_simp(expected);
+    auto copied_graph = expected;
+    simplify::full_reduce(copied_graph);
+    simplify::dynamic_reduce(expected, t_count(copied_graph));
+
+    simplify::dynamic_reduce(g);
+    REQUIRE(g == expected);
+    // the rules visit the same matches only if the graphs iterate alike
+    REQUIRE(get_iteration_order(g) == get_iteration_order(expected));
+}
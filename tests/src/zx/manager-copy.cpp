@@ -0,0 +1,24 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "cmd/zxgraph_mgr.hpp"
+#include "common/zx.hpp"
+#include "zx/zxgraph.hpp"
+
+using namespace qsyn::zx;
+
+TEST_CASE("Copies in the manager are independent once written", "[zx][manager]") {
+    auto mgr = ZXGraphMgr{"ZXGraph"};
+    mgr.add(0, std::make_unique<ZXGraph>(generate_random_circuit_graph(4, 40, 1)));
+    auto const original = *mgr.get();
+
+    mgr.copy(1);
+    REQUIRE(mgr.focused_id() == 1);
+
+    auto* copy = mgr.get();
+    REQUIRE(*copy == original);
+    copy->remove_vertex(*copy->get_vertices().begin());
+
+    REQUIRE(*mgr.find_by_id(0) == original);
+    REQUIRE(*mgr.find_by_id(1) != original);
+    REQUIRE(mgr.find_by_id(0) != mgr.find_by_id(1));
+}
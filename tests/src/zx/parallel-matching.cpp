@@ -0,0 +1,81 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <random>
+#include <utility>
+
+#include "zx/simplifier/rules/zx_rules_template.hpp"
+#include "zx/simplifier/simplify.hpp"
+#include "zx/zxgraph.hpp"
+
+using namespace qsyn::zx;
+using dvlab::Phase;
+
+namespace {
+
+// large enough that the vertices are split into several shards
+ZXGraph generate_random_sparse_graph(size_t num_vertices, unsigned seed) {
+    std::mt19937 gen{seed};
+    std::uniform_int_distribution<size_t> vertex_dist(0, num_vertices - 1);
+    std::uniform_int_distribution<int> phase_dist(0, 7);
+    std::bernoulli_distribution x_dist(0.2);
+    std::bernoulli_distribution hadamard_dist(0.7);
+
+    ZXGraph g;
+    for (size_t i = 0; i < num_vertices; ++i) {
+        g.add_vertex(x_dist(gen) ? VertexType::x : VertexType::z, Phase(phase_dist(gen), 4));
+    }
+    for (size_t i = 0; i < num_vertices * 2; ++i) {
+        auto const s = vertex_dist(gen);
+        auto const t = vertex_dist(gen);
+        if (s == t) continue;
+        g.add_edge(s, t, hadamard_dist(gen) ? EdgeType::hadamard : EdgeType::simple);
+    }
+    return g;
+}
+
+// apply the matches found with `n_threads` threads to a copy of the graph
+template <typename Rule>
+std::pair<size_t, ZXGraph> apply_matches(Rule const& rule, ZXGraph const& g, size_t n_threads) {
+    set_num_match_threads(n_threads);
+    auto copy          = g;
+    auto const matches = rule.find_matches(copy);
+    rule.apply(copy, matches);
+    set_num_match_threads(1);
+    return {matches.size(), std::move(copy)};
+}
+
+}  // namespace
+
+TEST_CASE("Parallel matching finds the same matches", "[zx][parallel]") {
+    auto const seed      = GENERATE(1u, 2u, 3u);
+    auto const n_threads = GENERATE(2u, 4u, 7u);
+
+    auto const g    = generate_random_sparse_graph(6000, seed);
+    auto graph_like = g;
+    simplify::to_graph_like(graph_like);
+
+    REQUIRE(apply_matches(LocalComplementRule{}, graph_like, 1).first > 0);
+    REQUIRE(apply_matches(PivotRule{}, graph_like, 1).first > 0);
+
+    REQUIRE(apply_matches(SpiderFusionRule{}, g, n_threads) == apply_matches(SpiderFusionRule{}, g, 1));
+    REQUIRE(apply_matches(IdentityRemovalRule{}, graph_like, n_threads) == apply_matches(IdentityRemovalRule{}, graph_like, 1));
+    REQUIRE(apply_matches(LocalComplementRule{}, graph_like, n_threads) == apply_matches(LocalComplementRule{}, graph_like, 1));
+    REQUIRE(apply_matches(PivotRule{}, graph_like, n_threads) == apply_matches(PivotRule{}, graph_like, 1));
+    REQUIRE(apply_matches(PivotGadgetRule{}, graph_like, n_threads) == apply_matches(PivotGadgetRule{}, graph_like, 1));
+    REQUIRE(apply_matches(PhaseGadgetRule{}, graph_like, n_threads) == apply_matches(PhaseGadgetRule{}, graph_like, 1));
+}
+
+TEST_CASE("Parallel full reduction reaches the same graph", "[zx][parallel]") {
+    auto const g = generate_random_sparse_graph(3000, 42);
+
+    set_num_match_threads(1);
+    auto expected = g;
+    simplify::full_reduce(expected);
+
+    set_num_match_threads(4);
+    auto actual = g;
+    simplify::full_reduce(actual);
+    set_num_match_threads(1);
+
+    REQUIRE(actual == expected);
+}
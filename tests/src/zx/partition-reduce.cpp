@@ -0,0 +1,27 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "common/zx.hpp"
+#include "zx/simplifier/simplify.hpp"
+#include "zx/zxgraph.hpp"
+
+using namespace qsyn::zx;
+using dvlab::Phase;
+
+TEST_CASE("Concurrent partition reduce matches the sequential one", "[zx][partition]") {
+    auto const seed         = GENERATE(1u, 2u);
+    auto const n_partitions = GENERATE(2u, 4u);
+
+    auto const g = generate_random_circuit_graph(8, 200, seed);
+
+    auto expected = g;
+    simplify::partition_reduce(expected, n_partitions, 1);
+
+    auto actual = g;
+    simplify::partition_reduce(actual, n_partitions, 4);
+
+    REQUIRE(actual == expected);
+    REQUIRE(actual.num_vertices() < g.num_vertices());
+    // the subgraph pools are merged back into one
+    REQUIRE(actual.get_vertex_pool_statistics().num_live == actual.num_vertices());
+}
@@ -0,0 +1,125 @@
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <nlohmann/json.hpp>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "common/zx.hpp"
+#include "zx/simplifier/simplify.hpp"
+#include "zx/simplifier/trace.hpp"
+#include "zx/zxgraph.hpp"
+
+using namespace qsyn::zx;
+
+namespace {
+
+std::vector<nlohmann::json> parse_lines(std::string const& text) {
+    std::vector<nlohmann::json> records;
+    std::istringstream iss{text};
+    for (std::string line; std::getline(iss, line);) {
+        records.push_back(nlohmann::json::parse(line));
+    }
+    return records;
+}
+
+}  // namespace
+
+TEST_CASE("Simplification trace records rules and routines", "[zx][simplify]") {
+    auto graph       = generate_random_circuit_graph(5, 30, 7);
+    auto const stats = simplify::GraphStatistics::of(graph);
+
+    std::ostringstream oss;
+    simplify::SimplificationTrace trace{oss};
+    simplify::set_simplification_trace(&trace);
+    simplify::full_reduce(graph);
+    simplify::set_simplification_trace(nullptr);
+
+    auto const records = parse_lines(oss.str());
+    REQUIRE(!records.empty());
+
+    // the outermost routine is written last
+    auto const& last = records.back();
+    REQUIRE(last["kind"] == "routine");
+    REQUIRE(last["name"] == "full_reduce");
+    REQUIRE(last["depth"] == 0);
+    REQUIRE(last["vertices"] == graph.num_vertices());
+    REQUIRE(last["vertices_delta"] == static_cast<long long>(graph.num_vertices()) - static_cast<long long>(stats.num_vertices));
+    REQUIRE(last["t_count"] == t_count(graph));
+
+    // the iterations of each rule call add up to the call
+    size_t iteration_matches = 0;
+    size_t num_iterations    = 0;
+    for (auto const& record : records) {
+        REQUIRE(record.contains("time_ms") != (record["kind"] == "iteration"));
+        if (record["kind"] == "iteration") {
+            REQUIRE(record["depth"].get<size_t>() > 0);
+            iteration_matches += record["matches"].get<size_t>();
+            num_iterations++;
+        } else if (record["kind"] == "rule") {
+            REQUIRE(record["iterations"] == num_iterations);
+            REQUIRE(record["matches"] == iteration_matches);
+            REQUIRE(record["match_ms"].get<double>() + record["apply_ms"].get<double>() <= record["time_ms"].get<double>() + 1e-6);
+            iteration_matches = 0;
+            num_iterations    = 0;
+        }
+    }
+
+    REQUIRE(std::ranges::any_of(records, [](auto const& r) { return r["name"] == "interior_clifford_simp"; }));
+    REQUIRE(std::ranges::any_of(records, [](auto const& r) { return r["name"] == "clifford_simp"; }));
+    REQUIRE(std::ranges::any_of(records, [](auto const& r) { return r["name"] == "Spider Fusion Rule"; }));
+}
+
+TEST_CASE("Simplification without a trace writes nothing", "[zx][simplify]") {
+    auto graph = generate_random_circuit_graph(3, 10, 1);
+    REQUIRE(simplify::get_simplification_trace() == nullptr);
+    simplify::full_reduce(graph);
+    REQUIRE(simplify::get_simplification_trace() == nullptr);
+}
+
+TEST_CASE("Records of concurrent partitions carry their partition", "[zx][simplify]") {
+    auto graph = generate_random_circuit_graph(6, 60, 3);
+
+    std::ostringstream oss;
+    simplify::SimplificationTrace trace{oss};
+    simplify::set_simplification_trace(&trace);
+    simplify::partition_reduce(graph, 2, 2);
+    simplify::set_simplification_trace(nullptr);
+
+    auto const records = parse_lines(oss.str());
+    REQUIRE(!records.empty());
+    REQUIRE(records.back()["name"] == "partition_reduce");
+    REQUIRE(!records.back().contains("partition"));
+
+    std::vector<size_t> partitions;
+    for (auto const& record : records) {
+        if (record["name"] != "dynamic_reduce") continue;
+        REQUIRE(record.contains("partition"));
+        // the partitions run on pool threads but still nest under the routine
+        REQUIRE(record["depth"] == 1);
+        partitions.push_back(record["partition"].get<size_t>());
+    }
+    std::ranges::sort(partitions);
+    REQUIRE(partitions == std::vector<size_t>{0, 1});
+}
+
+TEST_CASE("Scopes on different graphs do not share a depth", "[zx][simplify]") {
+    auto graph = generate_random_circuit_graph(4, 20, 5);
+    auto other = generate_random_circuit_graph(4, 20, 6);
+
+    std::ostringstream oss;
+    simplify::SimplificationTrace trace{oss};
+    simplify::set_simplification_trace(&trace);
+    {
+        simplify::TracedScope const outer{graph, "routine", "outer"};
+        simplify::full_reduce(other);
+    }
+    simplify::set_simplification_trace(nullptr);
+
+    auto const records = parse_lines(oss.str());
+    REQUIRE(records.size() >= 2);
+    REQUIRE(records.back()["name"] == "outer");
+    REQUIRE(records.back()["depth"] == 0);
+    REQUIRE(records[records.size() - 2]["name"] == "full_reduce");
+    REQUIRE(records[records.size() - 2]["depth"] == 0);
+}
@@ -0,0 +1,99 @@
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "common/zx.hpp"
+#include "zx/simplifier/simplify.hpp"
+#include "zx/zx_partition.hpp"
+#include "zx/zxgraph.hpp"
+#include "zx/zxgraph_action.hpp"
+
+using namespace qsyn::zx;
+using dvlab::Phase;
+
+TEST_CASE("Rollback restores the graph", "[zx][transaction]") {
+    auto const seed = GENERATE(1u, 2u, 3u);
+
+    auto g              = generate_random_circuit_graph(6, 120, seed);
+    auto const original = g;
+    auto const pointers = g.create_id_to_vertex_map();
+
+    g.begin_transaction();
+    REQUIRE(g.in_transaction());
+    simplify::full_reduce(g);
+    REQUIRE(g != original);
+    REQUIRE(g.transaction_size() > 0);
+    g.rollback_transaction();
+
+    REQUIRE(!g.in_transaction());
+    REQUIRE(g == original);
+    // vertices removed during the transaction are the same objects again
+    REQUIRE(g.create_id_to_vertex_map() == pointers);
+
+    // the graph stays usable after the rollback
+    auto expected = original;
+    simplify::full_reduce(expected);
+    simplify::full_reduce(g);
+    REQUIRE(t_count(g) == t_count(expected));
+}
+
+TEST_CASE("Commit keeps the changes", "[zx][transaction]") {
+    auto g = generate_random_circuit_graph(6, 120, 4);
+
+    auto expected = g;
+    simplify::full_reduce(expected);
+
+    g.begin_transaction();
+    simplify::full_reduce(g);
+    g.commit_transaction();
+
+    REQUIRE(g == expected);
+    REQUIRE(g.transaction_size() == 0);
+    REQUIRE(g.get_vertex_pool_statistics().num_live == g.num_vertices());
+}
+
+TEST_CASE("Rollback undoes vertices, edges and phases", "[zx][transaction]") {
+    auto g              = generate_random_lcomp_graph(5, Phase(1, 2));
+    auto const original = g;
+
+    g.begin_transaction();
+    REQUIRE_THROWS_AS(g.begin_transaction(), std::logic_error);
+
+    REQUIRE(LComp{0}.apply(g));
+    auto const v = g.add_vertex(VertexType::x, Phase(1, 4));
+    g.add_edge(v, g[1], EdgeType::simple);
+    g.add_edge(g[1], g[1], EdgeType::hadamard);
+    g.remove_vertex(g[2]);
+    g.set_vertex_type(g[3], VertexType::x);
+    REQUIRE(g.num_vertices() == original.num_vertices() - 1);
+
+    g.rollback_transaction();
+    REQUIRE(g == original);
+    REQUIRE(g.get_vertex_pool_statistics().num_live == g.num_vertices());
+
+    REQUIRE_THROWS_AS(g.rollback_transaction(), std::logic_error);
+    REQUIRE_THROWS_AS(g.commit_transaction(), std::logic_error);
+}
+
+TEST_CASE("Rollback restores phases after a partition round trip", "[zx][transaction]") {
+    auto g = generate_random_circuit_graph(6, 60, 7);
+    auto v = *std::ranges::find_if(g.get_vertices(), [](ZXVertex* v) { return !v->is_boundary(); });
+    g.set_phase(v, Phase(1, 4));
+
+    // stamp the vertex with this graph's transaction
+    g.begin_transaction();
+    g.set_phase(v, Phase(1, 2));
+    g.rollback_transaction();
+    REQUIRE(v->phase() == Phase(1, 4));
+
+    // the merged graph adopts the vertex, stamp and all
+    auto const partitions        = kl_partition(g, 2);
+    auto const [subgraphs, cuts] = ZXGraph::create_subgraphs(std::move(g), partitions);
+    auto merged                  = ZXGraph::from_subgraphs(subgraphs, cuts);
+    REQUIRE(merged.get_vertices().contains(v));
+
+    merged.begin_transaction();
+    merged.set_phase(v, Phase(1));
+    merged.rollback_transaction();
+    REQUIRE(v->phase() == Phase(1, 4));
+}
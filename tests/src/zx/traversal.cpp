@@ -0,0 +1,65 @@
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/zx.hpp"
+#include "zx/zx_def.hpp"
+#include "zx/zxgraph.hpp"
+
+using namespace qsyn::zx;
+
+namespace {
+
+bool contains(std::vector<ZXVertex*> const& order, ZXVertex* v) {
+    return std::ranges::find(order, v) != order.end();
+}
+
+}  // namespace
+
+TEST_CASE("Topological order follows graph mutations", "[zx][traverse]") {
+    auto graph = generate_random_circuit_graph(4, 20, 3);
+
+    auto const order = graph.create_topological_order();
+    REQUIRE(order.size() == graph.num_vertices());
+    REQUIRE(graph.get_topological_order() == order);
+
+    auto* i0 = graph.get_input_by_qubit(0);
+    auto [nb, etype] = graph.get_first_neighbor(i0);
+
+    // insert a spider on the first wire
+    auto* v = graph.add_vertex(VertexType::z);
+    REQUIRE(!contains(graph.get_topological_order(), v));
+    graph.remove_edge(i0, nb, etype);
+    graph.add_edge(i0, v, EdgeType::simple);
+    graph.add_edge(v, nb, etype);
+    REQUIRE(contains(graph.get_topological_order(), v));
+    REQUIRE(graph.get_topological_order().size() == graph.num_vertices());
+
+    graph.remove_vertex(v);
+    graph.add_edge(i0, nb, etype);
+    REQUIRE(graph.get_topological_order() == order);
+
+    // the copy computes its own order over its own vertices
+    auto const copy = graph;
+    for (auto* u : copy.get_topological_order()) {
+        REQUIRE(copy.get_vertices().contains(u));
+    }
+    REQUIRE(copy.get_topological_order().size() == order.size());
+}
+
+TEST_CASE("Topological order handles deep graphs", "[zx][traverse]") {
+    constexpr size_t depth = 200'000;
+
+    ZXGraph graph;
+    auto* prev = graph.add_input(0);
+    for (size_t i = 0; i < depth; ++i) {
+        auto* v = graph.add_vertex(VertexType::z);
+        graph.add_edge(prev, v, EdgeType::hadamard);
+        prev = v;
+    }
+    graph.add_edge(prev, graph.add_output(0), EdgeType::hadamard);
+
+    auto const& order = graph.get_topological_order();
+    REQUIRE(order.size() == depth + 2);
+    REQUIRE(order.front() == graph.get_input_by_qubit(0));
+    REQUIRE(order.back() == graph.get_output_by_qubit(0));
+}
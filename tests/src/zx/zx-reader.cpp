@@ -0,0 +1,77 @@
+#include <catch2/catch_test_macros.hpp>
+#include <sstream>
+
+#include "common/zx.hpp"
+#include "util/phase.hpp"
+#include "util/tmp_files.hpp"
+#include "zx/zx_io.hpp"
+#include "zx/zxgraph.hpp"
+
+using namespace qsyn::zx;
+using dvlab::Phase;
+
+TEST_CASE("Reading .zx resolves forward references", "[zx][io]") {
+    std::istringstream zx_file{
+        "// edges declared before their endpoints\n"
+        "I0 (0, 0) S2\n"
+        "O1 (0, 2) H2\n"
+        "Z2 (0, 1) S0 pi/2  // listed from both sides\n"};
+
+    auto const graph = from_zx(zx_file, true);
+    REQUIRE(graph.has_value());
+    REQUIRE(graph->num_vertices() == 3);
+    REQUIRE(graph->num_edges() == 2);
+
+    auto* v = graph->vertex(2);
+    REQUIRE(v != nullptr);
+    REQUIRE(v->phase() == Phase(1, 2));
+    REQUIRE(graph->is_neighbor(v, graph->vertex(0), EdgeType::simple));
+    REQUIRE(graph->is_neighbor(v, graph->vertex(1), EdgeType::hadamard));
+}
+
+TEST_CASE("Reading .zx adds edges past an unresolved reference", "[zx][io]") {
+    // the edge to Z9 stays pending until the end, and the edges after it are
+    // added without waiting for it
+    std::istringstream zx_file{
+        "I0 (0, 0) S9\n"
+        "Z1 (0, 1) H0 H2\n"
+        "Z2 (0, 2) H3\n"
+        "Z3 (0, 3)\n"
+        "O4 (0, 4) S3\n"
+        "Z9 (1, 1)\n"};
+
+    auto const graph = from_zx(zx_file, true);
+    REQUIRE(graph.has_value());
+    REQUIRE(graph->num_edges() == 5);
+    REQUIRE(graph->is_neighbor(graph->vertex(0), graph->vertex(9), EdgeType::simple));
+    REQUIRE(graph->is_neighbor(graph->vertex(1), graph->vertex(2), EdgeType::hadamard));
+    REQUIRE(graph->is_neighbor(graph->vertex(2), graph->vertex(3), EdgeType::hadamard));
+}
+
+TEST_CASE("Reading .zx rejects undeclared neighbors", "[zx][io]") {
+    std::istringstream zx_file{
+        "I0 (0, 0) S1\n"
+        "Z1 (0, 1) S5\n"};
+
+    REQUIRE_FALSE(from_zx(zx_file).has_value());
+}
+
+TEST_CASE("Reading .zx rejects duplicated output qubits", "[zx][io]") {
+    std::istringstream zx_file{
+        "O0 (0, 0) 0\n"
+        "O1 (0, 0) 0\n"};
+
+    REQUIRE_FALSE(from_zx(zx_file).has_value());
+}
+
+TEST_CASE("Written .zx files read back to the same graph", "[zx][io]") {
+    auto const graph = generate_random_circuit_graph(5, 30, 42);
+
+    dvlab::utils::TmpDir const tmp_dir;
+    auto const zx_path = tmp_dir.path() / "graph.zx";
+    REQUIRE(graph.write_zx(zx_path));
+
+    auto const read_back = from_zx(zx_path, true);
+    REQUIRE(read_back.has_value());
+    REQUIRE(*read_back == graph);
+}